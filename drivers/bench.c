@@ -0,0 +1,897 @@
+#include <getopt.h>
+#include <omp.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../src/deltastep.h"
+#include "../src/dial.h"
+#include "../src/dijkstra.h"
+#include "../src/floyd.h"
+#include "../src/pdijkstra.h"
+#include "../src/pipeline.h"
+#include "../src/prnggraph.h"
+#include "../src/reorder.h"
+
+#define MAX_LIST (64)
+
+/*
+ * The engines the benchmark can run.
+ */
+enum engine {
+    ENGINE_DIJKSTRA,
+    ENGINE_PDIJKSTRA,
+    ENGINE_PERSISTENT,
+    ENGINE_DELTA,
+    ENGINE_DIAL,
+    ENGINE_FLOYD,
+    NENGINES,
+};
+
+static char const*const engine_names[NENGINES] = {
+    [ENGINE_DIJKSTRA] = "dijkstra",
+    [ENGINE_PDIJKSTRA] = "pdijkstra",
+    [ENGINE_PERSISTENT] = "persistent",
+    [ENGINE_DELTA] = "delta",
+    [ENGINE_DIAL] = "dial",
+    [ENGINE_FLOYD] = "floyd",
+};
+
+/*
+ * What to run, from the command line.
+ */
+struct options {
+    int engines[MAX_LIST];
+    int nengines;
+    double threads[MAX_LIST];
+    int nthreads;
+    double sizes[MAX_LIST];
+    int nsizes;
+    double bs[MAX_LIST];
+    int nbs;
+    double seeds[MAX_LIST];
+    int nseeds;
+    unsigned int max_weight;
+    unsigned int source;
+    int reps;
+    int warmup;
+    int delta;
+    unsigned int partitions;
+    double instances[MAX_LIST];
+    int ninstances;
+    unsigned int graphs;
+    enum matrix_pages pages;
+    enum reorder_kind reorder_kind;
+    bool reorder;
+    char const*bind;
+    bool implicit;
+    bool json;
+    bool validate;
+};
+
+/*
+ * One graph, in whichever forms the engines need.
+ */
+struct graph {
+    struct matrix *matrix;
+    struct csr_graph *csr;
+    int *distances;
+    /** With `--reorder`, how the vertices were renumbered, and
+     *  room for the paths mapped back to the original ids. */
+    struct reorder *reorder;
+    int *original_paths;
+    /** The source, renumbered. */
+    unsigned int source;
+    /** For Floyd-Warshall, an `int` copy of the matrix and room
+     *  for its distances and successors between every pair. */
+    int *ints;
+    int *all_distances;
+    int *next;
+};
+
+/*
+ * The timings of one engine and thread count on one graph.
+ */
+struct result {
+    double wall_median;
+    double wall_p95;
+    double wall_min;
+    double cpu_median;
+    double cpu_p95;
+    char const*valid;
+    /** Totals over the timed runs, when built with stats. */
+    struct engine_stats stats;
+};
+
+static void usage(char const*);
+static bool parse_options(int, char**, struct options*);
+static void bind_threads(char const*, char**);
+static int parse_list(char const*, double*);
+static bool prepare_graph(struct options const*, unsigned int, float,
+        unsigned int, struct graph*);
+static void release_graph(struct graph*);
+static struct result run_engine(struct options const*, struct graph*,
+        struct workspace*, int*, int, int);
+static void run_once(struct options const*, struct graph*,
+        struct workspace*, int*, int);
+static void floyd_paths(struct graph const*, int*);
+static bool valid_paths(struct graph const*, unsigned int, int const*);
+static double percentile(double*, int, double);
+static int compare_doubles(void const*, void const*);
+static void print_result(struct options const*, int, unsigned int, float,
+        unsigned int, int, struct result const*, bool);
+static void print_stats(struct options const*, struct result const*);
+static void run_pipelines(struct options const*);
+static int *reference_paths(struct options const*, unsigned int, float,
+        unsigned int const*, unsigned int);
+static void check_paths(unsigned int, int const*, void*);
+static void print_pipeline(struct options const*, unsigned int, float, int,
+        int, struct pipeline_report const*, double, char const*, bool);
+
+/*
+ * What `check_paths` checks a pipeline's paths against.
+ */
+struct check {
+    unsigned int size;
+    int const*want;
+    bool valid;
+};
+
+/*
+ * Times the engines over sweeps of thread counts, graph sizes,
+ * branching factors and seeds, reporting the median and 95th
+ * percentile wall and CPU times of each combination as CSV or
+ * JSON, and optionally checking each result against `dijkstra`.
+ */
+int
+main(int argc, char **argv)
+{
+    struct options opts;
+    if (!parse_options(argc, argv, &opts)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (opts.bind != NULL) bind_threads(opts.bind, argv);
+    matrix_use_pages(opts.pages);
+    if (opts.ninstances > 0) {
+        run_pipelines(&opts);
+        return 0;
+    }
+
+    if (!opts.json)
+        printf("engine,size,b,max_weight,seed,threads,reps,"
+               "wall_median_s,wall_p95_s,wall_min_s,"
+               "cpu_median_s,cpu_p95_s,valid%s\n",
+               (STATS_ENABLED) ? ",prepare_s,sweep_s,sync_s,imbalance_s,"
+               "iterations,edges_scanned,improvements,exit_iteration" : "");
+    else
+        printf("[");
+
+    bool first = true;
+    for (int s = 0; s < opts.nsizes; s += 1) {
+        const unsigned int size = opts.sizes[s];
+        if (opts.source >= size) {
+            fprintf(stderr, "source %u is out of range for size %u\n",
+                    opts.source, size);
+            return 1;
+        }
+        int *paths = (int*) malloc(size * sizeof(int));
+        struct workspace *ws = workspace_create(size);
+        if (paths == NULL || ws == NULL) {
+            fprintf(stderr, "couldn't allocate the paths for size %u\n",
+                    size);
+            return 1;
+        }
+
+        for (int i = 0; i < opts.nbs; i += 1) {
+            for (int j = 0; j < opts.nseeds; j += 1) {
+                const unsigned int seed = opts.seeds[j];
+                struct graph graph;
+                if (!prepare_graph(&opts, size, opts.bs[i], seed, &graph)) {
+                    fprintf(stderr, "couldn't allocate a graph of size %u\n",
+                            size);
+                    if (opts.pages == MATRIX_PAGES_EXPLICIT)
+                        fprintf(stderr, "are enough huge pages reserved? "
+                                "see vm.nr_hugepages\n");
+                    return 1;
+                }
+
+                for (int e = 0; e < opts.nengines; e += 1) {
+                    for (int t = 0; t < opts.nthreads; t += 1) {
+                        const int nthreads = opts.threads[t];
+                        const struct result result = run_engine(&opts, &graph,
+                                ws, paths, opts.engines[e], nthreads);
+                        print_result(&opts, opts.engines[e], size, opts.bs[i],
+                                seed, nthreads, &result, first);
+                        first = false;
+                    }
+                }
+                release_graph(&graph);
+            }
+        }
+
+        workspace_destroy(ws);
+        free(paths);
+    }
+
+    if (opts.json) printf("\n]\n");
+    return 0;
+}
+
+static void
+usage(char const*name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --engines LIST     dijkstra,pdijkstra,persistent,delta,dial,"
+            "floyd\n"
+            "                     (default pdijkstra)\n"
+            "  --threads LIST     thread counts (default 1)\n"
+            "  --sizes LIST       graph sizes (default 1000)\n"
+            "  --b LIST           branching factors (default 0.5)\n"
+            "  --seeds LIST       graph seeds (default 0)\n"
+            "  --max-weight N     maximum edge weight (default 100)\n"
+            "  --source N         source vertex (default 0)\n"
+            "  --reps N           timed runs per combination (default 5)\n"
+            "  --warmup N         untimed runs first (default 1)\n"
+            "  --delta N          delta-stepping bucket width (default auto)\n"
+            "  --implicit         compute the graph on the fly; "
+            "skips delta and dial\n"
+            "  --partitions N     store the graph as N blocks of columns, "
+            "e.g. one per\n"
+            "                     NUMA node (default 0, a single block)\n"
+            "  --bind POLICY      pin the threads with OMP_PROC_BIND, "
+            "e.g. close or spread,\n"
+            "                     restarting the program with it set "
+            "(Linux only)\n"
+            "  --pages KIND       back the graph with transparent or "
+            "explicit huge\n"
+            "                     pages (default, ordinary pages)\n"
+            "  --reorder ORDER    renumber the vertices by bfs, rcm or "
+            "degree first\n"
+            "  --pipeline LIST    instead, report the throughput of "
+            "generating and\n"
+            "                     solving every seed's graph in turn, "
+            "with each of these\n"
+            "                     numbers of instances splitting the "
+            "threads\n"
+            "  --graphs N         with --pipeline, use N seeds from the "
+            "first\n"
+            "  --json             report JSON instead of CSV\n"
+            "  --validate         check each result against dijkstra\n",
+            name);
+}
+
+/*
+ * Read the options, with the defaults for any not given.
+ * Returns false if any are malformed.
+ */
+static bool
+parse_options(int argc, char **argv, struct options *opts)
+{
+    static const struct option long_options[] = {
+        { "engines", required_argument, NULL, 'e' },
+        { "threads", required_argument, NULL, 't' },
+        { "sizes", required_argument, NULL, 'n' },
+        { "b", required_argument, NULL, 'b' },
+        { "seeds", required_argument, NULL, 's' },
+        { "max-weight", required_argument, NULL, 'w' },
+        { "source", required_argument, NULL, 'S' },
+        { "reps", required_argument, NULL, 'r' },
+        { "warmup", required_argument, NULL, 'u' },
+        { "delta", required_argument, NULL, 'd' },
+        { "implicit", no_argument, NULL, 'i' },
+        { "partitions", required_argument, NULL, 'p' },
+        { "bind", required_argument, NULL, 'B' },
+        { "pages", required_argument, NULL, 'P' },
+        { "reorder", required_argument, NULL, 'R' },
+        { "pipeline", required_argument, NULL, 'I' },
+        { "graphs", required_argument, NULL, 'g' },
+        { "json", no_argument, NULL, 'j' },
+        { "validate", no_argument, NULL, 'v' },
+        { NULL, 0, NULL, 0 },
+    };
+
+    memset(opts, 0, sizeof(struct options));
+    opts->engines[0] = ENGINE_PDIJKSTRA;
+    opts->nengines = 1;
+    opts->threads[0] = 1;
+    opts->nthreads = 1;
+    opts->sizes[0] = 1000;
+    opts->nsizes = 1;
+    opts->bs[0] = 0.5;
+    opts->nbs = 1;
+    opts->seeds[0] = 0;
+    opts->nseeds = 1;
+    opts->max_weight = 100;
+    opts->reps = 5;
+    opts->warmup = 1;
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (opt) {
+        case 'e': {
+            opts->nengines = 0;
+            char *list = strdup(optarg);
+            for (char *name = strtok(list, ","); name != NULL;
+                    name = strtok(NULL, ",")) {
+                int e = 0;
+                while (e < NENGINES && strcmp(name, engine_names[e]) != 0)
+                    e += 1;
+                if (e == NENGINES || opts->nengines == MAX_LIST) {
+                    fprintf(stderr, "unknown engine: %s\n", name);
+                    free(list);
+                    return false;
+                }
+                opts->engines[opts->nengines] = e;
+                opts->nengines += 1;
+            }
+            free(list);
+            break;
+        }
+        case 't': opts->nthreads = parse_list(optarg, opts->threads); break;
+        case 'n': opts->nsizes = parse_list(optarg, opts->sizes); break;
+        case 'b': opts->nbs = parse_list(optarg, opts->bs); break;
+        case 's': opts->nseeds = parse_list(optarg, opts->seeds); break;
+        case 'w': opts->max_weight = atoi(optarg); break;
+        case 'S': opts->source = atoi(optarg); break;
+        case 'r': opts->reps = atoi(optarg); break;
+        case 'u': opts->warmup = atoi(optarg); break;
+        case 'd': opts->delta = atoi(optarg); break;
+        case 'i': opts->implicit = true; break;
+        case 'p': opts->partitions = atoi(optarg); break;
+        case 'B': opts->bind = optarg; break;
+        case 'I': opts->ninstances = parse_list(optarg, opts->instances); break;
+        case 'g': opts->graphs = atoi(optarg); break;
+        case 'P': {
+            static char const*const page_names[] = {
+                [MATRIX_PAGES_DEFAULT] = "default",
+                [MATRIX_PAGES_TRANSPARENT] = "transparent",
+                [MATRIX_PAGES_EXPLICIT] = "explicit",
+            };
+            int p = 0;
+            while (p <= MATRIX_PAGES_EXPLICIT
+                    && strcmp(optarg, page_names[p]) != 0)
+                p += 1;
+            if (p > MATRIX_PAGES_EXPLICIT) {
+                fprintf(stderr, "unknown pages: %s\n", optarg);
+                return false;
+            }
+            opts->pages = p;
+            break;
+        }
+        case 'R':
+            if (!reorder_kind_named(optarg, &opts->reorder_kind)) {
+                fprintf(stderr, "unknown order: %s\n", optarg);
+                return false;
+            }
+            opts->reorder = true;
+            break;
+        case 'j': opts->json = true; break;
+        case 'v': opts->validate = true; break;
+        default: return false;
+        }
+    }
+
+    return optind == argc && opts->nengines > 0 && opts->nthreads > 0
+        && opts->nsizes > 0 && opts->nbs > 0 && opts->nseeds > 0
+        && opts->reps > 0 && opts->warmup >= 0
+        && !(opts->implicit && (opts->partitions > 0 || opts->reorder))
+        && (opts->ninstances == 0
+                || !(opts->implicit || opts->partitions > 0 || opts->reorder));
+}
+
+/*
+ * Pin the threads with the specified `OMP_PROC_BIND` policy, to
+ * cores unless `OMP_PLACES` says otherwise.  The OpenMP runtime
+ * only reads its environment as the program starts, so unless
+ * `OMP_PROC_BIND` is already exactly the policy, this sets it,
+ * overriding any other value, and re-executes the program with
+ * the same arguments through `/proc/self/exe`, which only Linux
+ * provides.  The new process finds the policy set and returns
+ * straight away.  If the program can't be re-executed, it exits
+ * rather than run unpinned; set `OMP_PROC_BIND` in the
+ * environment instead there.
+ */
+static void
+bind_threads(char const*policy, char **argv)
+{
+    char const*current = getenv("OMP_PROC_BIND");
+    if (current != NULL && strcmp(current, policy) == 0) return;
+
+    setenv("OMP_PROC_BIND", policy, 1);
+    setenv("OMP_PLACES", "cores", 0);
+    execv("/proc/self/exe", argv);
+    perror("couldn't restart to bind the threads");
+    fprintf(stderr, "set OMP_PROC_BIND=%s in the environment instead\n",
+            policy);
+    exit(1);
+}
+
+/*
+ * Read a comma separated list of numbers into values.
+ * Returns how many there were, or 0 if any were malformed.
+ */
+static int
+parse_list(char const*list, double *values)
+{
+    int count = 0;
+    while (*list != '\0' && count < MAX_LIST) {
+        char *end;
+        values[count] = strtod(list, &end);
+        if (end == list || (*end != ',' && *end != '\0')) return 0;
+        count += 1;
+        list = (*end == ',') ? end + 1 : end;
+    }
+    return (*list == '\0') ? count : 0;
+}
+
+/*
+ * Generate the graph for the seed, in the narrowest weights that
+ * fit or implicitly, plus a CSR copy if delta-stepping or Dial's
+ * algorithm is to run and the reference distances if results are
+ * to be validated.  With `--reorder`, the matrix and CSR copy are
+ * then renumbered, though the distances stay in the original ids.
+ */
+static bool
+prepare_graph(struct options const*opts, unsigned int size, float b,
+        unsigned int seed, struct graph *graph)
+{
+    memset(graph, 0, sizeof(struct graph));
+    const enum matrix_format format = (opts->implicit)
+        ? MATRIX_IMPLICIT : matrix_format_for(opts->max_weight);
+    graph->matrix = (opts->partitions > 0)
+        ? matrix_create_partitioned(size, format, opts->partitions)
+        : matrix_create(size, format);
+    if (graph->matrix == NULL) return false;
+
+    // The generator first touches each thread's columns, so place
+    // them for the most threads the engines will run with.
+    int max_threads = 1;
+    for (int t = 0; t < opts->nthreads; t += 1)
+        if (opts->threads[t] > max_threads) max_threads = opts->threads[t];
+    omp_set_num_threads(max_threads);
+    pset_seed(seed);
+    pgenerate_matrix(graph->matrix, b, opts->max_weight);
+
+    bool use_csr = false;
+    for (int e = 0; e < opts->nengines; e += 1)
+        if (opts->engines[e] == ENGINE_DELTA
+                || opts->engines[e] == ENGINE_DIAL) use_csr = true;
+    // The orders are computed from the CSR copy.
+    if ((use_csr || opts->reorder) && !opts->implicit) {
+        // The generator is deterministic, so an `int` copy for the
+        // conversion is the same graph.
+        struct matrix *ints = matrix_create(size, MATRIX_INT);
+        if (ints == NULL) return false;
+        pset_seed(seed);
+        pgenerate_matrix(ints, b, opts->max_weight);
+        graph->csr = csr_from_matrix(ints->weights, size);
+        matrix_destroy(ints);
+        if (graph->csr == NULL) return false;
+    }
+
+    if (opts->validate) {
+        struct workspace *ws = workspace_create(size);
+        int *paths = (int*) malloc(size * sizeof(int));
+        graph->distances = (int*) malloc(size * sizeof(int));
+        const bool allocated = ws != NULL && paths != NULL
+            && graph->distances != NULL;
+        if (allocated) {
+            dijkstra_matrix(ws, graph->matrix, opts->source, paths);
+            dijkstra_distances(ws, size, graph->distances);
+        }
+        free(paths);
+        workspace_destroy(ws);
+        if (!allocated) return false;
+    }
+
+    graph->source = opts->source;
+    if (opts->reorder) {
+        graph->reorder = reorder_create(graph->csr, opts->reorder_kind);
+        graph->original_paths = (int*) malloc(size * sizeof(int));
+        if (graph->reorder == NULL || graph->original_paths == NULL)
+            return false;
+        graph->source = graph->reorder->rank[opts->source];
+
+        struct matrix *matrix = reorder_matrix(graph->reorder, graph->matrix);
+        struct csr_graph *csr = (use_csr)
+            ? reorder_csr(graph->reorder, graph->csr) : NULL;
+        matrix_destroy(graph->matrix);
+        csr_free(graph->csr);
+        graph->matrix = matrix;
+        graph->csr = csr;
+        if (matrix == NULL || (use_csr && csr == NULL)) return false;
+    }
+
+    bool use_floyd = false;
+    for (int e = 0; e < opts->nengines; e += 1)
+        if (opts->engines[e] == ENGINE_FLOYD) use_floyd = true;
+    if (use_floyd) {
+        const size_t cells = (size_t) size * size;
+        graph->ints = (int*) malloc(cells * sizeof(int));
+        graph->all_distances = (int*) malloc(cells * sizeof(int));
+        graph->next = (int*) malloc(cells * sizeof(int));
+        if (graph->ints == NULL || graph->all_distances == NULL
+                || graph->next == NULL) return false;
+        // Copied after any renumbering, from whichever format.
+        #pragma omp parallel for
+        for (unsigned int v = 0; v < size; v += 1)
+            for (unsigned int w = 0; w < size; w += 1)
+                graph->ints[(size_t) v*size + w]
+                    = matrix_weight(graph->matrix, v, w);
+    }
+    return true;
+}
+
+static void
+release_graph(struct graph *graph)
+{
+    matrix_destroy(graph->matrix);
+    csr_free(graph->csr);
+    free(graph->distances);
+    reorder_destroy(graph->reorder);
+    free(graph->original_paths);
+    free(graph->ints);
+    free(graph->all_distances);
+    free(graph->next);
+}
+
+/*
+ * Run the engine with the specified number of threads, first for
+ * the warm up runs, then for the timed runs.
+ */
+static struct result
+run_engine(struct options const*opts, struct graph *graph,
+        struct workspace *ws, int *paths, int engine, int nthreads)
+{
+    struct result result = { 0, 0, 0, 0, 0, "skipped", {0} };
+    if ((engine == ENGINE_DELTA || engine == ENGINE_DIAL)
+            && graph->csr == NULL) {
+        result.valid = "unsupported";
+        return result;
+    }
+
+    omp_set_num_threads(nthreads);
+    for (int i = 0; i < opts->warmup; i += 1)
+        run_once(opts, graph, ws, paths, engine);
+
+    // Only the timed runs count towards the stats.
+    ws->stats = &result.stats;
+    double walls[opts->reps], cpus[opts->reps];
+    for (int i = 0; i < opts->reps; i += 1) {
+        const double start_wall = omp_get_wtime();
+        const clock_t start_cpu = clock();
+        run_once(opts, graph, ws, paths, engine);
+        cpus[i] = (double) (clock() - start_cpu) / CLOCKS_PER_SEC;
+        walls[i] = omp_get_wtime() - start_wall;
+    }
+    ws->stats = NULL;
+
+    result.wall_median = percentile(walls, opts->reps, 0.5);
+    result.wall_p95 = percentile(walls, opts->reps, 0.95);
+    // `percentile` has sorted the times.
+    result.wall_min = walls[0];
+    result.cpu_median = percentile(cpus, opts->reps, 0.5);
+    result.cpu_p95 = percentile(cpus, opts->reps, 0.95);
+    if (opts->validate) {
+        int const*checked = paths;
+        if (graph->reorder != NULL) {
+            reorder_paths(graph->reorder, paths, graph->original_paths);
+            checked = graph->original_paths;
+        }
+        result.valid = (valid_paths(graph, opts->source, checked))
+            ? "yes" : "no";
+    }
+    return result;
+}
+
+static void
+run_once(struct options const*opts, struct graph *graph,
+        struct workspace *ws, int *paths, int engine)
+{
+    switch (engine) {
+    case ENGINE_DIJKSTRA:
+        dijkstra_matrix(ws, graph->matrix, graph->source, paths);
+        break;
+    case ENGINE_PDIJKSTRA:
+        pdijkstra_matrix(ws, graph->matrix, graph->source, paths);
+        break;
+    case ENGINE_PERSISTENT:
+        pdijkstra_persistent_matrix(ws, graph->matrix, graph->source, paths);
+        break;
+    case ENGINE_DELTA:
+        if (!delta_stepping(graph->csr, graph->source, opts->delta, paths)) {
+            fprintf(stderr, "couldn't allocate delta-stepping's buckets\n");
+            exit(1);
+        }
+        break;
+    case ENGINE_DIAL:
+        dial_with(ws, graph->csr, graph->source, opts->max_weight, paths);
+        break;
+    case ENGINE_FLOYD:
+        if (!floyd_warshall(graph->ints, graph->matrix->size,
+                    graph->all_distances, graph->next)) {
+            fprintf(stderr, "couldn't allocate Floyd-Warshall's paths\n");
+            exit(1);
+        }
+        floyd_paths(graph, paths);
+        break;
+    }
+}
+
+/*
+ * The source's shortest path tree, from Floyd-Warshall's successors:
+ * each vertex's predecessor is the last vertex before it on the path
+ * from the source.
+ */
+static void
+floyd_paths(struct graph const*graph, int *paths)
+{
+    const size_t size = graph->matrix->size;
+    const unsigned int source = graph->source;
+    int const*const next = graph->next;
+
+    #pragma omp parallel for
+    for (unsigned int w = 0; w < size; w += 1) {
+        if (next[source*size + w] == -1) {
+            paths[w] = -1;
+            continue;
+        }
+        unsigned int v = source;
+        while (w != v && next[v*size + w] != (int) w) v = next[v*size + w];
+        paths[w] = v;
+    }
+}
+
+/*
+ * Checks that the paths form a shortest path tree: exactly the
+ * vertices `dijkstra` reached have predecessors, and every
+ * predecessor's edge is tight with `dijkstra`'s distances.
+ * Engines may break ties between equally short paths differently,
+ * so this is checked rather than equality with `dijkstra`'s paths.
+ * The source and paths are in the original ids.
+ */
+static bool
+valid_paths(struct graph const*graph, unsigned int source, int const*paths)
+{
+    const unsigned int size = graph->matrix->size;
+    int const*const distances = graph->distances;
+    if (paths[source] != (int) source) return false;
+
+    for (unsigned int w = 0; w < size; w += 1) {
+        if ((paths[w] == -1) != (distances[w] == -1)) return false;
+        if (w == source || paths[w] == -1) continue;
+
+        const int v = paths[w];
+        if (v < 0 || (unsigned int) v >= size || distances[v] == -1)
+            return false;
+        const int weight = (graph->reorder != NULL)
+            ? matrix_weight(graph->matrix, graph->reorder->rank[v],
+                    graph->reorder->rank[w])
+            : matrix_weight(graph->matrix, v, w);
+        if (weight == -1 || distances[v] + weight != distances[w])
+            return false;
+    }
+    return true;
+}
+
+/*
+ * The nearest rank percentile p of the n values, sorting them.
+ */
+static double
+percentile(double *values, int n, double p)
+{
+    qsort(values, n, sizeof(double), compare_doubles);
+    int rank = (int) (p * n + 0.999999) - 1;
+    if (rank < 0) rank = 0;
+    return values[rank];
+}
+
+static int
+compare_doubles(void const*a, void const*b)
+{
+    const double x = *(double const*) a, y = *(double const*) b;
+    return (x > y) - (x < y);
+}
+
+static void
+print_result(struct options const*opts, int engine, unsigned int size,
+        float b, unsigned int seed, int nthreads, struct result const*result,
+        bool first)
+{
+    if (!opts->json) {
+        printf("%s,%u,%g,%u,%u,%d,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%s",
+                engine_names[engine], size, b, opts->max_weight, seed,
+                nthreads, opts->reps, result->wall_median, result->wall_p95,
+                result->wall_min, result->cpu_median, result->cpu_p95,
+                result->valid);
+    } else {
+        printf("%s\n  {\"engine\": \"%s\", \"size\": %u, \"b\": %g, "
+               "\"max_weight\": %u, \"seed\": %u, \"threads\": %d, "
+               "\"reps\": %d, \"wall_median_s\": %.6f, \"wall_p95_s\": %.6f, "
+               "\"wall_min_s\": %.6f, \"cpu_median_s\": %.6f, "
+               "\"cpu_p95_s\": %.6f, \"valid\": \"%s\"",
+                (first) ? "" : ",", engine_names[engine], size, b,
+                opts->max_weight, seed, nthreads, opts->reps,
+                result->wall_median, result->wall_p95, result->wall_min,
+                result->cpu_median, result->cpu_p95, result->valid);
+    }
+    if (STATS_ENABLED) print_stats(opts, result);
+    printf((opts->json) ? "}" : "\n");
+    fflush(stdout);
+}
+
+/*
+ * Print the stats averaged over the timed runs, or leave them
+ * empty, or null in JSON, for engines which don't collect them.
+ */
+static void
+print_stats(struct options const*opts, struct result const*result)
+{
+    struct engine_stats const*const stats = &result->stats;
+    if (stats->runs == 0) {
+        printf("%s", (!opts->json) ? ",,,,,,,,"
+                : ", \"prepare_s\": null, \"sweep_s\": null, "
+                  "\"sync_s\": null, \"imbalance_s\": null, "
+                  "\"iterations\": null, \"edges_scanned\": null, "
+                  "\"improvements\": null, \"exit_iteration\": null");
+        return;
+    }
+    const double runs = stats->runs;
+    const char *format = (!opts->json)
+        ? ",%.6f,%.6f,%.6f,%.6f,%.0f,%.0f,%.0f,%lu"
+        : ", \"prepare_s\": %.6f, \"sweep_s\": %.6f, \"sync_s\": %.6f, "
+          "\"imbalance_s\": %.6f, \"iterations\": %.0f, "
+          "\"edges_scanned\": %.0f, \"improvements\": %.0f, "
+          "\"exit_iteration\": %lu";
+    printf(format, stats->prepare_time / runs, stats->sweep_time / runs,
+            stats->sync_time / runs, stats->imbalance_time / runs,
+            stats->iterations / runs, stats->edges_scanned / runs,
+            stats->improvements / runs, stats->exit_iteration);
+}
+
+/*
+ * Time pipelines of generating and solving every seed's graph, for
+ * each size, branching factor, thread count and instance count,
+ * reporting the median wall time and throughput over the runs.
+ * With `--validate`, every graph's paths are checked against those
+ * of `pdijkstra` run on its own, which breaks ties the same way.
+ */
+static void
+run_pipelines(struct options const*opts)
+{
+    unsigned int nseeds = (opts->graphs > 0) ? opts->graphs : opts->nseeds;
+    unsigned int *seeds = malloc(nseeds * sizeof(unsigned int));
+    if (seeds == NULL) {
+        fprintf(stderr, "couldn't allocate the seeds\n");
+        exit(1);
+    }
+    for (unsigned int i = 0; i < nseeds; i += 1)
+        seeds[i] = (opts->graphs > 0) ? opts->seeds[0] + i : opts->seeds[i];
+
+    if (!opts->json)
+        printf("mode,size,b,max_weight,threads,instances,graphs,reps,"
+               "wall_median_s,graphs_per_s,generate_s,solve_s,valid\n");
+    else
+        printf("[");
+
+    bool first = true;
+    for (int s = 0; s < opts->nsizes; s += 1) {
+        const unsigned int size = opts->sizes[s];
+        for (int i = 0; i < opts->nbs; i += 1) {
+            int *want = (opts->validate)
+                ? reference_paths(opts, size, opts->bs[i], seeds, nseeds)
+                : NULL;
+            struct check check = { size, want, true };
+
+            for (int t = 0; t < opts->nthreads; t += 1) {
+                for (int k = 0; k < opts->ninstances; k += 1) {
+                    const struct pipeline pipeline = {
+                        .size = size, .b = opts->bs[i],
+                        .max_weight = opts->max_weight,
+                        .source = opts->source,
+                        .ninstances = opts->instances[k],
+                        .nthreads = opts->threads[t],
+                        .solved = (want != NULL) ? check_paths : NULL,
+                        .context = &check,
+                    };
+                    if (pipeline.ninstances < 1 || opts->source >= size
+                            || (int) pipeline.ninstances > pipeline.nthreads)
+                        continue;
+
+                    for (int r = 0; r < opts->warmup; r += 1) {
+                        struct pipeline_report report;
+                        pipeline_run(&pipeline, seeds, nseeds, &report);
+                    }
+                    double walls[opts->reps];
+                    struct pipeline_report report;
+                    for (int r = 0; r < opts->reps; r += 1) {
+                        if (!pipeline_run(&pipeline, seeds, nseeds, &report)) {
+                            fprintf(stderr, "couldn't allocate the pipeline "
+                                    "for size %u\n", size);
+                            exit(1);
+                        }
+                        walls[r] = report.wall_time;
+                    }
+
+                    char const*valid = "skipped";
+                    if (want != NULL) valid = (check.valid) ? "yes" : "no";
+                    print_pipeline(opts, size, opts->bs[i], pipeline.nthreads,
+                            pipeline.ninstances, &report,
+                            percentile(walls, opts->reps, 0.5), valid, first);
+                    first = false;
+                }
+            }
+            free(want);
+        }
+    }
+
+    if (opts->json) printf("\n]\n");
+    free(seeds);
+}
+
+/*
+ * The paths of each seed's graph from `pdijkstra`, one after
+ * the other, with `size` entries per seed.
+ */
+static int *
+reference_paths(struct options const*opts, unsigned int size, float b,
+        unsigned int const*seeds, unsigned int nseeds)
+{
+    int *want = malloc((size_t) nseeds * size * sizeof(int));
+    struct matrix *matrix = matrix_create(size,
+            matrix_format_for(opts->max_weight));
+    struct workspace *ws = workspace_create(size);
+    if (want == NULL || matrix == NULL || ws == NULL) {
+        fprintf(stderr, "couldn't allocate the reference paths\n");
+        exit(1);
+    }
+
+    for (unsigned int i = 0; i < nseeds; i += 1) {
+        pgenerate_matrix_seeded(matrix, seeds[i], b, opts->max_weight);
+        pdijkstra_matrix(ws, matrix, opts->source, want + (size_t) i*size);
+    }
+    workspace_destroy(ws);
+    matrix_destroy(matrix);
+    return want;
+}
+
+/*
+ * Check the paths of the ith seed's graph against the reference.
+ */
+static void
+check_paths(unsigned int i, int const*paths, void *context)
+{
+    struct check *const check = context;
+    if (memcmp(paths, check->want + (size_t) i*check->size,
+                check->size * sizeof(int)) != 0) {
+#pragma omp atomic write
+        check->valid = false;
+    }
+}
+
+static void
+print_pipeline(struct options const*opts, unsigned int size, float b,
+        int nthreads, int ninstances, struct pipeline_report const*report,
+        double wall_median, char const*valid, bool first)
+{
+    const double graphs_per_second = (wall_median > 0)
+        ? report->graphs / wall_median : 0;
+    if (!opts->json) {
+        printf("pipeline,%u,%g,%u,%d,%d,%u,%d,%.6f,%.3f,%.6f,%.6f,%s\n",
+                size, b, opts->max_weight, nthreads, ninstances,
+                report->graphs, opts->reps, wall_median, graphs_per_second,
+                report->generate_time, report->solve_time, valid);
+    } else {
+        printf("%s\n  {\"mode\": \"pipeline\", \"size\": %u, \"b\": %g, "
+               "\"max_weight\": %u, \"threads\": %d, \"instances\": %d, "
+               "\"graphs\": %u, \"reps\": %d, \"wall_median_s\": %.6f, "
+               "\"graphs_per_s\": %.3f, \"generate_s\": %.6f, "
+               "\"solve_s\": %.6f, \"valid\": \"%s\"}",
+                (first) ? "" : ",", size, b, opts->max_weight, nthreads,
+                ninstances, report->graphs, opts->reps, wall_median,
+                graphs_per_second, report->generate_time, report->solve_time,
+                valid);
+    }
+    fflush(stdout);
+}
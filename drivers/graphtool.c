@@ -0,0 +1,401 @@
+#include <errno.h>
+#include <omp.h>
+#include <time.h>
+
+#include "../src/deltastep.h"
+#include "../src/dijkstra.h"
+#include "../src/graphfile.h"
+#include "../src/incremental.h"
+#include "../src/p2p.h"
+#include "../src/pdijkstra.h"
+#include "../src/prnggraph.h"
+
+static int generate(int, char**);
+static int info(int, char**);
+static int run(int, char**);
+static int query(int, char**);
+static int update(int, char**);
+static void usage(char const*);
+
+/*
+ * Saves generated graphs to graph files, and runs the engines on
+ * graph files mapped straight into memory.
+ */
+int
+main(int argc, char **argv)
+{
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (strcmp(argv[1], "generate") == 0) return generate(argc, argv);
+    if (strcmp(argv[1], "info") == 0) return info(argc, argv);
+    if (strcmp(argv[1], "run") == 0) return run(argc, argv);
+    if (strcmp(argv[1], "query") == 0) return query(argc, argv);
+    if (strcmp(argv[1], "update") == 0) return update(argc, argv);
+    usage(argv[0]);
+    return 1;
+}
+
+static void
+usage(char const*name)
+{
+    fprintf(stderr,
+            "usage: %s generate <size> <b> <max_weight> <seed> <file> "
+            "[dense|csr]\n"
+            "       %s info <file>\n"
+            "       %s run <file> <nthreads> [source]\n"
+            "       %s query <file> <source> <target> "
+            "[dijkstra|bidirectional|alt] [landmarks]\n"
+            "       %s update <file> <source> <count> [seed]\n",
+            name, name, name, name, name);
+}
+
+/*
+ * Generate a graph as `pdijkstra` would for the seed, and save it
+ * either as a matrix of the narrowest weights that fit, or in CSR
+ * form for delta-stepping.
+ */
+static int
+generate(int argc, char **argv)
+{
+    if (argc < 7) {
+        usage(argv[0]);
+        return 1;
+    }
+    const unsigned int size = atoi(argv[2]);
+    const float b = atof(argv[3]);
+    const unsigned int max_weight = atoi(argv[4]);
+    const unsigned int seed = atoi(argv[5]);
+    char const*const path = argv[6];
+    const bool use_csr = (argc > 7) && (strcmp(argv[7], "csr") == 0);
+
+    struct matrix *edges = matrix_create(size,
+            (use_csr) ? MATRIX_INT : matrix_format_for(max_weight));
+    if (edges == NULL) {
+        fprintf(stderr, "couldn't allocate the matrix\n");
+        return 1;
+    }
+    pset_seed(seed);
+    pgenerate_matrix(edges, b, max_weight);
+
+    bool saved;
+    if (use_csr) {
+        struct csr_graph *graph = csr_from_matrix(edges->weights, size);
+        saved = (graph != NULL) && graphfile_save_csr(path, graph);
+        csr_free(graph);
+    } else {
+        saved = graphfile_save_matrix(path, edges);
+    }
+    matrix_destroy(edges);
+
+    if (!saved) {
+        perror(path);
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Describe a graph file's contents.
+ */
+static int
+info(int argc, char **argv)
+{
+    if (argc < 3) {
+        usage(argv[0]);
+        return 1;
+    }
+    struct graphfile *file = graphfile_open(argv[2]);
+    if (file == NULL) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    if (file->kind == GRAPHFILE_CSR) {
+        printf("kind: csr\n"
+               "size: %u\n"
+               "edges: %zu\n",
+               file->csr.size, file->csr.nedges);
+    } else {
+        static char const*const formats[] = {
+            [MATRIX_INT] = "int",
+            [MATRIX_U16] = "u16",
+            [MATRIX_U8] = "u8",
+            [MATRIX_IMPLICIT] = "implicit",
+        };
+        printf("kind: dense\n"
+               "size: %u\n"
+               "format: %s\n"
+               "presence bitmap: %s\n",
+               file->matrix.size, formats[file->matrix.format],
+               (file->matrix.presence != NULL) ? "yes" : "no");
+    }
+    printf("bytes: %zu\n", file->length);
+
+    graphfile_close(file);
+    return 0;
+}
+
+/*
+ * Map a graph file and run `pdijkstra` on it if it's dense,
+ * or delta-stepping if it's CSR.
+ */
+static int
+run(int argc, char **argv)
+{
+    if (argc < 4) {
+        usage(argv[0]);
+        return 1;
+    }
+    char const*const path = argv[2];
+    omp_set_num_threads(atoi(argv[3]));
+    const unsigned int source = (argc > 4) ? atoi(argv[4]) : 0;
+
+    printf("Opening the graph...");
+    fflush(stdout);
+    double start_wall = omp_get_wtime();
+    struct graphfile *file = graphfile_open(path);
+    if (file == NULL) {
+        printf("\n");
+        perror(path);
+        return 1;
+    }
+    printf("... Done\n"
+           "time: %fs\n",
+           omp_get_wtime() - start_wall);
+
+    const unsigned int size = (file->kind == GRAPHFILE_CSR)
+        ? file->csr.size : file->matrix.size;
+    if (source >= size) {
+        fprintf(stderr, "source must be less than %u\n", size);
+        graphfile_close(file);
+        return 1;
+    }
+    int *paths = (int*) malloc(size * sizeof(int));
+    struct workspace *ws = workspace_create(size);
+
+    printf("Running the algorithm...");
+    fflush(stdout);
+    start_wall = omp_get_wtime();
+    const long start_cpu = clock();
+    if (file->kind == GRAPHFILE_CSR) {
+        if (!delta_stepping(&file->csr, source, 0, paths)) {
+            fprintf(stderr, "couldn't allocate delta-stepping's buckets\n");
+            workspace_destroy(ws);
+            free(paths);
+            graphfile_close(file);
+            return 1;
+        }
+    } else {
+        pdijkstra_matrix(ws, &file->matrix, source, paths);
+    }
+    printf("... Done\n"
+           "time: %fs\n"
+           "work: %ld ticks\n",
+           omp_get_wtime() - start_wall,
+           clock() - start_cpu);
+
+    unsigned int reached = 0;
+    for (unsigned int i = 0; i < size; i += 1)
+        if (paths[i] != -1) reached += 1;
+    printf("reached: %u vertices\n", reached);
+
+    workspace_destroy(ws);
+    free(paths);
+    graphfile_close(file);
+    return 0;
+}
+
+/*
+ * Map a CSR graph file and find the shortest path between two
+ * vertices, reporting its length and how many vertices were
+ * settled to find it.
+ */
+static int
+query(int argc, char **argv)
+{
+    if (argc < 5) {
+        usage(argv[0]);
+        return 1;
+    }
+    char const*const path = argv[2];
+    const unsigned int source = atoi(argv[3]);
+    const unsigned int target = atoi(argv[4]);
+    char const*const mode_name = (argc > 5) ? argv[5] : "dijkstra";
+    const unsigned int nlandmarks = (argc > 6) ? atoi(argv[6]) : 16;
+
+    enum p2p_mode mode;
+    if (strcmp(mode_name, "dijkstra") == 0) {
+        mode = P2P_DIJKSTRA;
+    } else if (strcmp(mode_name, "bidirectional") == 0) {
+        mode = P2P_BIDIRECTIONAL;
+    } else if (strcmp(mode_name, "alt") == 0) {
+        mode = P2P_ALT;
+    } else {
+        fprintf(stderr, "unknown mode: %s "
+                "(expected dijkstra, bidirectional or alt)\n", mode_name);
+        return 1;
+    }
+
+    struct graphfile *file = graphfile_open(path);
+    if (file == NULL) {
+        perror(path);
+        return 1;
+    }
+    if (file->kind != GRAPHFILE_CSR) {
+        fprintf(stderr, "queries need a csr graph file\n");
+        graphfile_close(file);
+        return 1;
+    }
+    const unsigned int size = file->csr.size;
+    if (source >= size || target >= size) {
+        fprintf(stderr, "source and target must be less than %u\n", size);
+        graphfile_close(file);
+        return 1;
+    }
+
+    printf("Preparing...");
+    fflush(stdout);
+    double start_wall = omp_get_wtime();
+    struct p2p *p2p = p2p_create(&file->csr,
+            (mode == P2P_ALT) ? nlandmarks : 0);
+    if (p2p == NULL) {
+        printf("\n");
+        fprintf(stderr, "couldn't allocate the query state\n");
+        graphfile_close(file);
+        return 1;
+    }
+    printf("... Done\n"
+           "time: %fs\n",
+           omp_get_wtime() - start_wall);
+
+    int *paths = (int*) malloc(size * sizeof(int));
+    start_wall = omp_get_wtime();
+    const int distance = p2p_query(p2p, source, target, mode, paths);
+    printf("query time: %fs\n"
+           "distance: %d\n"
+           "settled: %lu vertices\n",
+           omp_get_wtime() - start_wall, distance, p2p->settled);
+
+    if (distance != -1) {
+        unsigned int hops = 0;
+        for (unsigned int v = target; v != source; v = paths[v])
+            hops += 1;
+        printf("hops: %u\n", hops);
+    }
+
+    free(paths);
+    p2p_destroy(p2p);
+    graphfile_close(file);
+    return 0;
+}
+
+/*
+ * Load a dense graph file, find the paths from the source, then
+ * change the weights of random edges and time repairing the paths
+ * with `incremental_update` against finding them again, checking
+ * that both give the same distances.
+ */
+static int
+update(int argc, char **argv)
+{
+    if (argc < 5) {
+        usage(argv[0]);
+        return 1;
+    }
+    char const*const path = argv[2];
+    const unsigned int source = atoi(argv[3]);
+    const unsigned int count = atoi(argv[4]);
+    const unsigned int seed = (argc > 5) ? atoi(argv[5]) : 0;
+
+    struct graphfile *file = graphfile_open(path);
+    if (file == NULL) {
+        perror(path);
+        return 1;
+    }
+    if (file->kind != GRAPHFILE_DENSE) {
+        fprintf(stderr, "updates need a dense graph file\n");
+        graphfile_close(file);
+        return 1;
+    }
+    // Implicit matrices have no weights to change.
+    if (!matrix_can_store(file->matrix.format, 0)) {
+        fprintf(stderr, "updates need a graph file with stored weights\n");
+        graphfile_close(file);
+        return 1;
+    }
+    const unsigned int size = file->matrix.size;
+    if (source >= size) {
+        fprintf(stderr, "source must be less than %u\n", size);
+        graphfile_close(file);
+        return 1;
+    }
+
+    // The mapping is read only, so the edges are changed in a copy.
+    struct matrix *edges = (file->matrix.presence != NULL)
+        ? matrix_create_bitmap(size, file->matrix.format)
+        : matrix_create(size, file->matrix.format);
+    struct workspace *ws = workspace_create(size);
+    struct edge_update *updates = malloc((count + 1)
+            * sizeof(struct edge_update));
+    int *paths = (int*) malloc(size * sizeof(int));
+    int *distances = (int*) malloc(size * sizeof(int));
+    int *want = (int*) malloc(size * sizeof(int));
+    if (edges == NULL || ws == NULL || updates == NULL || paths == NULL
+            || distances == NULL || want == NULL) {
+        fprintf(stderr, "couldn't allocate the graph's copy\n");
+        matrix_destroy(edges);
+        workspace_destroy(ws);
+        free(updates);
+        free(paths);
+        free(distances);
+        free(want);
+        graphfile_close(file);
+        return 1;
+    }
+    for (unsigned int v = 0; v < size; v += 1)
+        for (unsigned int w = 0; w < size; w += 1)
+            matrix_set_weight(edges, v, w,
+                    matrix_weight(&file->matrix, v, w));
+    graphfile_close(file);
+
+    dijkstra_matrix(ws, edges, source, paths);
+    dijkstra_distances(ws, size, distances);
+
+    // Remove a quarter of the edges chosen, and give the rest
+    // weights the narrowest formats can hold.
+    srand(seed);
+    for (unsigned int i = 0; i < count; i += 1) {
+        updates[i].from = rand() % size;
+        updates[i].to = rand() % size;
+        updates[i].weight = (rand() % 4 == 0) ? -1 : rand() % 101;
+    }
+
+    double start_wall = omp_get_wtime();
+    const bool updated = incremental_update(ws, edges, source, updates,
+            count, paths, distances);
+    const double incremental_time = omp_get_wtime() - start_wall;
+
+    start_wall = omp_get_wtime();
+    dijkstra_matrix(ws, edges, source, paths);
+    const double rerun_time = omp_get_wtime() - start_wall;
+    dijkstra_distances(ws, size, want);
+
+    const bool same = updated
+        && memcmp(distances, want, size * sizeof(int)) == 0;
+    printf("updates: %u\n"
+           "incremental time: %fs\n"
+           "rerun time: %fs\n"
+           "same distances: %s\n",
+           count, incremental_time, rerun_time, (same) ? "yes" : "no");
+
+    matrix_destroy(edges);
+    workspace_destroy(ws);
+    free(updates);
+    free(paths);
+    free(distances);
+    free(want);
+    return (same) ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+#include <time.h>
+
+#include "../src/mpidijkstra.h"
+#include "../src/prnggraph.h"
+
+int
+main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    int rank, nranks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+    if (argc < 5) {
+        if (rank == 0)
+            fprintf(stderr, "usage: %s <size> <b> <max_weight> <seed> [source]\n",
+                    argv[0]);
+        MPI_Finalize();
+        return 1;
+    }
+    const unsigned int size = atoi(argv[1]);
+    const float b = atof(argv[2]);
+    const unsigned int max_weight = atoi(argv[3]);
+    const unsigned int seed = atoi(argv[4]);
+    const unsigned int source = (argc > 5) ? atoi(argv[5]) : 0;
+
+    unsigned int min, max;
+    mpidijkstra_block(size, rank, nranks, &min, &max);
+    int *block = (int*) malloc((size_t) size * (max - min) * sizeof(int));
+    int *paths = (int*) malloc((max - min + 1) * sizeof(int));
+
+    {
+        if (rank == 0) {
+            printf("ranks: %d\n"
+                   "Generating the graph...", nranks);
+            fflush(stdout);
+        }
+        const double start_wall = MPI_Wtime();
+        // Every rank's block is part of the same graph that
+        // `pdijkstra` generates for this seed.
+        pset_seed(seed);
+        pgenerate_block(size, min, max, b, max_weight, block);
+        double time = MPI_Wtime() - start_wall;
+        MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX,
+                MPI_COMM_WORLD);
+        if (rank == 0)
+            printf("... Done\n"
+                   "time: %fs\n", time);
+    }
+
+    {
+        if (rank == 0) {
+            printf("Running the algorithm...");
+            fflush(stdout);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+        const double start_wall = MPI_Wtime();
+        mpidijkstra(block, size, source, paths, MPI_COMM_WORLD);
+        double time = MPI_Wtime() - start_wall;
+        MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX,
+                MPI_COMM_WORLD);
+
+        int nreached = 0;
+        for (unsigned int i = 0; i < max - min; i += 1)
+            if (paths[i] != -1) nreached += 1;
+        MPI_Allreduce(MPI_IN_PLACE, &nreached, 1, MPI_INT, MPI_SUM,
+                MPI_COMM_WORLD);
+        if (rank == 0)
+            printf("... Done\n"
+                   "time: %fs\n"
+                   "reached: %d vertices\n", time, nreached);
+    }
+
+    free(paths);
+    free(block);
+    MPI_Finalize();
+    return 0;
+}
@@ -1,17 +1,57 @@
 #include <omp.h>
 #include <time.h>
 
+#include "../src/deltastep.h"
 #include "../src/pdijkstra.h"
 #include "../src/prnggraph.h"
 
+/*
+ * The highest branching factor for which the dense engines use
+ * a presence bitmap: below about one edge per 64 vertices, most
+ * bitmap words are empty and are skipped outright.
+ */
+#define BITMAP_MAX_B (1.0 / 64)
+
 int
 main(int argc, char **argv)
 {
+    if (argc < 6) {
+        fprintf(stderr, "usage: %s <size> <b> <max_weight> <seed> <nthreads> "
+                "[engine] [delta] [storage]\n", argv[0]);
+        return 1;
+    }
 
     const unsigned int size = atoi(argv[1]);
     const float b = atof(argv[2]);
     const unsigned int max_weight = atoi(argv[3]);
-    const unsigned int nthreads = atoi(argv[4]);
+    const unsigned int seed = atoi(argv[4]);
+    const unsigned int nthreads = atoi(argv[5]);
+    // Optional, after <seed> <nthreads> as in the README: which
+    // engine to run, delta-stepping's bucket width, and whether
+    // to store the graph or compute it on the fly.
+    const char *engine = (argc > 6) ? argv[6] : "pdijkstra";
+    const int delta = (argc > 7) ? atoi(argv[7]) : 0;
+    const char *storage = (argc > 8) ? argv[8] : "dense";
+
+    const bool use_persistent = (strcmp(engine, "persistent") == 0);
+    const bool use_delta = (strcmp(engine, "delta") == 0);
+    if (!use_persistent && !use_delta && strcmp(engine, "pdijkstra") != 0) {
+        fprintf(stderr, "unknown engine: %s "
+                "(expected pdijkstra, persistent or delta)\n", engine);
+        return 1;
+    }
+
+    const bool use_implicit = (strcmp(storage, "implicit") == 0);
+    const bool use_partitioned = (strcmp(storage, "partitioned") == 0);
+    if (!use_implicit && !use_partitioned && strcmp(storage, "dense") != 0) {
+        fprintf(stderr, "unknown storage: %s "
+                "(expected dense, partitioned or implicit)\n", storage);
+        return 1;
+    }
+    if ((use_implicit || use_partitioned) && use_delta) {
+        fprintf(stderr, "the delta engine needs dense storage\n");
+        return 1;
+    }
 
     // printf("size: %u\n", size);
     // printf("b: %f\n", b);
@@ -21,41 +61,96 @@ main(int argc, char **argv)
 
     omp_set_num_threads(nthreads);
 
-    int *edges = (int*) malloc(size*size * sizeof(int));
+    // The delta engine converts the matrix to CSR, which wants
+    // `int` weights; the dense engines stream the narrowest
+    // weights that fit instead, and skip absent edges with a
+    // presence bitmap when most words of it would be empty.
+    // Implicit graphs take no memory, but hash every weight
+    // on every visit.  Partitioned graphs keep each thread's
+    // columns in their own block, which the generator places
+    // on the thread's NUMA node.
+    const enum matrix_format format = (use_implicit) ? MATRIX_IMPLICIT
+        : (use_delta) ? MATRIX_INT : matrix_format_for(max_weight);
+    struct matrix *edges = (use_partitioned)
+        ? matrix_create_partitioned(size, format, nthreads)
+        : (!use_delta && !use_implicit && b < BITMAP_MAX_B)
+        ? matrix_create_bitmap(size, format) : matrix_create(size, format);
     int *paths = (int*) malloc(size * sizeof(int));
+    struct workspace *ws = workspace_create(size);
+    if (edges == NULL || paths == NULL || ws == NULL) {
+        fprintf(stderr, "couldn't allocate a graph of size %u\n", size);
+        workspace_destroy(ws);
+        free(paths);
+        matrix_destroy(edges);
+        return 1;
+    }
 
-    // This driver uses predetermined rng seeds for consistent results.
-    for (int seed = 0; seed < 10; seed += 1) {
-        {
-            printf("----\n"
-                   "seed: %d\n", seed);
-
-            printf("Generating the graph...");
-            fflush(stdout);
-            const double start_wall = omp_get_wtime();
-            const long start_cpu = clock();
-            pset_seed(seed);
-            pgenerate_graph(size, b, max_weight, edges);
-            printf("... Done\n"
-                   "time: %fs\n"
-                   "work: %ld ticks\n",
-                   omp_get_wtime() - start_wall,
-                   clock() - start_cpu);
-        }
+    // One run on the graph for the seed; see `bench` for sweeps.
+    {
+        printf("----\n"
+               "seed: %u\n", seed);
+
+        printf("Generating the graph...");
+        fflush(stdout);
+        const double start_wall = omp_get_wtime();
+        const long start_cpu = clock();
+        pset_seed(seed);
+        pgenerate_matrix(edges, b, max_weight);
+        printf("... Done\n"
+               "time: %fs\n"
+               "work: %ld ticks\n",
+               omp_get_wtime() - start_wall,
+               clock() - start_cpu);
+    }
 
-        {
-            printf("Running the algorithm...");
-            fflush(stdout);
-            const double start_wall = omp_get_wtime();
-            const long start_cpu = clock();
-            pdijkstra(edges, size, 0, paths);
-            printf("... Done\n"
-                   "time: %fs\n"
-                   "work: %ld ticks\n",
-                   omp_get_wtime() - start_wall,
-                   clock() - start_cpu);
+    struct csr_graph *graph = NULL;
+    if (use_delta) {
+        printf("Converting the graph...");
+        fflush(stdout);
+        const double start_wall = omp_get_wtime();
+        const long start_cpu = clock();
+        graph = csr_from_matrix(edges->weights, size);
+        if (graph == NULL) {
+            fprintf(stderr, "couldn't allocate the graph's CSR copy\n");
+            workspace_destroy(ws);
+            free(paths);
+            matrix_destroy(edges);
+            return 1;
         }
+        printf("... Done\n"
+               "time: %fs\n"
+               "work: %ld ticks\n",
+               omp_get_wtime() - start_wall,
+               clock() - start_cpu);
+    }
+
+    {
+        printf("Running the algorithm...");
+        fflush(stdout);
+        const double start_wall = omp_get_wtime();
+        const long start_cpu = clock();
+        if (use_delta) {
+            if (!delta_stepping(graph, 0, delta, paths)) {
+                fprintf(stderr, "couldn't allocate delta-stepping's buckets\n");
+                csr_free(graph);
+                workspace_destroy(ws);
+                free(paths);
+                matrix_destroy(edges);
+                return 1;
+            }
+        } else if (use_persistent)
+            pdijkstra_persistent_matrix(ws, edges, 0, paths);
+        else
+            pdijkstra_matrix(ws, edges, 0, paths);
+        printf("... Done\n"
+               "time: %fs\n"
+               "work: %ld ticks\n",
+               omp_get_wtime() - start_wall,
+               clock() - start_cpu);
     }
 
-    free(edges);
+    csr_free(graph);
+    workspace_destroy(ws);
+    free(paths);
+    matrix_destroy(edges);
 }
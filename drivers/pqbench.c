@@ -0,0 +1,334 @@
+#include <getopt.h>
+#include <omp.h>
+
+#include "../src/csrgraph.h"
+#include "../src/pq.h"
+#include "../src/prnggraph.h"
+
+#define MAX_LIST (64)
+#define NKINDS (PQ_RADIX + 1)
+
+/*
+ * What to run, from the command line.
+ */
+struct options {
+    enum pq_kind kinds[NKINDS];
+    int nkinds;
+    double sizes[MAX_LIST];
+    int nsizes;
+    double bs[MAX_LIST];
+    int nbs;
+    double seeds[MAX_LIST];
+    int nseeds;
+    unsigned int max_weight;
+    int reps;
+};
+
+/*
+ * One queue operation: a push of the vertex with the key,
+ * or a pop of a vertex with the key if the vertex is `PQ_ABSENT`.
+ */
+struct op {
+    unsigned int v;
+    int key;
+};
+
+/*
+ * The operations one run of Dijkstra's algorithm performed.
+ */
+struct trace {
+    struct op *ops;
+    size_t nops;
+    unsigned long inserts;
+    unsigned long decreases;
+    unsigned long pops;
+};
+
+static bool parse_options(int, char**, struct options*);
+static int parse_list(char const*, double*);
+static void usage(char const*);
+static bool record(unsigned int, float, unsigned int, unsigned int,
+        struct trace*);
+static void replay(struct pq*, struct trace const*);
+static bool check(struct pq*, struct trace const*);
+static double median(double*, int);
+static int compare_doubles(void const*, void const*);
+
+/*
+ * Times each kind of priority queue on the pushes, decreases and
+ * pops that Dijkstra's algorithm performs on generated graphs.
+ *
+ * Each graph is searched once from vertex 0 to record the
+ * operations, which are then replayed on every kind of queue, so
+ * that only the queue's own work is timed.  Vertices with equal
+ * keys may come out of the queues in different orders, but with
+ * Dijkstra's algorithm that never changes the keys pushed later.
+ */
+int
+main(int argc, char **argv)
+{
+    struct options opts;
+    if (!parse_options(argc, argv, &opts)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("kind,size,b,max_weight,seed,inserts,decreases,pops,reps,"
+           "median_s,min_s,ns_per_op,valid\n");
+    double *times = malloc(opts.reps * sizeof(double));
+    for (int n = 0; n < opts.nsizes; n += 1)
+    for (int i = 0; i < opts.nbs; i += 1)
+    for (int s = 0; s < opts.nseeds; s += 1) {
+        const unsigned int size = opts.sizes[n];
+        const float b = opts.bs[i];
+        const unsigned int seed = opts.seeds[s];
+        struct trace trace;
+        if (!record(size, b, opts.max_weight, seed, &trace)) {
+            fprintf(stderr, "couldn't allocate a graph of size %u\n", size);
+            free(times);
+            return 1;
+        }
+
+        for (int k = 0; k < opts.nkinds; k += 1) {
+            struct pq *pq = pq_create(opts.kinds[k], size);
+            if (pq == NULL) {
+                fprintf(stderr, "couldn't allocate the queue\n");
+                free(trace.ops);
+                free(times);
+                return 1;
+            }
+            // Once untimed, to fault in the queue's pages.
+            const bool valid = check(pq, &trace);
+            for (int r = 0; r < opts.reps; r += 1) {
+                pq_clear(pq);
+                const double start = omp_get_wtime();
+                replay(pq, &trace);
+                times[r] = omp_get_wtime() - start;
+            }
+            const double median_s = median(times, opts.reps);
+            printf("%s,%u,%g,%u,%u,%lu,%lu,%lu,%d,%.6f,%.6f,%.2f,%s\n",
+                    pq_kind_name(opts.kinds[k]), size, b, opts.max_weight,
+                    seed, trace.inserts, trace.decreases, trace.pops,
+                    opts.reps, median_s, times[0],
+                    1e9 * median_s / trace.nops, (valid) ? "yes" : "no");
+            fflush(stdout);
+            pq_destroy(pq);
+        }
+        free(trace.ops);
+    }
+    free(times);
+    return 0;
+}
+
+static void
+usage(char const*name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --kinds LIST       queues to time, of binary, 4ary, pairing "
+            "and radix (default all)\n"
+            "  --sizes LIST       graph sizes (default 20000)\n"
+            "  --b LIST           edge probabilities (default 0.001)\n"
+            "  --max-weight N     largest edge weight (default 100)\n"
+            "  --seeds LIST       graph seeds (default 0)\n"
+            "  --reps N           timed replays of each (default 10)\n",
+            name);
+}
+
+static bool
+parse_options(int argc, char **argv, struct options *opts)
+{
+    static struct option long_options[] = {
+        {"kinds", required_argument, NULL, 'k'},
+        {"sizes", required_argument, NULL, 'n'},
+        {"b", required_argument, NULL, 'b'},
+        {"max-weight", required_argument, NULL, 'w'},
+        {"seeds", required_argument, NULL, 's'},
+        {"reps", required_argument, NULL, 'r'},
+        {NULL, 0, NULL, 0},
+    };
+
+    opts->nkinds = NKINDS;
+    for (int k = 0; k < NKINDS; k += 1)
+        opts->kinds[k] = k;
+    opts->sizes[0] = 20000;
+    opts->nsizes = 1;
+    opts->bs[0] = 0.001;
+    opts->nbs = 1;
+    opts->seeds[0] = 0;
+    opts->nseeds = 1;
+    opts->max_weight = 100;
+    opts->reps = 10;
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (opt) {
+        case 'k': {
+            opts->nkinds = 0;
+            char *list = strdup(optarg);
+            for (char *name = strtok(list, ","); name != NULL;
+                    name = strtok(NULL, ",")) {
+                if (opts->nkinds == NKINDS
+                        || !pq_kind_named(name, &opts->kinds[opts->nkinds])) {
+                    fprintf(stderr, "unknown queue: %s\n", name);
+                    free(list);
+                    return false;
+                }
+                opts->nkinds += 1;
+            }
+            free(list);
+            break;
+        }
+        case 'n': opts->nsizes = parse_list(optarg, opts->sizes); break;
+        case 'b': opts->nbs = parse_list(optarg, opts->bs); break;
+        case 'w': opts->max_weight = atoi(optarg); break;
+        case 's': opts->nseeds = parse_list(optarg, opts->seeds); break;
+        case 'r': opts->reps = atoi(optarg); break;
+        default: return false;
+        }
+    }
+
+    return optind == argc && opts->nkinds > 0 && opts->nsizes > 0
+        && opts->nbs > 0 && opts->nseeds > 0 && opts->reps > 0;
+}
+
+/*
+ * Read a comma separated list of numbers into values.
+ * Returns how many there were, or 0 if any were malformed.
+ */
+static int
+parse_list(char const*list, double *values)
+{
+    int count = 0;
+    while (*list != '\0' && count < MAX_LIST) {
+        char *end;
+        values[count] = strtod(list, &end);
+        if (end == list || (*end != ',' && *end != '\0')) return 0;
+        count += 1;
+        list = (*end == ',') ? end + 1 : end;
+    }
+    return (*list == '\0') ? count : 0;
+}
+
+/*
+ * Generate the graph for the seed, as `pdijkstra` would, and
+ * record the queue operations of Dijkstra's algorithm from
+ * vertex 0 over its CSR form.
+ * Returns false if memory could not be allocated.
+ */
+static bool
+record(unsigned int size, float b, unsigned int max_weight,
+        unsigned int seed, struct trace *trace)
+{
+    memset(trace, 0, sizeof(struct trace));
+    struct matrix *matrix = matrix_create(size, MATRIX_INT);
+    if (matrix == NULL) return false;
+    pgenerate_matrix_seeded(matrix, seed, b, max_weight);
+    struct csr_graph *graph = csr_from_matrix(matrix->weights, size);
+    matrix_destroy(matrix);
+
+    struct pq *pq = pq_create(PQ_BINARY, size);
+    int *distances = malloc(size * sizeof(int));
+    bool *visited = calloc(size, sizeof(bool));
+    // Every edge pushes at most once, and every vertex pops once.
+    trace->ops = (graph != NULL)
+        ? malloc((graph->nedges + 2*(size_t) size) * sizeof(struct op))
+        : NULL;
+    if (pq == NULL || distances == NULL || visited == NULL
+            || trace->ops == NULL) {
+        csr_free(graph);
+        pq_destroy(pq);
+        free(distances);
+        free(visited);
+        free(trace->ops);
+        return false;
+    }
+
+    for (unsigned int v = 0; v < size; v += 1)
+        distances[v] = -1;
+    distances[0] = 0;
+    pq_push(pq, 0, 0);
+    trace->ops[trace->nops] = (struct op) { 0, 0 };
+    trace->nops += 1;
+    trace->inserts += 1;
+    while (!pq_empty(pq)) {
+        const unsigned int v = pq_pop(pq);
+        trace->ops[trace->nops] = (struct op) { PQ_ABSENT, distances[v] };
+        trace->nops += 1;
+        trace->pops += 1;
+        visited[v] = true;
+
+        for (size_t e = graph->offsets[v]; e < graph->offsets[v+1]; e += 1) {
+            const unsigned int w = graph->targets[e];
+            const int distance = distances[v] + graph->weights[e];
+            if (visited[w]) continue;
+            if (distances[w] != -1 && distance >= distances[w]) continue;
+
+            if (distances[w] == -1)
+                trace->inserts += 1;
+            else
+                trace->decreases += 1;
+            distances[w] = distance;
+            pq_push(pq, w, distance);
+            trace->ops[trace->nops] = (struct op) { w, distance };
+            trace->nops += 1;
+        }
+    }
+
+    csr_free(graph);
+    pq_destroy(pq);
+    free(distances);
+    free(visited);
+    return true;
+}
+
+/*
+ * Perform the trace's operations on the empty queue.
+ */
+static void
+replay(struct pq *pq, struct trace const*trace)
+{
+    for (size_t i = 0; i < trace->nops; i += 1) {
+        if (trace->ops[i].v == PQ_ABSENT)
+            pq_pop(pq);
+        else
+            pq_push(pq, trace->ops[i].v, trace->ops[i].key);
+    }
+}
+
+/*
+ * Perform the trace's operations on the empty queue, checking
+ * that each pop's key is the one recorded.
+ */
+static bool
+check(struct pq *pq, struct trace const*trace)
+{
+    bool valid = true;
+    for (size_t i = 0; i < trace->nops; i += 1) {
+        if (trace->ops[i].v != PQ_ABSENT) {
+            pq_push(pq, trace->ops[i].v, trace->ops[i].key);
+        } else {
+            valid = valid && !pq_empty(pq)
+                && pq_min_key(pq) == trace->ops[i].key;
+            if (!pq_empty(pq)) pq_pop(pq);
+        }
+    }
+    return valid && pq_empty(pq);
+}
+
+/*
+ * The median of the values, which are left sorted.
+ */
+static double
+median(double *values, int n)
+{
+    qsort(values, n, sizeof(double), compare_doubles);
+    return values[(n - 1) / 2];
+}
+
+static int
+compare_doubles(void const*a, void const*b)
+{
+    const double x = *(double const*) a, y = *(double const*) b;
+    return (x > y) - (x < y);
+}
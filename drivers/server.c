@@ -0,0 +1,560 @@
+#include <errno.h>
+#include <getopt.h>
+#include <omp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../src/dijkstra.h"
+#include "../src/graphfile.h"
+#include "../src/prnggraph.h"
+#include "../src/sdijkstra.h"
+#include "../src/treecache.h"
+
+#define READ_BUFFER_SIZE (65536)
+#define MAX_LINE (256)
+
+/*
+ * The graph the server answers queries over: a graph file,
+ * mapped, or a generated matrix.
+ */
+struct graph {
+    struct graphfile *file;
+    struct matrix *generated;
+    struct csr_graph const*csr;
+    struct matrix const*matrix;
+    unsigned int size;
+};
+
+/*
+ * A line read from the client, and when it arrived.
+ */
+struct query {
+    enum { QUERY_PATH, QUERY_STATS, QUERY_ERROR } kind;
+    unsigned int source;
+    unsigned int target;
+    double arrival;
+};
+
+/*
+ * Lines from a file descriptor, which can tell whether another
+ * line is ready without waiting for one.
+ */
+struct reader {
+    int fd;
+    bool eof;
+    size_t start;
+    size_t end;
+    char buffer[READ_BUFFER_SIZE];
+};
+
+/*
+ * Everything the server keeps between queries.
+ */
+struct server {
+    struct graph graph;
+    struct treecache *cache;
+    /** One workspace per thread, for running misses. */
+    struct workspace **workspaces;
+    int nthreads;
+    unsigned int batch;
+    struct query *queries;
+    unsigned int *misses;
+    struct tree **miss_trees;
+    /** For writing out each path, target first. */
+    int *hops;
+    unsigned long nqueries;
+    unsigned long hits;
+    double *latencies;
+    size_t nlatencies;
+    size_t latencies_capacity;
+};
+
+static void usage(char const*);
+static bool load_graph(char const*, char const*, struct graph*);
+static bool prepare_server(struct server*, unsigned int, unsigned int, int);
+static void release_server(struct server*);
+static void serve(struct server*, int, FILE*);
+static int serve_socket(struct server*, char const*);
+static bool answer_batch(struct server*, unsigned int, FILE*);
+static void compute_tree(struct server const*, struct workspace*,
+        struct tree*);
+static void print_path(struct server*, struct query const*,
+        struct tree const*, FILE*);
+static void print_stats(struct server*, FILE*);
+static struct query parse_query(char const*, unsigned int, double);
+static int read_line(struct reader*, char*, bool);
+static int compare_doubles(void const*, void const*);
+
+/*
+ * Loads or generates a graph once, then answers a stream of
+ * shortest path queries over it, one "<source> <target>" per line,
+ * from stdin or a local socket.  Each source's shortest path tree
+ * is kept in an LRU cache, and the sources of each batch of queries
+ * which miss are run at once on the worker threads.
+ */
+int
+main(int argc, char **argv)
+{
+    static const struct option long_options[] = {
+        { "file", required_argument, NULL, 'f' },
+        { "generate", required_argument, NULL, 'g' },
+        { "socket", required_argument, NULL, 's' },
+        { "cache", required_argument, NULL, 'c' },
+        { "threads", required_argument, NULL, 't' },
+        { "batch", required_argument, NULL, 'b' },
+        { NULL, 0, NULL, 0 },
+    };
+
+    char const*file = NULL, *generate = NULL, *socket_path = NULL;
+    unsigned int capacity = 64, batch = 64;
+    int nthreads = omp_get_max_threads();
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+        switch (opt) {
+        case 'f': file = optarg; break;
+        case 'g': generate = optarg; break;
+        case 's': socket_path = optarg; break;
+        case 'c': capacity = atoi(optarg); break;
+        case 't': nthreads = atoi(optarg); break;
+        case 'b': batch = atoi(optarg); break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind != argc || (file == NULL) == (generate == NULL)
+            || capacity == 0 || batch == 0 || nthreads <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    omp_set_num_threads(nthreads);
+
+    struct server server;
+    memset(&server, 0, sizeof(struct server));
+    if (!load_graph(file, generate, &server.graph)) return 1;
+    // Every source in a batch must fit in the cache at once.
+    if (!prepare_server(&server, capacity,
+                (batch < capacity) ? batch : capacity, nthreads)) {
+        fprintf(stderr, "couldn't allocate the cache of %u trees\n",
+                capacity);
+        release_server(&server);
+        return 1;
+    }
+    fprintf(stderr, "ready: %u vertices, %u trees cached, %d threads\n",
+            server.graph.size, capacity, nthreads);
+    // A client which goes away should only end its own connection,
+    // with the write failing, rather than the server.
+    signal(SIGPIPE, SIG_IGN);
+
+    if (socket_path != NULL) return serve_socket(&server, socket_path);
+    serve(&server, STDIN_FILENO, stdout);
+    print_stats(&server, stderr);
+    release_server(&server);
+    return 0;
+}
+
+static void
+usage(char const*name)
+{
+    fprintf(stderr,
+            "usage: %s (--file FILE | --generate SIZE,B,MAX_WEIGHT,SEED) "
+            "[options]\n"
+            "  --socket PATH      listen on a local socket instead of "
+            "stdin\n"
+            "  --cache N          shortest path trees to keep (default 64)\n"
+            "  --threads N        worker threads for misses "
+            "(default OpenMP's)\n"
+            "  --batch N          most queries to answer at once "
+            "(default 64)\n"
+            "Each line is either \"<source> <target>\", answered with\n"
+            "\"<source> <target> <distance> <path...>\" or "
+            "\"<source> <target> -1\",\n"
+            "or \"stats\", answered with the hit rate and latencies.\n",
+            name);
+}
+
+/*
+ * Map the graph file, or generate the graph from "size,b,max,seed".
+ * Returns false, having said why, if neither works.
+ */
+static bool
+load_graph(char const*path, char const*generate, struct graph *graph)
+{
+    memset(graph, 0, sizeof(struct graph));
+    if (path != NULL) {
+        graph->file = graphfile_open(path);
+        if (graph->file == NULL) {
+            perror(path);
+            return false;
+        }
+        if (graph->file->kind == GRAPHFILE_CSR) {
+            graph->csr = &graph->file->csr;
+            graph->size = graph->csr->size;
+        } else {
+            graph->matrix = &graph->file->matrix;
+            graph->size = graph->matrix->size;
+        }
+        return true;
+    }
+
+    unsigned int size, max_weight, seed;
+    float b;
+    if (sscanf(generate, "%u,%f,%u,%u", &size, &b, &max_weight, &seed) != 4
+            || size == 0) {
+        fprintf(stderr, "expected --generate SIZE,B,MAX_WEIGHT,SEED\n");
+        return false;
+    }
+    graph->generated = matrix_create(size, matrix_format_for(max_weight));
+    if (graph->generated == NULL) {
+        fprintf(stderr, "couldn't allocate a graph of size %u\n", size);
+        return false;
+    }
+    pset_seed(seed);
+    pgenerate_matrix(graph->generated, b, max_weight);
+    graph->matrix = graph->generated;
+    graph->size = size;
+    return true;
+}
+
+/*
+ * Allocate the cache and the buffers for batches of queries.
+ * Returns false if memory could not be allocated.
+ */
+static bool
+prepare_server(struct server *server, unsigned int capacity,
+        unsigned int batch, int nthreads)
+{
+    const unsigned int size = server->graph.size;
+    server->batch = batch;
+    server->nthreads = nthreads;
+    server->cache = treecache_create(size, capacity);
+    server->workspaces = calloc(nthreads, sizeof(struct workspace*));
+    server->queries = malloc(batch * sizeof(struct query));
+    server->misses = malloc(batch * sizeof(unsigned int));
+    server->miss_trees = malloc(batch * sizeof(struct tree*));
+    server->hops = malloc(size * sizeof(int));
+    if (server->cache == NULL || server->workspaces == NULL
+            || server->queries == NULL || server->misses == NULL
+            || server->miss_trees == NULL || server->hops == NULL)
+        return false;
+
+    for (int t = 0; t < nthreads; t += 1) {
+        server->workspaces[t] = workspace_create(size);
+        if (server->workspaces[t] == NULL) return false;
+    }
+    return true;
+}
+
+/*
+ * Release the server's graph, cache and buffers.
+ */
+static void
+release_server(struct server *server)
+{
+    if (server->workspaces != NULL)
+        for (int t = 0; t < server->nthreads; t += 1)
+            workspace_destroy(server->workspaces[t]);
+    free(server->workspaces);
+    treecache_destroy(server->cache);
+    free(server->queries);
+    free(server->misses);
+    free(server->miss_trees);
+    free(server->hops);
+    free(server->latencies);
+    graphfile_close(server->graph.file);
+    matrix_destroy(server->graph.generated);
+}
+
+/*
+ * Answer the queries from the file descriptor until it's closed,
+ * or until the answers can't be written.
+ *
+ * A batch is whatever queries have already arrived, up to the batch
+ * size: the first is waited for, the rest only taken if they're
+ * ready, so a lone interactive query is answered straight away and
+ * a stream of them is answered a batch at a time.
+ */
+static void
+serve(struct server *server, int fd, FILE *out)
+{
+    struct reader *reader = malloc(sizeof(struct reader));
+    if (reader == NULL) return;
+    reader->fd = fd;
+    reader->eof = false;
+    reader->start = 0;
+    reader->end = 0;
+
+    char line[MAX_LINE];
+    for (;;) {
+        unsigned int count = 0;
+        int status = read_line(reader, line, true);
+        while (status == 1) {
+            server->queries[count] = parse_query(line, server->graph.size,
+                    omp_get_wtime());
+            count += 1;
+            if (count == server->batch) break;
+            status = read_line(reader, line, false);
+        }
+
+        if (count > 0 && !answer_batch(server, count, out)) break;
+        if (status == -1) break;
+    }
+    free(reader);
+}
+
+/*
+ * Listen on a local socket at the path, answering each connection's
+ * queries in turn, and reporting the stats so far after each.
+ * Only returns on failure.
+ */
+static int
+serve_socket(struct server *server, char const*path)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "socket path too long: %s\n", path);
+        return 1;
+    }
+    strcpy(address.sun_path, path);
+
+    const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if (listener == -1
+            || bind(listener, (struct sockaddr*) &address, sizeof(address)) != 0
+            || listen(listener, 16) != 0) {
+        perror(path);
+        return 1;
+    }
+
+    for (;;) {
+        const int connection = accept(listener, NULL, NULL);
+        if (connection == -1) {
+            if (errno == EINTR) continue;
+            perror("accept");
+            return 1;
+        }
+        FILE *out = fdopen(dup(connection), "w");
+        if (out != NULL) {
+            serve(server, connection, out);
+            fclose(out);
+        }
+        close(connection);
+        print_stats(server, stderr);
+    }
+}
+
+/*
+ * Answer a batch of queries, in order.
+ *
+ * First every query's source is looked up, and the distinct
+ * sources which miss get slots in the cache; the batch is no
+ * bigger than the cache, so that evicts none of the batch's own
+ * trees.  Then the misses' trees are computed in parallel, and
+ * finally each query is answered from its tree.  Returns false if
+ * the answers couldn't be written, e.g. as the client went away.
+ */
+static bool
+answer_batch(struct server *server, unsigned int count, FILE *out)
+{
+    unsigned int nmisses = 0;
+    for (unsigned int i = 0; i < count; i += 1) {
+        struct query const*const query = &server->queries[i];
+        if (query->kind != QUERY_PATH) continue;
+        server->nqueries += 1;
+        if (treecache_find(server->cache, query->source) != NULL) {
+            // Including those which missed earlier in the batch.
+            server->hits += 1;
+            continue;
+        }
+        server->misses[nmisses] = query->source;
+        server->miss_trees[nmisses] = treecache_insert(server->cache,
+                query->source);
+        nmisses += 1;
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (unsigned int m = 0; m < nmisses; m += 1)
+        compute_tree(server, server->workspaces[omp_get_thread_num()],
+                server->miss_trees[m]);
+
+    // Every answer is ready now; count them before any "stats".
+    const double now = omp_get_wtime();
+    for (unsigned int i = 0; i < count; i += 1) {
+        if (server->queries[i].kind != QUERY_PATH) continue;
+        if (server->nlatencies == server->latencies_capacity) {
+            const size_t capacity = (server->latencies_capacity > 0)
+                ? 2 * server->latencies_capacity : 1024;
+            double *latencies = realloc(server->latencies,
+                    capacity * sizeof(double));
+            if (latencies == NULL) break;
+            server->latencies = latencies;
+            server->latencies_capacity = capacity;
+        }
+        server->latencies[server->nlatencies] =
+            now - server->queries[i].arrival;
+        server->nlatencies += 1;
+    }
+
+    for (unsigned int i = 0; i < count; i += 1) {
+        struct query const*const query = &server->queries[i];
+        switch (query->kind) {
+        case QUERY_PATH:
+            print_path(server, query,
+                    treecache_find(server->cache, query->source), out);
+            break;
+        case QUERY_STATS:
+            print_stats(server, out);
+            break;
+        default:
+            fprintf(out, "error: expected \"<source> <target>\" with both "
+                    "less than %u, or \"stats\"\n", server->graph.size);
+            break;
+        }
+    }
+    return fflush(out) == 0;
+}
+
+/*
+ * Find the shortest path tree from the tree's source, with
+ * `sdijkstra` for CSR graphs or `dijkstra` for matrices.
+ */
+static void
+compute_tree(struct server const*server, struct workspace *ws,
+        struct tree *tree)
+{
+    struct graph const*const graph = &server->graph;
+    if (graph->csr != NULL) {
+        sdijkstra_with(ws, graph->csr, tree->source, tree->paths);
+        sdijkstra_distances(ws, graph->size, tree->distances);
+    } else {
+        dijkstra_matrix(ws, graph->matrix, tree->source, tree->paths);
+        dijkstra_distances(ws, graph->size, tree->distances);
+    }
+}
+
+/*
+ * Write the query's distance and path, from the source to the
+ * target, or -1 if there's no path.
+ */
+static void
+print_path(struct server *server, struct query const*query,
+        struct tree const*tree, FILE *out)
+{
+    const int distance = tree->distances[query->target];
+    fprintf(out, "%u %u %d", query->source, query->target, distance);
+    if (distance != -1) {
+        unsigned int nhops = 0;
+        for (unsigned int v = query->target; v != query->source;
+                v = tree->paths[v]) {
+            server->hops[nhops] = v;
+            nhops += 1;
+        }
+        fprintf(out, " %u", query->source);
+        while (nhops > 0) {
+            nhops -= 1;
+            fprintf(out, " %d", server->hops[nhops]);
+        }
+    }
+    fputc('\n', out);
+}
+
+/*
+ * Write the number of queries, the hit rate, and the 50th, 95th
+ * and 99th percentile and worst latencies from arrival to answer.
+ */
+static void
+print_stats(struct server *server, FILE *out)
+{
+    const size_t n = server->nlatencies;
+    double percentiles[4] = { 0, 0, 0, 0 };
+    double *sorted = malloc((n ? n : 1) * sizeof(double));
+    if (sorted != NULL && n > 0) {
+        memcpy(sorted, server->latencies, n * sizeof(double));
+        qsort(sorted, n, sizeof(double), compare_doubles);
+        const double ps[4] = { 0.5, 0.95, 0.99, 1.0 };
+        for (int i = 0; i < 4; i += 1) {
+            size_t rank = (size_t) (ps[i] * n + 0.999999);
+            percentiles[i] = sorted[(rank > 0) ? rank - 1 : 0];
+        }
+    }
+    free(sorted);
+
+    fprintf(out, "queries %lu hits %lu hit_rate %.3f latency_ms "
+            "p50 %.3f p95 %.3f p99 %.3f max %.3f\n",
+            server->nqueries, server->hits,
+            (server->nqueries > 0)
+                ? (double) server->hits / server->nqueries : 0,
+            percentiles[0] * 1e3, percentiles[1] * 1e3,
+            percentiles[2] * 1e3, percentiles[3] * 1e3);
+}
+
+/*
+ * Parse a line of input into a query.
+ */
+static struct query
+parse_query(char const*line, unsigned int size, double arrival)
+{
+    struct query query = { QUERY_ERROR, 0, 0, arrival };
+    char rest;
+    if (strncmp(line, "stats", 5) == 0) {
+        query.kind = QUERY_STATS;
+    } else if (sscanf(line, "%u %u %c", &query.source, &query.target,
+                &rest) == 2
+            && query.source < size && query.target < size) {
+        query.kind = QUERY_PATH;
+    }
+    return query;
+}
+
+/*
+ * Read the next line into the buffer of `MAX_LINE` chars, without
+ * its newline, waiting for one if `wait`.  Longer lines are cut.
+ * Returns 1 for a line, 0 if none was ready, or -1 at the end.
+ */
+static int
+read_line(struct reader *reader, char *line, bool wait)
+{
+    for (;;) {
+        char *const start = reader->buffer + reader->start;
+        char *const newline = memchr(start, '\n', reader->end - reader->start);
+        const bool full = (reader->start == 0
+                && reader->end == READ_BUFFER_SIZE);
+        if (newline != NULL || full
+                || (reader->eof && reader->end > reader->start)) {
+            const size_t length = (newline != NULL)
+                ? (size_t) (newline - start) : reader->end - reader->start;
+            const size_t kept = (length < MAX_LINE - 1) ? length : MAX_LINE - 1;
+            memcpy(line, start, kept);
+            line[kept] = '\0';
+            reader->start += length + (newline != NULL);
+            return 1;
+        }
+        if (reader->eof) return -1;
+
+        if (!wait) {
+            struct pollfd ready = { reader->fd, POLLIN, 0 };
+            if (poll(&ready, 1, 0) <= 0) return 0;
+        }
+
+        memmove(reader->buffer, start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+        const ssize_t nread = read(reader->fd, reader->buffer + reader->end,
+                READ_BUFFER_SIZE - reader->end);
+        if (nread < 0 && errno == EINTR) continue;
+        if (nread <= 0) reader->eof = true;
+        else reader->end += nread;
+    }
+}
+
+static int
+compare_doubles(void const*a, void const*b)
+{
+    const double x = *(double const*) a, y = *(double const*) b;
+    return (x > y) - (x < y);
+}
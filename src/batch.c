@@ -0,0 +1,81 @@
+#include "batch.h"
+#include "dijkstra.h"
+#include "sdijkstra.h"
+
+/*
+ * Applies Dijkstra's algorithm to the input graph from each of
+ * the specified sources, one source per thread at a time.
+ *
+ * Parallelisation: the sources are handed out to the threads
+ * dynamically, since runs from different sources can reach very
+ * different numbers of vertices.  Each thread allocates one
+ * workspace for all of its runs, and writes only its sources'
+ * rows of the output.  Every thread must still take part in the
+ * loop, so a thread without a workspace skips the sources it's
+ * handed, and the batch fails.
+ */
+bool
+batch_dijkstra(int const*edges, unsigned int size,
+        unsigned int const*sources, unsigned int nsources,
+        int *paths, int *distances)
+{
+    if (sources == NULL) nsources = size;
+    bool failed = false;
+
+#pragma omp parallel
+    {
+        struct workspace *ws = workspace_create(size);
+        if (ws == NULL) {
+#pragma omp atomic write
+            failed = true;
+        }
+
+#pragma omp for schedule(dynamic)
+        for (unsigned int i = 0; i < nsources; i += 1) {
+            if (ws == NULL) continue;
+            const unsigned int source = (sources == NULL) ? i : sources[i];
+            dijkstra_with(ws, edges, size, source, paths + (size_t) i*size);
+            if (distances != NULL)
+                dijkstra_distances(ws, size, distances + (size_t) i*size);
+        }
+
+        workspace_destroy(ws);
+    }
+    return !failed;
+}
+
+/*
+ * Applies `sdijkstra` to the input graph from each of the
+ * specified sources, one source per thread at a time.
+ *
+ * Parallelised the same way as `batch_dijkstra`.
+ */
+bool
+batch_sdijkstra(struct csr_graph const*graph, unsigned int const*sources,
+        unsigned int nsources, int *paths, int *distances)
+{
+    const unsigned int size = graph->size;
+    if (sources == NULL) nsources = size;
+    bool failed = false;
+
+#pragma omp parallel
+    {
+        struct workspace *ws = workspace_create(size);
+        if (ws == NULL) {
+#pragma omp atomic write
+            failed = true;
+        }
+
+#pragma omp for schedule(dynamic)
+        for (unsigned int i = 0; i < nsources; i += 1) {
+            if (ws == NULL) continue;
+            const unsigned int source = (sources == NULL) ? i : sources[i];
+            sdijkstra_with(ws, graph, source, paths + (size_t) i*size);
+            if (distances != NULL)
+                sdijkstra_distances(ws, size, distances + (size_t) i*size);
+        }
+
+        workspace_destroy(ws);
+    }
+    return !failed;
+}
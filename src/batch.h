@@ -0,0 +1,82 @@
+#ifndef batch_H
+#define batch_H
+
+/**
+ * @file
+ * Shortest paths from many sources over the same graph,
+ * running the sources in parallel.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "csrgraph.h"
+
+/**
+ * Applies Dijkstra's algorithm to the input graph from each of
+ * the specified sources, one source per thread at a time.
+ *
+ * Each thread runs the serial `dijkstra` with its own workspace,
+ * so this uses the threads better than `pdijkstra` whenever there
+ * are at least as many sources as threads.
+ *
+ * @param edges  a buffer containing a matrix of edge weights.
+ * `edges[v*size + w]` should be the weight of the edge from
+ * the vertex v to the vertex w, with -1 meaning no edge.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * @param sources  the ids of the sources, each less than size;
+ * or NULL to use every vertex as a source, in order.
+ *
+ * @param nsources  the number of sources; ignored if sources
+ * is NULL.
+ *
+ * @param paths  the buffer in which to place the paths; `size`
+ * entries per source, with `paths[i*size + w]` being w's
+ * predecessor on the paths from the `i`th source.
+ *
+ * @param distances  the buffer in which to place the distances,
+ * laid out like the paths, with -1 meaning no path; or NULL
+ * if they aren't needed.
+ *
+ * @return false if a thread's workspace could not be allocated,
+ * in which case the paths from some sources are left as they were.
+ */
+bool batch_dijkstra(int const* edges,
+                    unsigned int size,
+                    unsigned int const* sources,
+                    unsigned int nsources,
+                    int * paths,
+                    int * distances);
+
+/**
+ * Applies `sdijkstra` to the input graph from each of the
+ * specified sources, one source per thread at a time.
+ *
+ * @param graph  the graph, in compressed sparse row form.
+ *
+ * @param sources  the ids of the sources, each less than the
+ * graph's size; or NULL to use every vertex as a source.
+ *
+ * @param nsources  the number of sources; ignored if sources
+ * is NULL.
+ *
+ * @param paths  the buffer in which to place the paths, as for
+ * `batch_dijkstra`.
+ *
+ * @param distances  the buffer in which to place the distances,
+ * as for `batch_dijkstra`; or NULL.
+ *
+ * @return false if a thread's workspace could not be allocated,
+ * as for `batch_dijkstra`.
+ */
+bool batch_sdijkstra(struct csr_graph const* graph,
+                     unsigned int const* sources,
+                     unsigned int nsources,
+                     int * paths,
+                     int * distances);
+
+#endif // batch_H
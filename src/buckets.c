@@ -0,0 +1,126 @@
+#include "buckets.h"
+
+static inline void link(struct buckets*, unsigned int);
+static inline void unlink(struct buckets*, unsigned int);
+
+/*
+ * Creates an empty queue for the vertex ids less than capacity,
+ * and keys spread over at most max_weight.
+ */
+struct buckets *
+buckets_create(unsigned int capacity, unsigned int max_weight)
+{
+    struct buckets *buckets = malloc(sizeof(struct buckets));
+    if (buckets == NULL) return NULL;
+
+    buckets->capacity = capacity;
+    buckets->nbuckets = max_weight + 1;
+    buckets->count = 0;
+    buckets->current = 0;
+    buckets->heads = malloc(buckets->nbuckets * sizeof(unsigned int));
+    buckets->next = malloc(capacity * sizeof(unsigned int));
+    buckets->prev = malloc(capacity * sizeof(unsigned int));
+    buckets->keys = malloc(capacity * sizeof(int));
+    if (buckets->heads == NULL || buckets->next == NULL
+            || buckets->prev == NULL || buckets->keys == NULL) {
+        buckets_destroy(buckets);
+        return NULL;
+    }
+
+    for (unsigned int i = 0; i < buckets->nbuckets; i += 1)
+        buckets->heads[i] = BUCKETS_NONE;
+    for (unsigned int v = 0; v < capacity; v += 1)
+        buckets->keys[v] = -1;
+    return buckets;
+}
+
+/*
+ * Releases a queue created by `buckets_create`.
+ */
+void
+buckets_destroy(struct buckets *buckets)
+{
+    if (buckets == NULL) return;
+    free(buckets->heads);
+    free(buckets->next);
+    free(buckets->prev);
+    free(buckets->keys);
+    free(buckets);
+}
+
+/*
+ * Starts a new run from an empty queue, with keys from 0.
+ */
+void
+buckets_begin(struct buckets *buckets)
+{
+    buckets->current = 0;
+}
+
+/*
+ * Inserts the vertex v with the specified key, or lowers
+ * its key if it is already in the queue.
+ */
+void
+buckets_push(struct buckets *buckets, unsigned int v, int key)
+{
+    if (buckets->keys[v] != -1) {
+        unlink(buckets, v);
+    } else {
+        buckets->count += 1;
+    }
+    buckets->keys[v] = key;
+    link(buckets, v);
+}
+
+/*
+ * Removes and returns a vertex with the smallest key.
+ * The queue must not be empty.
+ *
+ * Skips ahead over the empty buckets from the last key popped;
+ * each key is only skipped once per run.
+ */
+unsigned int
+buckets_pop(struct buckets *buckets)
+{
+    unsigned int bucket = buckets->current % buckets->nbuckets;
+    while (buckets->heads[bucket] == BUCKETS_NONE) {
+        buckets->current += 1;
+        bucket = (bucket + 1 < buckets->nbuckets) ? bucket + 1 : 0;
+    }
+
+    const unsigned int v = buckets->heads[bucket];
+    unlink(buckets, v);
+    buckets->keys[v] = -1;
+    buckets->count -= 1;
+    return v;
+}
+
+/*
+ * Put the vertex v at the front of the bucket for its key.
+ */
+static inline void
+link(struct buckets *buckets, unsigned int v)
+{
+    const unsigned int bucket = buckets->keys[v] % buckets->nbuckets;
+    const unsigned int head = buckets->heads[bucket];
+    buckets->next[v] = head;
+    buckets->prev[v] = BUCKETS_NONE;
+    if (head != BUCKETS_NONE) buckets->prev[head] = v;
+    buckets->heads[bucket] = v;
+}
+
+/*
+ * Take the vertex v out of the bucket for its key.
+ */
+static inline void
+unlink(struct buckets *buckets, unsigned int v)
+{
+    const unsigned int next = buckets->next[v];
+    const unsigned int prev = buckets->prev[v];
+    if (prev != BUCKETS_NONE)
+        buckets->next[prev] = next;
+    else
+        buckets->heads[buckets->keys[v] % buckets->nbuckets] = next;
+    if (next != BUCKETS_NONE) buckets->prev[next] = prev;
+}
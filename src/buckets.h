@@ -0,0 +1,94 @@
+#ifndef buckets_H
+#define buckets_H
+
+/**
+ * @file
+ * Bucket queue of vertices keyed by integer distance (Dial's),
+ * for graphs whose edge weights are small integers.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * A monotone priority queue over the vertex ids `0` to
+ * `capacity - 1`, keyed by non-negative integers.
+ *
+ * Every key in the queue is within `max_weight` of the smallest,
+ * as in Dijkstra's algorithm with edge weights at most that, so
+ * a circular array of `max_weight + 1` buckets, each a doubly
+ * linked list of the vertices with that key, holds them all.
+ * Pushing, lowering a key and popping are O(1), plus O(max_weight)
+ * to skip empty buckets over the whole of each pop's advance.
+ *
+ * Vertices with the same key come out most recently pushed first.
+ */
+struct buckets {
+    /** The number of vertex ids the queue can hold. */
+    unsigned int capacity;
+    /** The number of buckets; one more than the largest weight. */
+    unsigned int nbuckets;
+    /** The number of vertices currently in the queue. */
+    unsigned int count;
+    /** The smallest key any vertex in the queue can have. */
+    int current;
+    /** The first vertex of each bucket, or `BUCKETS_NONE`. */
+    unsigned int *heads;
+    /** Each vertex's neighbours in its bucket, or `BUCKETS_NONE`. */
+    unsigned int *next;
+    unsigned int *prev;
+    /** Each vertex's key, or -1 if it isn't in the queue. */
+    int *keys;
+};
+
+/** The end of a bucket's list. */
+#define BUCKETS_NONE (UINT_MAX)
+
+/**
+ * Creates an empty queue for the vertex ids less than capacity,
+ * and keys spread over at most max_weight.
+ *
+ * @return the new queue, to be released with `buckets_destroy`,
+ * or NULL if memory could not be allocated.
+ */
+struct buckets *buckets_create(unsigned int capacity, unsigned int max_weight);
+
+/**
+ * Releases a queue created by `buckets_create`.
+ */
+void buckets_destroy(struct buckets *buckets);
+
+/**
+ * Starts a new run from an empty queue, with keys from 0.
+ */
+void buckets_begin(struct buckets *buckets);
+
+/**
+ * Inserts the vertex v with the specified key, or lowers
+ * its key if it is already in the queue.
+ *
+ * @param v  the vertex; less than the queue's capacity.
+ *
+ * @param key  the new key; at least the last key popped, at
+ * most `max_weight` more than it, and if v is already in the
+ * queue, no greater than its current key.
+ */
+void buckets_push(struct buckets *buckets, unsigned int v, int key);
+
+/**
+ * Removes and returns a vertex with the smallest key.
+ * The queue must not be empty.
+ */
+unsigned int buckets_pop(struct buckets *buckets);
+
+/**
+ * Checks whether the queue has no vertices in it.
+ */
+static inline bool
+buckets_empty(struct buckets const*buckets)
+{
+    return buckets->count == 0;
+}
+
+#endif // buckets_H
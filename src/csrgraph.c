@@ -0,0 +1,207 @@
+#include "csrgraph.h"
+
+static struct csr_graph *csr_alloc(unsigned int, size_t*);
+static int compare_edges(void const*, void const*);
+
+/*
+ * Builds a CSR graph from a weighted adjacency matrix.
+ *
+ * @param edges  a buffer containing a matrix of edge weights.
+ * `edges[v*size + w]` should be the weight of the edge from
+ * the vertex v to the vertex w, with -1 meaning no edge.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * Rows are counted and then copied in parallel; the offsets
+ * are a serial prefix sum over the row counts in between.
+ */
+struct csr_graph *
+csr_from_matrix(int const*edges, unsigned int size)
+{
+    size_t *counts = malloc((size + 1) * sizeof(size_t));
+    if (counts == NULL) return NULL;
+
+#pragma omp parallel for schedule(static)
+    for (unsigned int v = 0; v < size; v += 1) {
+        size_t count = 0;
+        for (unsigned int w = 0; w < size; w += 1)
+            if (edges[(size_t) v*size + w] != -1) count += 1;
+        counts[v] = count;
+    }
+
+    size_t nedges = 0;
+    for (unsigned int v = 0; v < size; v += 1) {
+        const size_t count = counts[v];
+        counts[v] = nedges;
+        nedges += count;
+    }
+    counts[size] = nedges;
+
+    struct csr_graph *graph = csr_alloc(size, counts);
+    if (graph == NULL) return NULL;
+
+#pragma omp parallel for schedule(static)
+    for (unsigned int v = 0; v < size; v += 1) {
+        size_t e = graph->offsets[v];
+        for (unsigned int w = 0; w < size; w += 1) {
+            const int weight = edges[(size_t) v*size + w];
+            if (weight == -1) continue;
+            graph->targets[e] = w;
+            graph->weights[e] = weight;
+            e += 1;
+        }
+    }
+
+    return graph;
+}
+
+/*
+ * Builds the transpose of a CSR graph, with every edge reversed.
+ *
+ * Edges are counted by target, then copied in order of source,
+ * which keeps each of the transpose's rows in ascending order
+ * of target too.  Both passes are serial, being O(E) anyway.
+ */
+struct csr_graph *
+csr_transpose(struct csr_graph const*graph)
+{
+    const unsigned int size = graph->size;
+    size_t *counts = calloc((size_t) size + 1, sizeof(size_t));
+    if (counts == NULL) return NULL;
+
+    for (size_t e = 0; e < graph->nedges; e += 1)
+        counts[graph->targets[e]] += 1;
+
+    size_t nedges = 0;
+    for (unsigned int v = 0; v < size; v += 1) {
+        const size_t count = counts[v];
+        counts[v] = nedges;
+        nedges += count;
+    }
+    counts[size] = nedges;
+
+    size_t *next = malloc(((size_t) size + 1) * sizeof(size_t));
+    struct csr_graph *transpose = csr_alloc(size, counts);
+    if (transpose == NULL || next == NULL) {
+        csr_free(transpose);
+        free(next);
+        return NULL;
+    }
+    memcpy(next, transpose->offsets, ((size_t) size + 1) * sizeof(size_t));
+
+    for (unsigned int v = 0; v < size; v += 1) {
+        for (size_t e = graph->offsets[v]; e < graph->offsets[v+1]; e += 1) {
+            const size_t r = next[graph->targets[e]];
+            next[graph->targets[e]] += 1;
+            transpose->targets[r] = v;
+            transpose->weights[r] = graph->weights[e];
+        }
+    }
+
+    free(next);
+    return transpose;
+}
+
+/*
+ * Builds a copy of a CSR graph with its vertices renumbered.
+ *
+ * Each edge is packed into 64 bits, its new target above its
+ * weight, so that sorting a row's packed edges puts them in
+ * order of target; the rows are copied and sorted in parallel.
+ */
+struct csr_graph *
+csr_permute(struct csr_graph const*graph, unsigned int const*rank)
+{
+    const unsigned int size = graph->size;
+    size_t *counts = malloc(((size_t) size + 1) * sizeof(size_t));
+    if (counts == NULL) return NULL;
+
+    for (unsigned int v = 0; v < size; v += 1)
+        counts[rank[v]] = graph->offsets[v+1] - graph->offsets[v];
+    size_t nedges = 0;
+    for (unsigned int v = 0; v < size; v += 1) {
+        const size_t count = counts[v];
+        counts[v] = nedges;
+        nedges += count;
+    }
+    counts[size] = nedges;
+
+    uint64_t *packed = malloc((nedges + 1) * sizeof(uint64_t));
+    struct csr_graph *permuted = csr_alloc(size, counts);
+    if (permuted == NULL || packed == NULL) {
+        csr_free(permuted);
+        free(packed);
+        return NULL;
+    }
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (unsigned int v = 0; v < size; v += 1) {
+        const size_t start = permuted->offsets[rank[v]];
+        const size_t count = graph->offsets[v+1] - graph->offsets[v];
+        uint64_t *const row = packed + start;
+        for (size_t i = 0; i < count; i += 1) {
+            const size_t e = graph->offsets[v] + i;
+            row[i] = (uint64_t) rank[graph->targets[e]] << 32
+                | (uint32_t) graph->weights[e];
+        }
+        qsort(row, count, sizeof(uint64_t), compare_edges);
+        for (size_t i = 0; i < count; i += 1) {
+            permuted->targets[start + i] = row[i] >> 32;
+            permuted->weights[start + i] = (int) (uint32_t) row[i];
+        }
+    }
+
+    free(packed);
+    return permuted;
+}
+
+/*
+ * Releases a graph created by `csr_from_matrix`,
+ * `csr_transpose` or `csr_permute`.
+ */
+void
+csr_free(struct csr_graph *graph)
+{
+    if (graph == NULL) return;
+    free(graph->offsets);
+    free(graph->targets);
+    free(graph->weights);
+    free(graph);
+}
+
+/*
+ * Allocate a graph around the specified offsets, with room
+ * for `offsets[size]` edges.  The graph takes ownership of
+ * `offsets`, which is released if allocation fails.
+ * Returns NULL if any of the buffers can't be allocated.
+ */
+static struct csr_graph *
+csr_alloc(unsigned int size, size_t *offsets)
+{
+    struct csr_graph *graph = malloc(sizeof(struct csr_graph));
+    if (graph == NULL) {
+        free(offsets);
+        return NULL;
+    }
+
+    const size_t nedges = offsets[size];
+    graph->size = size;
+    graph->nedges = nedges;
+    graph->offsets = offsets;
+    // Keep the edge buffers non-NULL for edgeless graphs.
+    graph->targets = malloc((nedges + 1) * sizeof(unsigned int));
+    graph->weights = malloc((nedges + 1) * sizeof(int));
+
+    if (graph->targets == NULL || graph->weights == NULL) {
+        csr_free(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+static int
+compare_edges(void const*a, void const*b)
+{
+    const uint64_t x = *(uint64_t const*) a, y = *(uint64_t const*) b;
+    return (x > y) - (x < y);
+}
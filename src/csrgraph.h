@@ -0,0 +1,79 @@
+#ifndef csrgraph_H
+#define csrgraph_H
+
+/**
+ * @file
+ * Compressed sparse row representation of weighted graphs,
+ * for graphs where most vertex pairs have no edge.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * A weighted directed graph in compressed sparse row form.
+ *
+ * The edges leaving the vertex v are stored at the indices
+ * `offsets[v]` (inclusive) to `offsets[v+1]` (exclusive) of
+ * `targets` and `weights`, in ascending order of target.
+ */
+struct csr_graph {
+    /** The number of vertices in the graph. */
+    unsigned int size;
+    /** The number of edges in the graph. */
+    size_t nedges;
+    /** Start of each vertex's edges; `size + 1` entries. */
+    size_t *offsets;
+    /** Destination vertex of each edge; `nedges` entries. */
+    unsigned int *targets;
+    /** Non-negative weight of each edge; `nedges` entries. */
+    int *weights;
+};
+
+/**
+ * Builds a CSR graph from a weighted adjacency matrix.
+ *
+ * @param edges  a buffer containing a matrix of edge weights.
+ * `edges[v*size + w]` should be the weight of the edge from
+ * the vertex v to the vertex w, with -1 meaning no edge.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * @return the new graph, to be released with `csr_free`,
+ * or NULL if memory could not be allocated.
+ */
+struct csr_graph *csr_from_matrix(int const* edges, unsigned int size);
+
+/**
+ * Builds the transpose of a CSR graph, with every edge reversed,
+ * so that the edges leaving a vertex in the transpose are those
+ * which arrive at it in the original.
+ *
+ * @return the new graph, to be released with `csr_free`,
+ * or NULL if memory could not be allocated.
+ */
+struct csr_graph *csr_transpose(struct csr_graph const* graph);
+
+/**
+ * Builds a copy of a CSR graph with its vertices renumbered,
+ * each vertex's edges still in ascending order of target.
+ *
+ * @param rank  the new id of each vertex: a permutation of
+ * `0` to `size - 1`.
+ *
+ * @return the new graph, to be released with `csr_free`,
+ * or NULL if memory could not be allocated.
+ */
+struct csr_graph *csr_permute(struct csr_graph const* graph,
+        unsigned int const* rank);
+
+/**
+ * Releases a graph created by `csr_from_matrix`,
+ * `csr_transpose` or `csr_permute`.
+ */
+void csr_free(struct csr_graph *graph);
+
+#endif // csrgraph_H
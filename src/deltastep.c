@@ -0,0 +1,313 @@
+#include <omp.h>
+
+#include "deltastep.h"
+
+/*
+ * A growable list of vertices, private to one thread.
+ */
+struct bucket {
+    unsigned int *items;
+    size_t count;
+    size_t capacity;
+};
+
+/*
+ * The state of a delta-stepping run.
+ *
+ * Each vertex's tentative distance and predecessor are packed
+ * into one word, distance high, so that both can be lowered
+ * together by a single compare-and-swap.
+ *
+ * Each thread has its own ring of `nbuckets` buckets, indexed
+ * by bucket number modulo `nbuckets`; since no edge is longer
+ * than `max_weight`, every live bucket fits in the ring.
+ */
+struct run {
+    struct csr_graph const*graph;
+    int delta;
+    uint64_t *tentative;
+    int nthreads;
+    size_t nbuckets;
+    struct bucket *buckets;  // nthreads * nbuckets
+    unsigned int *frontier;
+    unsigned int *settled;
+    unsigned int *frontier_marks;
+    unsigned int *settled_marks;
+    /** Set if any thread couldn't grow one of its buckets. */
+    bool failed;
+};
+
+#define UNREACHED (UINT64_MAX)
+
+static inline uint64_t pack(int, unsigned int);
+static inline int max_weight(struct csr_graph const*);
+static inline void relax(struct run*, unsigned int, int, unsigned int);
+static inline bool push(struct bucket*, unsigned int);
+static inline size_t next_bucket(struct run const*, size_t, bool*);
+static size_t gather(struct run*, size_t, unsigned int);
+static void release(struct run*);
+
+/*
+ * Finds the shortest paths from the specified source using
+ * the delta-stepping algorithm, in parallel.
+ *
+ * @param graph  the graph, in compressed sparse row form.
+ *
+ * @param source  the id of the node to use as the source for the
+ * algorithm; non-negative, less than the graph's size.
+ *
+ * @param delta  the bucket width; positive, or zero to use
+ * `delta_stepping_default_delta`.
+ *
+ * @param paths  the buffer in which to place the paths.
+ *
+ * @return false if memory could not be allocated.
+ *
+ * Parallelisation:
+ *
+ *  1. Relaxations of one phase are spread over the threads
+ *     dynamically, by source vertex.  Tentative distances are
+ *     lowered with compare-and-swap, and each thread queues the
+ *     vertices it improves in its own buckets.
+ *  2. Between phases, the threads' copies of the current bucket
+ *     are gathered into one frontier, dropping vertices which
+ *     have since moved to a lower bucket, and duplicates.
+ */
+bool
+delta_stepping(struct csr_graph const*graph, unsigned int source, int delta,
+        int *paths)
+{
+    const unsigned int size = graph->size;
+    if (delta <= 0) delta = delta_stepping_default_delta(graph);
+
+    struct run run;
+    run.graph = graph;
+    run.delta = delta;
+    run.nthreads = omp_get_max_threads();
+    run.nbuckets = (size_t) max_weight(graph) / delta + 2;
+    run.tentative = malloc(size * sizeof(uint64_t));
+    run.buckets = calloc(run.nthreads * run.nbuckets, sizeof(struct bucket));
+    run.frontier = malloc(size * sizeof(unsigned int));
+    run.settled = malloc(size * sizeof(unsigned int));
+    run.frontier_marks = calloc(size, sizeof(unsigned int));
+    run.settled_marks = calloc(size, sizeof(unsigned int));
+    run.failed = false;
+    if (run.tentative == NULL || run.buckets == NULL || run.frontier == NULL
+            || run.settled == NULL || run.frontier_marks == NULL
+            || run.settled_marks == NULL) {
+        release(&run);
+        return false;
+    }
+
+#pragma omp parallel for schedule(static)
+    for (unsigned int v = 0; v < size; v += 1)
+        run.tentative[v] = UNREACHED;
+    run.tentative[source] = pack(0, source);
+    if (!push(&run.buckets[0], source)) {
+        release(&run);
+        return false;
+    }
+
+    // Marks are the phase number plus one, so zero is never current.
+    unsigned int phase = 0;
+    size_t current = 0;
+    bool found;
+    for (current = next_bucket(&run, current, &found); found && !run.failed;
+            current = next_bucket(&run, current, &found)) {
+        size_t nsettled = 0;
+
+        // Empty the current bucket through its light edges.
+        for (;;) {
+            phase += 1;
+            const size_t nfrontier = gather(&run, current, phase);
+            if (nfrontier == 0 || run.failed) break;
+
+            for (size_t i = 0; i < nfrontier; i += 1) {
+                const unsigned int v = run.frontier[i];
+                if (run.settled_marks[v] == (unsigned int) current + 1) continue;
+                run.settled_marks[v] = current + 1;
+                run.settled[nsettled] = v;
+                nsettled += 1;
+            }
+
+#pragma omp parallel for schedule(dynamic, 64)
+            for (size_t i = 0; i < nfrontier; i += 1) {
+                const unsigned int v = run.frontier[i];
+                const int vdistance =
+                __atomic_load_n(&run.tentative[v], __ATOMIC_RELAXED) >> 32;
+                for (size_t e = graph->offsets[v]; e < graph->offsets[v+1]; e += 1)
+                    if (graph->weights[e] <= delta)
+                        relax(&run, graph->targets[e],
+                                vdistance + graph->weights[e], v);
+            }
+        }
+
+        // Then relax the heavy edges of everything it held,
+        // which can only reach later buckets.
+#pragma omp parallel for schedule(dynamic, 64)
+        for (size_t i = 0; i < nsettled; i += 1) {
+            const unsigned int v = run.settled[i];
+            const int vdistance =
+                __atomic_load_n(&run.tentative[v], __ATOMIC_RELAXED) >> 32;
+            for (size_t e = graph->offsets[v]; e < graph->offsets[v+1]; e += 1)
+                if (graph->weights[e] > delta)
+                    relax(&run, graph->targets[e],
+                            vdistance + graph->weights[e], v);
+        }
+    }
+
+    // A vertex dropped from a full bucket may never have been
+    // settled, so the paths can't be trusted.
+    const bool succeeded = !run.failed;
+    if (succeeded) {
+#pragma omp parallel for schedule(static)
+        for (unsigned int v = 0; v < size; v += 1)
+            paths[v] = (run.tentative[v] == UNREACHED)
+                ? -1 : (int) (uint32_t) run.tentative[v];
+    }
+
+    release(&run);
+    return succeeded;
+}
+
+/*
+ * A reasonable bucket width for the graph: the maximum edge
+ * weight over the average out degree, and at least 1.
+ */
+int
+delta_stepping_default_delta(struct csr_graph const*graph)
+{
+    if (graph->nedges == 0) return 1;
+    const double degree = (double) graph->nedges / graph->size;
+    const int delta = max_weight(graph) / degree;
+    return (delta > 0) ? delta : 1;
+}
+
+/*
+ * Pack a distance and predecessor into one word, distance high.
+ */
+static inline uint64_t
+pack(int distance, unsigned int predecessor)
+{
+    return ((uint64_t) distance << 32) | predecessor;
+}
+
+/*
+ * The largest edge weight in the graph, or 0 if it has none.
+ */
+static inline int
+max_weight(struct csr_graph const*graph)
+{
+    int max = 0;
+#pragma omp parallel for reduction(max: max) schedule(static)
+    for (size_t e = 0; e < graph->nedges; e += 1)
+        if (graph->weights[e] > max) max = graph->weights[e];
+    return max;
+}
+
+/*
+ * Lower w's tentative distance to `distance` through v, if
+ * that's an improvement, and queue w in the calling thread's
+ * bucket for its new distance.
+ */
+static inline void
+relax(struct run *run, unsigned int w, int distance, unsigned int v)
+{
+    const uint64_t through_v = pack(distance, v);
+    uint64_t current = __atomic_load_n(&run->tentative[w], __ATOMIC_RELAXED);
+    // Only strictly shorter paths replace the predecessor; letting
+    // ties through could link zero weight cycles into the paths.
+    while ((through_v >> 32) < (current >> 32)) {
+        if (__atomic_compare_exchange_n(&run->tentative[w], &current, through_v,
+                    true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            const size_t b = (size_t) (distance / run->delta) % run->nbuckets;
+            if (!push(&run->buckets[omp_get_thread_num() * run->nbuckets + b],
+                        w))
+                __atomic_store_n(&run->failed, true, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+}
+
+/*
+ * Append v to the bucket, growing it as needed.
+ * Returns false, leaving the bucket as it was, if it can't grow.
+ */
+static inline bool
+push(struct bucket *bucket, unsigned int v)
+{
+    if (bucket->count == bucket->capacity) {
+        const size_t capacity = (bucket->capacity > 0)
+            ? 2 * bucket->capacity : 64;
+        unsigned int *items = realloc(bucket->items,
+                capacity * sizeof(unsigned int));
+        if (items == NULL) return false;
+        bucket->items = items;
+        bucket->capacity = capacity;
+    }
+    bucket->items[bucket->count] = v;
+    bucket->count += 1;
+    return true;
+}
+
+/*
+ * Find the lowest bucket number, from `from` onwards, which
+ * is non-empty for any thread.  Sets `found` to false if
+ * every bucket is empty.
+ */
+static inline size_t
+next_bucket(struct run const*run, size_t from, bool *found)
+{
+    for (size_t b = from; b < from + run->nbuckets; b += 1) {
+        for (int t = 0; t < run->nthreads; t += 1) {
+            if (run->buckets[t * run->nbuckets + b % run->nbuckets].count > 0) {
+                *found = true;
+                return b;
+            }
+        }
+    }
+    *found = false;
+    return from;
+}
+
+/*
+ * Move every thread's copy of the specified bucket into the
+ * frontier, keeping each vertex once, and only if it still
+ * belongs in that bucket.  Returns the frontier's size.
+ */
+static size_t
+gather(struct run *run, size_t current, unsigned int phase)
+{
+    size_t nfrontier = 0;
+    for (int t = 0; t < run->nthreads; t += 1) {
+        struct bucket *bucket =
+            &run->buckets[t * run->nbuckets + current % run->nbuckets];
+        for (size_t i = 0; i < bucket->count; i += 1) {
+            const unsigned int v = bucket->items[i];
+            const size_t b = (size_t) (run->tentative[v] >> 32) / run->delta;
+            if (b != current || run->frontier_marks[v] == phase) continue;
+            run->frontier_marks[v] = phase;
+            run->frontier[nfrontier] = v;
+            nfrontier += 1;
+        }
+        bucket->count = 0;
+    }
+    return nfrontier;
+}
+
+/*
+ * Free the run's buffers, whichever were allocated.
+ */
+static void
+release(struct run *run)
+{
+    if (run->buckets != NULL)
+        for (size_t b = 0; b < run->nthreads * run->nbuckets; b += 1)
+            free(run->buckets[b].items);
+    free(run->buckets);
+    free(run->tentative);
+    free(run->frontier);
+    free(run->settled);
+    free(run->frontier_marks);
+    free(run->settled_marks);
+}
@@ -0,0 +1,60 @@
+#ifndef deltastep_H
+#define deltastep_H
+
+/**
+ * @file
+ * Parallel delta-stepping single source shortest paths,
+ * using sparse graphs.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "csrgraph.h"
+
+/**
+ * Finds the shortest paths from the specified source using
+ * the delta-stepping algorithm, in parallel.
+ *
+ * Vertices are kept in buckets of width delta by tentative
+ * distance.  The lowest non-empty bucket is emptied by relaxing
+ * the light edges (weight at most delta) of all its vertices in
+ * parallel, repeatedly, since they may refill it; then the heavy
+ * edges of every vertex it held are relaxed in parallel.
+ *
+ * The distances found are the same as `sdijkstra`'s, but where
+ * two predecessors give the same distance, either may be used,
+ * depending on the order the threads happen to relax them in.
+ *
+ * @param graph  the graph, in compressed sparse row form.
+ *
+ * @param source  the id of the node to use as the source for the
+ * algorithm; non-negative, less than the graph's size.
+ *
+ * @param delta  the bucket width; positive, or zero to use
+ * `delta_stepping_default_delta`.  Smaller widths do less
+ * redundant work, larger ones have more parallelism per phase.
+ *
+ * @param paths  the buffer in which to place the paths.
+ * Paths are repesented by storing each node's predecessor
+ * in the specified buffer, with node ids as the indices.
+ *
+ * @return false if memory could not be allocated, in which
+ * case the paths are left as they were.
+ */
+bool delta_stepping(struct csr_graph const* graph,
+                    unsigned int source,
+                    int delta,
+                    int * paths);
+
+/**
+ * A reasonable bucket width for the graph: the maximum edge
+ * weight over the average out degree, and at least 1.
+ */
+int delta_stepping_default_delta(struct csr_graph const* graph);
+
+#endif // deltastep_H
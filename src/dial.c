@@ -0,0 +1,270 @@
+#include "dial.h"
+
+#define ALWAYS_INLINE __attribute__((always_inline)) inline
+
+static inline bool prepare_buffers(struct workspace*, unsigned int,
+        unsigned int, unsigned int, int*);
+static void finish(struct workspace*, double, unsigned long);
+static inline unsigned long visit_edges(struct workspace*, unsigned int,
+        struct csr_graph const*, int*);
+static unsigned long visit_row(struct workspace*, unsigned int,
+        struct matrix const*, int*);
+static ALWAYS_INLINE unsigned long visit_weights(struct workspace*,
+        unsigned int, void const*, unsigned int, enum matrix_format, int*);
+static ALWAYS_INLINE int load_weight(void const*, size_t, enum matrix_format);
+static ALWAYS_INLINE bool relax(struct workspace*, unsigned int,
+        unsigned int, int, int*);
+static unsigned int largest_weight(struct csr_graph const*);
+
+/*
+ * Applies Dial's algorithm to the input graph with the
+ * specified source, using the buffers of the specified workspace.
+ *
+ * Like `sdijkstra_with`, the vertex states are the workspace's
+ * stamped marks, and visiting only touches the vertex's own edges.
+ */
+bool
+dial_with(struct workspace *ws, struct csr_graph const*graph,
+        unsigned int source, unsigned int max_weight, int *paths)
+{
+    struct engine_stats *const stats = (STATS_ENABLED) ? ws->stats : NULL;
+    const double start = (stats != NULL) ? stats_now() : 0;
+    if (max_weight == 0) max_weight = largest_weight(graph);
+    if (!prepare_buffers(ws, graph->size, source, max_weight, paths))
+        return false;
+    if (stats != NULL) stats->prepare_time += stats_now() - start;
+
+    unsigned long iteration = 0;
+    while (!buckets_empty(ws->buckets)) {
+        const unsigned int v = buckets_pop(ws->buckets);
+        ws->marks[v] = ws->visited;
+        const unsigned long improvements = visit_edges(ws, v, graph, paths);
+        if (stats != NULL) {
+            stats->edges_scanned += graph->offsets[v+1] - graph->offsets[v];
+            stats->improvements += improvements;
+        }
+        iteration += 1;
+    }
+
+    if (stats != NULL) finish(ws, start, iteration);
+    return true;
+}
+
+/*
+ * Applies Dial's algorithm to an adjacency matrix, in any format,
+ * with the specified source, reading each visited vertex's row.
+ *
+ * The rows are still read in full, so this is O(V^2) like the
+ * other dense engines, but without their scan for the nearest
+ * vertex after every row.
+ */
+bool
+dial_matrix(struct workspace *ws, struct matrix const*matrix,
+        unsigned int source, unsigned int max_weight, int *paths)
+{
+    struct engine_stats *const stats = (STATS_ENABLED) ? ws->stats : NULL;
+    const double start = (stats != NULL) ? stats_now() : 0;
+    if (!prepare_buffers(ws, matrix->size, source, max_weight, paths))
+        return false;
+    if (stats != NULL) stats->prepare_time += stats_now() - start;
+
+    unsigned long iteration = 0;
+    while (!buckets_empty(ws->buckets)) {
+        const unsigned int v = buckets_pop(ws->buckets);
+        ws->marks[v] = ws->visited;
+        const unsigned long improvements = visit_row(ws, v, matrix, paths);
+        if (stats != NULL) {
+            stats->edges_scanned += matrix->size;
+            stats->improvements += improvements;
+        }
+        iteration += 1;
+    }
+
+    if (stats != NULL) finish(ws, start, iteration);
+    return true;
+}
+
+/*
+ * Copies out the distances found by the last run of `dial_with`
+ * or `dial_matrix` which used the specified workspace.
+ * Only the vertices marked in that run have valid distances.
+ */
+void
+dial_distances(struct workspace const*ws, unsigned int size, int *distances)
+{
+    for (unsigned int i = 0; i < size; i += 1)
+        distances[i] = (ws->marks[i] == ws->visited) ? ws->distances[i] : -1;
+}
+
+/*
+ * Mark all vertices as unseen and having no path to the source,
+ * and queue just the source, at distance 0.
+ * Returns false if the bucket queue could not be allocated.
+ */
+static inline bool
+prepare_buffers(struct workspace *ws, unsigned int size, unsigned int source,
+        unsigned int max_weight, int *paths)
+{
+    struct buckets *const buckets = workspace_buckets(ws, max_weight);
+    if (buckets == NULL) return false;
+
+    workspace_begin(ws);
+    buckets_begin(buckets);
+    for (unsigned int i = 0; i < size; i += 1)
+        paths[i] = -1;
+    ws->marks[source] = ws->seen;
+    ws->distances[source] = 0;
+    paths[source] = source;
+    buckets_push(buckets, source, 0);
+    return true;
+}
+
+/*
+ * Add a finished run to the workspace's stats.
+ */
+static void
+finish(struct workspace *ws, double start, unsigned long iteration)
+{
+    ws->stats->runs += 1;
+    ws->stats->iterations += iteration;
+    ws->stats->exit_iteration = iteration;
+    ws->stats->total_time += stats_now() - start;
+}
+
+/*
+ * Relax each of v's edges.  Returns how many paths were improved.
+ */
+static inline unsigned long
+visit_edges(struct workspace *ws, unsigned int v,
+        struct csr_graph const*graph, int *paths)
+{
+    unsigned long improvements = 0;
+    for (size_t e = graph->offsets[v]; e < graph->offsets[v+1]; e += 1)
+        improvements += relax(ws, v, graph->targets[e], graph->weights[e],
+                paths);
+    return improvements;
+}
+
+/*
+ * Relax each of the edges in v's row of the matrix.
+ * Returns how many paths were improved.
+ *
+ * Plain rows get a loop of their own for each format; rows with
+ * a presence bitmap only read the weights of the edges present,
+ * and partitioned or implicit rows look each weight up.
+ */
+static unsigned long
+visit_row(struct workspace *ws, unsigned int v, struct matrix const*matrix,
+        int *paths)
+{
+    const unsigned int size = matrix->size;
+    unsigned long improvements = 0;
+
+    if (matrix->presence != NULL) {
+        const size_t nwords = matrix_presence_words(size);
+        uint64_t const*const presence = matrix->presence + v * nwords;
+        for (size_t i = 0; i < nwords; i += 1) {
+            uint64_t word = presence[i];
+            if (i == nwords - 1 && size % 64 != 0)
+                word &= ~(~(uint64_t) 0 << (size % 64));
+            while (word != 0) {
+                const unsigned int w = i*64 + __builtin_ctzll(word);
+                word &= word - 1;
+                improvements += relax(ws, v, w, matrix_weight(matrix, v, w),
+                        paths);
+            }
+        }
+        return improvements;
+    }
+
+    if (matrix->parts != NULL || matrix->format == MATRIX_IMPLICIT) {
+        for (unsigned int w = 0; w < size; w += 1)
+            improvements += relax(ws, v, w, matrix_weight(matrix, v, w),
+                    paths);
+        return improvements;
+    }
+
+    const size_t row = (size_t) v * size;
+    switch (matrix->format) {
+    case MATRIX_U16:
+        return visit_weights(ws, v, (uint16_t const*) matrix->weights + row,
+                size, MATRIX_U16, paths);
+    case MATRIX_U8:
+        return visit_weights(ws, v, (uint8_t const*) matrix->weights + row,
+                size, MATRIX_U8, paths);
+    default:
+        return visit_weights(ws, v, (int const*) matrix->weights + row,
+                size, MATRIX_INT, paths);
+    }
+}
+
+/*
+ * Relax each edge of a plain row of the specified format.
+ * Always inlined with a constant format, so each format has its
+ * own loop with the right loads.
+ */
+static ALWAYS_INLINE unsigned long
+visit_weights(struct workspace *ws, unsigned int v, void const*row,
+        unsigned int size, enum matrix_format format, int *paths)
+{
+    unsigned long improvements = 0;
+    for (unsigned int w = 0; w < size; w += 1)
+        improvements += relax(ws, v, w, load_weight(row, w, format), paths);
+    return improvements;
+}
+
+/*
+ * The weight at w of a row in the specified format,
+ * with -1 meaning no edge.
+ */
+static ALWAYS_INLINE int
+load_weight(void const*row, size_t w, enum matrix_format format)
+{
+    switch (format) {
+    case MATRIX_U16: {
+        const uint16_t weight = ((uint16_t const*) row)[w];
+        return (weight == MATRIX_U16_NO_EDGE) ? -1 : weight;
+    }
+    case MATRIX_U8: {
+        const uint8_t weight = ((uint8_t const*) row)[w];
+        return (weight == MATRIX_U8_NO_EDGE) ? -1 : weight;
+    }
+    default:
+        return ((int const*) row)[w];
+    }
+}
+
+/*
+ * If the edge from v to w, of the specified weight or -1 for no
+ * edge, gives w a shorter path than it had, remember it and queue
+ * w at its new distance.  Returns whether it did.
+ */
+static ALWAYS_INLINE bool
+relax(struct workspace *ws, unsigned int v, unsigned int w, int weight,
+        int *paths)
+{
+    if (weight == -1 || ws->marks[w] == ws->visited) return false;
+    if (ws->marks[w] != ws->seen) {
+        ws->marks[w] = ws->seen;
+        ws->distances[w] = INT_MAX;
+    }
+
+    const int through_v = ws->distances[v] + weight;
+    if (through_v >= ws->distances[w]) return false;
+    ws->distances[w] = through_v;
+    paths[w] = v;
+    buckets_push(ws->buckets, w, through_v);
+    return true;
+}
+
+/*
+ * The largest edge weight in the graph, or 0 if it has no edges.
+ */
+static unsigned int
+largest_weight(struct csr_graph const*graph)
+{
+    int largest = 0;
+    for (size_t e = 0; e < graph->nedges; e += 1)
+        if (graph->weights[e] > largest) largest = graph->weights[e];
+    return largest;
+}
@@ -0,0 +1,92 @@
+#ifndef dial_H
+#define dial_H
+
+/**
+ * @file
+ * Dial's algorithm: Dijkstra's algorithm with a bucket queue in
+ * place of the heap or the scan for the nearest vertex, for
+ * graphs whose edge weights are small integers.
+ *
+ * The queue only ever holds distances from the last one settled
+ * to `max_weight` more than it, so `max_weight + 1` buckets in a
+ * ring hold them all, and finding the nearest vertex takes O(1)
+ * amortised time instead of O(log V) or O(V): O(V + E + D) in all,
+ * where D is the largest distance.
+ *
+ * The distances are the same as the other engines', but ties
+ * between equally short paths may be broken differently.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "buckets.h"
+#include "csrgraph.h"
+#include "matrix.h"
+#include "workspace.h"
+
+/**
+ * Applies Dial's algorithm to the input graph with the
+ * specified source, using the buffers of the specified workspace.
+ *
+ * @param ws  the workspace; its capacity at least the graph's size.
+ *
+ * @param graph  the graph, in compressed sparse row form.
+ *
+ * @param source  the id of the node to use as the source for the
+ * algorithm; non-negative, less than the graph's size.
+ *
+ * @param max_weight  at least the largest edge weight in the
+ * graph, or 0 to find it from the graph's weights.
+ *
+ * @param paths  the buffer in which to place the paths.
+ *
+ * @return false if the bucket queue could not be allocated.
+ */
+bool dial_with(struct workspace * ws,
+               struct csr_graph const* graph,
+               unsigned int source,
+               unsigned int max_weight,
+               int * paths);
+
+/**
+ * Applies Dial's algorithm to an adjacency matrix, in any format,
+ * with the specified source, reading each visited vertex's row.
+ *
+ * @param ws  the workspace; its capacity at least the matrix's size.
+ *
+ * @param matrix  the graph's weights.
+ *
+ * @param source  the id of the node to use as the source for the
+ * algorithm; non-negative, less than the matrix's size.
+ *
+ * @param max_weight  at least the largest edge weight in the matrix,
+ * such as the `max_weight` it was generated with.
+ *
+ * @param paths  the buffer in which to place the paths.
+ *
+ * @return false if the bucket queue could not be allocated.
+ */
+bool dial_matrix(struct workspace * ws,
+                 struct matrix const* matrix,
+                 unsigned int source,
+                 unsigned int max_weight,
+                 int * paths);
+
+/**
+ * Copies out the distances found by the last run of `dial_with`
+ * or `dial_matrix` which used the specified workspace.
+ *
+ * @param ws  the workspace the run used.
+ *
+ * @param size  the number of nodes in the run's graph.
+ *
+ * @param distances  the buffer in which to place each node's
+ * distance from the source, with -1 meaning no path.
+ */
+void dial_distances(struct workspace const* ws,
+                    unsigned int size,
+                    int * distances);
+
+#endif // dial_H
@@ -1,8 +1,6 @@
 #include "dijkstra.h"
 
-static inline void prepare_buffers(int, int, int*, int*, bool*, bool*);
-static inline int nearest_vertex(int, bool const*, bool const*, int const*);
-static inline void visit_vertex(int, int const*, int, bool*, int*, int*);
+static inline void prepare_buffers(int, int, unsigned int*, int*);
 
 /*
  * Applies Dijkstra's algorithm to the input graph
@@ -22,82 +20,113 @@ static inline void visit_vertex(int, int const*, int, bool*, int*, int*);
  * Paths are repesented by storing each node's predecessor
  * in the specified buffer, with node ids as the indices.
  */
-void
+bool
 dijkstra(int const*edges, unsigned int size, unsigned int source, int *paths)
 {
-    bool seen_set[size];
-    bool visited_set[size];
-    int distances[size];
-    prepare_buffers(size, source, distances, paths, seen_set, visited_set);
-
-    // For (at most) every vertex:
-    for (int nvisited = 0; nvisited < size; nvisited += 1) {
-        int v = nearest_vertex(size, seen_set, visited_set, distances);
-        if (v == size) break; // No more seen but unvisited vertices.
-        visited_set[v] = true;
-
-        visit_vertex(v, edges, size, seen_set, distances, paths);
-    }
+    struct workspace *ws = workspace_create(size);
+    if (ws == NULL) return false;
+    dijkstra_with(ws, edges, size, source, paths);
+    workspace_destroy(ws);
+    return true;
 }
 
 /*
- * Mark all vertexs as unseen, unvisited, at infinite distance,
- * and having no path to the source.
- * Begin with the seen set being just the source.
+ * Applies Dijkstra's algorithm to the input graph
+ * with the specified source, using the buffers of
+ * the specified workspace.
+ *
+ * @param ws  the workspace; its capacity at least size.
+ *
+ * @param edges  a buffer containing a matrix of edge weights.
+ * `edges[v*size + w]` should be the weight of the edge from
+ * the vertex v to the vertex w, with -1 meaning no edge.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * @param source  the id of the node to visit as the source for the
+ * algorithm; non-negative, less than size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ *
+ * Each visit relaxes v's row and finds the next nearest vertex
+ * in the same pass over the packed vertex states; see `sweep.h`.
  */
-static inline void
-prepare_buffers(int size, int source, int *distances, int *paths,
-        bool *seen_set, bool *visited_set)
+void
+dijkstra_with(struct workspace *ws, int const*edges, unsigned int size,
+        unsigned int source, int *paths)
 {
-    for (int i = 0; i < size; i += 1) {
-        distances[i] = INT_MAX;
-        paths[i] = -1;
-        seen_set[i] = false;
-        visited_set[i] = false;
-    }
-    seen_set[source] = true;
-    distances[source] = 0;
-    paths[source] = source;
+    const struct matrix matrix = matrix_of_ints(edges, size);
+    dijkstra_matrix(ws, &matrix, source, paths);
 }
 
 /*
- * Pick the unvisited, but seen vertex with the shortest
- * path from the source.
- * Returns `size` if there are no valid vertices.
+ * Applies Dijkstra's algorithm to a graph given as a matrix
+ * in any format, using the buffers of the specified workspace.
  */
-static inline int
-nearest_vertex(int size, bool const*seen_set, bool const*visited_set,
-        int const*distances)
+void
+dijkstra_matrix(struct workspace *ws, struct matrix const*matrix,
+        unsigned int source, int *paths)
 {
-    int v;
-    // Find the first valid vertex.
-    for (v = 0; v < size; v += 1)
-        if (seen_set[v] && !visited_set[v]) break;
+    const unsigned int size = matrix->size;
+    unsigned int *const states = ws->states;
+    struct engine_stats *const stats = (STATS_ENABLED) ? ws->stats : NULL;
+    const double start = (stats != NULL) ? stats_now() : 0;
+    prepare_buffers(size, source, states, paths);
+    if (stats != NULL) stats->prepare_time += stats_now() - start;
+
+    // For (at most) every vertex:
+    unsigned long iteration = 0;
+    uint64_t nearest = candidate(source, states[source]);
+    while (nearest != CANDIDATE_NONE) {
+        const unsigned int v = candidate_vertex(nearest);
+        const unsigned int vstate = candidate_state(nearest);
+        states[v] = vstate | STATE_VISITED;
 
-    // Find the closest valid vertex.
-    for (int u = 0; u < size; u += 1)
-        if (!visited_set[u] && seen_set[u] && (distances[u] < distances[v]))
-            v = u;
+        const double sweep_start = (stats != NULL) ? stats_now() : 0;
+        nearest = sweep_matrix_row(matrix, v, vstate, states, paths, 0, size);
+        if (stats != NULL) {
+            const double sweep_time = stats_now() - sweep_start;
+            stats_add_iteration(stats, &sweep_time, 1, sweep_time);
+            stats->edges_scanned += size;
+            stats->improvements += stats_count_improvements(paths, v, 0, size);
+        }
+        iteration += 1;
+    }
 
-    return v;
+    if (stats != NULL) {
+        stats->runs += 1;
+        stats->exit_iteration = iteration;
+        stats->total_time += stats_now() - start;
+    }
 }
 
 /*
- * Check each of v's neighbours, w, marking them as seen.
- * If the path to w through v is shorter than the previous
- * shortest known path, remember it.
+ * Copies out the distances found by the last run of a dense
+ * engine which used the specified workspace.
+ * Every vertex the run reached has been visited, so its state
+ * holds its final distance.
  */
-static inline void
-visit_vertex(int v, int const*edges, int size,
-        bool *seen_set, int *distances, int*paths)
+void
+dijkstra_distances(struct workspace const*ws, unsigned int size,
+        int *distances)
 {
-    for (int w = 0; w < size; w += 1) {
-        if (edges[v*size + w] == -1) continue;
-        seen_set[w] = true;
+    for (unsigned int i = 0; i < size; i += 1)
+        distances[i] = (ws->states[i] == STATE_UNSEEN)
+            ? -1 : state_distance(ws->states[i]);
+}
 
-        if (distances[w] > distances[v] + edges[v*size + w]) {
-            distances[w] = distances[v] + edges[v*size + w];
-            paths[w] = v;
-        }
+/*
+ * Mark all vertexs as unseen, unvisited, at infinite distance,
+ * and having no path to the source.
+ * Begin with the seen set being just the source.
+ */
+static inline void
+prepare_buffers(int size, int source, unsigned int *states, int *paths)
+{
+    for (int i = 0; i < size; i += 1) {
+        states[i] = STATE_UNSEEN;
+        paths[i] = -1;
     }
+    states[source] = state_at(0);
+    paths[source] = source;
 }
@@ -0,0 +1,138 @@
+#include "floyd.h"
+
+// Half of INT_MAX, so that adding two infinities can't overflow.
+#define INFINITY_DISTANCE (INT_MAX / 2)
+
+/*
+ * Paths are compared by length, then by number of edges, packed
+ * into one integer: the length in the high 32 bits, the edges in
+ * the low.  Counting edges makes every edge longer than none, so
+ * zero weight cycles can't make the next hops loop.
+ */
+#define PATH(distance, hops) (((int64_t) (distance) << 32) | (hops))
+#define INFINITY_PATH PATH(INFINITY_DISTANCE, 0)
+
+static inline void update_tile(int64_t*, int*, unsigned int,
+        unsigned int, unsigned int, unsigned int);
+static inline unsigned int tile_end(unsigned int, unsigned int);
+
+/*
+ * Finds the shortest paths between every pair of vertices
+ * of the input graph.
+ *
+ * @param edges  a buffer containing a matrix of edge weights.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * @param distances  the buffer in which to place the distances.
+ *
+ * @param next  the buffer in which to place the next hops.
+ *
+ * @return false if memory could not be allocated for the paths.
+ *
+ * Parallelisation: for each diagonal tile `k`, the diagonal tile
+ * only depends on itself, the other tiles in row and column `k`
+ * only on themselves and the diagonal tile, and the rest only on
+ * themselves and the tiles in row and column `k` which share their
+ * row or column.  So within each of those three steps, the tiles
+ * are independent, and are shared out among the threads.
+ */
+bool
+floyd_warshall(int const*edges, unsigned int size, int *distances, int *next)
+{
+    const size_t nentries = (size_t) size * size;
+    const unsigned int ntiles = (size + FLOYD_TILE - 1) / FLOYD_TILE;
+    int64_t *paths = (int64_t*) malloc(nentries * sizeof(int64_t));
+    if (paths == NULL) return false;
+
+#pragma omp parallel
+    {
+#pragma omp for schedule(static)
+        for (size_t i = 0; i < nentries; i += 1) {
+            const bool has_edge = (edges[i] != -1);
+            paths[i] = has_edge ? PATH(edges[i], 1) : INFINITY_PATH;
+            next[i] = has_edge ? (int) (i % size) : -1;
+        }
+#pragma omp for schedule(static)
+        for (unsigned int v = 0; v < size; v += 1) {
+            paths[(size_t) v*size + v] = 0;
+            next[(size_t) v*size + v] = v;
+        }
+
+        for (unsigned int k = 0; k < ntiles; k += 1) {
+#pragma omp single
+            update_tile(paths, next, size, k, k, k);
+
+            // The rest of tile row and tile column k.
+#pragma omp for schedule(dynamic)
+            for (unsigned int t = 0; t < 2 * ntiles; t += 1) {
+                const unsigned int other = t / 2;
+                if (other == k) continue;
+                if (t % 2 == 0)
+                    update_tile(paths, next, size, k, other, k);
+                else
+                    update_tile(paths, next, size, other, k, k);
+            }
+
+            // Everything else.
+#pragma omp for schedule(dynamic) collapse(2)
+            for (unsigned int i = 0; i < ntiles; i += 1) {
+                for (unsigned int j = 0; j < ntiles; j += 1) {
+                    if (i == k || j == k) continue;
+                    update_tile(paths, next, size, i, j, k);
+                }
+            }
+        }
+
+#pragma omp for schedule(static)
+        for (size_t i = 0; i < nentries; i += 1)
+            distances[i] = (paths[i] >= INFINITY_PATH)
+                ? -1 : (int) (paths[i] >> 32);
+    }
+
+    free(paths);
+    return true;
+}
+
+/*
+ * Relax the paths of tile (i, j) through each of the vertices
+ * of tile column k, in order.  When the tiles overlap, this is
+ * exactly the unblocked algorithm restricted to the tile.
+ */
+static inline void
+update_tile(int64_t *paths, int *next, unsigned int size,
+        unsigned int i, unsigned int j, unsigned int k)
+{
+    const unsigned int u_end = tile_end(i, size);
+    const unsigned int w_min = j * FLOYD_TILE;
+    const unsigned int w_end = tile_end(j, size);
+    const unsigned int x_end = tile_end(k, size);
+
+    for (unsigned int x = k * FLOYD_TILE; x < x_end; x += 1) {
+        int64_t const*const x_row = paths + (size_t) x*size;
+        for (unsigned int u = i * FLOYD_TILE; u < u_end; u += 1) {
+            int64_t *const u_row = paths + (size_t) u*size;
+            int *const u_next = next + (size_t) u*size;
+            const int64_t ux = u_row[x];
+            if (ux >= INFINITY_PATH) continue;
+            const int hop = u_next[x];
+
+            for (unsigned int w = w_min; w < w_end; w += 1) {
+                if (ux + x_row[w] < u_row[w]) {
+                    u_row[w] = ux + x_row[w];
+                    u_next[w] = hop;
+                }
+            }
+        }
+    }
+}
+
+/*
+ * The vertex after the last in the specified tile.
+ */
+static inline unsigned int
+tile_end(unsigned int tile, unsigned int size)
+{
+    const unsigned int end = (tile + 1) * FLOYD_TILE;
+    return (end < size) ? end : size;
+}
@@ -0,0 +1,59 @@
+#ifndef floyd_H
+#define floyd_H
+
+/**
+ * @file
+ * Cache blocked, parallel Floyd-Warshall all pairs shortest
+ * paths, using graphs defined by weighted adjacency matrices.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * The side length of the tiles the matrices are processed in.
+ * Three tiles of 64 bit path lengths fit comfortably in a 256KiB
+ * L2 cache.
+ */
+#define FLOYD_TILE (64)
+
+/**
+ * Finds the shortest paths between every pair of vertices
+ * of the input graph.
+ *
+ * For each diagonal tile in turn, the diagonal tile is updated,
+ * then the rest of its tile row and tile column in parallel,
+ * then every other tile in parallel, each tile update working
+ * on three tiles which stay in cache.  Of equally short paths,
+ * the one with the fewest edges is kept, so the next hops never
+ * loop around zero weight cycles.
+ *
+ * @param edges  a buffer containing a matrix of edge weights.
+ * `edges[v*size + w]` should be the weight of the edge from
+ * the vertex v to the vertex w, with -1 meaning no edge.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * @param distances  the buffer in which to place the distances;
+ * `distances[v*size + w]` is the length of the shortest path from
+ * v to w, with -1 meaning no path.  Distances must stay below
+ * `INT_MAX / 2`.
+ *
+ * @param next  the buffer in which to place the paths;
+ * `next[v*size + w]` is the vertex after v on the shortest path
+ * from v to w, with -1 meaning no path, and `next[v*size + v]`
+ * being v.
+ *
+ * @return false if memory could not be allocated for the
+ * `size * size` 64 bit path lengths used along the way.
+ */
+bool floyd_warshall(int const* edges,
+                    unsigned int size,
+                    int * distances,
+                    int * next);
+
+#endif // floyd_H
@@ -0,0 +1,262 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "graphfile.h"
+
+#define BYTE_ORDER_MARK (0x01020304u)
+
+_Static_assert(sizeof(struct graphfile_header) == 128,
+        "graph file headers should be 128 bytes");
+_Static_assert(sizeof(size_t) == sizeof(uint64_t),
+        "CSR offsets are mapped as 64 bit integers");
+
+static void init_header(struct graphfile_header*, enum graphfile_kind,
+        unsigned int);
+static bool write_file(char const*, struct graphfile_header*,
+        void const*const*);
+static bool valid_header(struct graphfile_header const*, size_t);
+static bool valid_csr(struct csr_graph const*);
+
+/*
+ * Writes a matrix, in its own format, to a graph file.
+ */
+bool
+graphfile_save_matrix(char const*path, struct matrix const*matrix)
+{
+    if (matrix->parts != NULL) {
+        errno = EINVAL;
+        return false;
+    }
+
+    struct graphfile_header header;
+    init_header(&header, GRAPHFILE_DENSE, matrix->size);
+    header.format = matrix->format;
+    header.max_weight = matrix->implicit.max_weight;
+    header.key = matrix->implicit.key;
+    header.threshold = matrix->implicit.threshold;
+
+    const size_t ncells = (size_t) matrix->size * matrix->size;
+    header.lengths[0] = ncells * matrix_weight_size(matrix->format);
+    if (matrix->presence != NULL)
+        header.lengths[1] = (size_t) matrix->size
+            * matrix_presence_words(matrix->size) * sizeof(uint64_t);
+
+    void const*const data[GRAPHFILE_SECTIONS] = {
+        matrix->weights, matrix->presence, NULL
+    };
+    return write_file(path, &header, data);
+}
+
+/*
+ * Writes a CSR graph to a graph file.
+ */
+bool
+graphfile_save_csr(char const*path, struct csr_graph const*graph)
+{
+    struct graphfile_header header;
+    init_header(&header, GRAPHFILE_CSR, graph->size);
+    header.nedges = graph->nedges;
+    header.lengths[0] = ((size_t) graph->size + 1) * sizeof(uint64_t);
+    header.lengths[1] = graph->nedges * sizeof(unsigned int);
+    header.lengths[2] = graph->nedges * sizeof(int);
+
+    void const*const data[GRAPHFILE_SECTIONS] = {
+        graph->offsets, graph->targets, graph->weights
+    };
+    return write_file(path, &header, data);
+}
+
+/*
+ * Memory maps a graph file and checks its header, and for CSR
+ * files, the edges.
+ */
+struct graphfile *
+graphfile_open(char const*path)
+{
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+    const size_t length = st.st_size;
+    if (length < sizeof(struct graphfile_header)) {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    void *const map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    struct graphfile_header const*const header = map;
+    struct graphfile *file = malloc(sizeof(struct graphfile));
+    if (!valid_header(header, length) || file == NULL) {
+        munmap(map, length);
+        free(file);
+        errno = (file == NULL) ? ENOMEM : EINVAL;
+        return NULL;
+    }
+
+    char *const base = map;
+    memset(file, 0, sizeof(struct graphfile));
+    file->kind = header->kind;
+    file->map = map;
+    file->length = length;
+    if (header->kind == GRAPHFILE_DENSE) {
+        file->matrix.format = header->format;
+        file->matrix.size = header->size;
+        file->matrix.weights = (header->lengths[0] == 0)
+            ? NULL : base + header->sections[0];
+        file->matrix.presence = (header->lengths[1] == 0)
+            ? NULL : (uint64_t*) (base + header->sections[1]);
+        file->matrix.implicit.key = header->key;
+        file->matrix.implicit.threshold = header->threshold;
+        file->matrix.implicit.max_weight = header->max_weight;
+    } else {
+        file->csr.size = header->size;
+        file->csr.nedges = header->nedges;
+        file->csr.offsets = (size_t*) (base + header->sections[0]);
+        file->csr.targets = (unsigned int*) (base + header->sections[1]);
+        file->csr.weights = (int*) (base + header->sections[2]);
+        if (!valid_csr(&file->csr)) {
+            graphfile_close(file);
+            errno = EINVAL;
+            return NULL;
+        }
+    }
+    return file;
+}
+
+/*
+ * Unmaps a graph file opened by `graphfile_open`.
+ */
+void
+graphfile_close(struct graphfile *file)
+{
+    if (file == NULL) return;
+    munmap(file->map, file->length);
+    free(file);
+}
+
+/*
+ * Start a header for a file of the specified kind and size,
+ * with no sections and every other field zero.
+ */
+static void
+init_header(struct graphfile_header *header, enum graphfile_kind kind,
+        unsigned int size)
+{
+    memset(header, 0, sizeof(struct graphfile_header));
+    strncpy(header->magic, GRAPHFILE_MAGIC, sizeof(header->magic));
+    header->version = GRAPHFILE_VERSION;
+    header->byte_order = BYTE_ORDER_MARK;
+    header->kind = kind;
+    header->size = size;
+}
+
+/*
+ * Lay out the header's sections from their lengths, then write
+ * the header and each section's data, zero padding between them.
+ */
+static bool
+write_file(char const*path, struct graphfile_header *header,
+        void const*const*data)
+{
+    static const char zeroes[GRAPHFILE_ALIGNMENT] = {0};
+
+    uint64_t offset = sizeof(struct graphfile_header);
+    for (int i = 0; i < GRAPHFILE_SECTIONS; i += 1) {
+        if (header->lengths[i] == 0) continue;
+        offset = (offset + GRAPHFILE_ALIGNMENT - 1)
+            / GRAPHFILE_ALIGNMENT * GRAPHFILE_ALIGNMENT;
+        header->sections[i] = offset;
+        offset += header->lengths[i];
+    }
+
+    FILE *out = fopen(path, "wb");
+    if (out == NULL) return false;
+
+    bool ok = fwrite(header, sizeof(struct graphfile_header), 1, out) == 1;
+    uint64_t written = sizeof(struct graphfile_header);
+    for (int i = 0; ok && i < GRAPHFILE_SECTIONS; i += 1) {
+        if (header->lengths[i] == 0) continue;
+        ok = fwrite(zeroes, 1, header->sections[i] - written, out)
+            == header->sections[i] - written;
+        ok = ok && fwrite(data[i], 1, header->lengths[i], out)
+            == header->lengths[i];
+        written = header->sections[i] + header->lengths[i];
+    }
+
+    return (fclose(out) == 0) && ok;
+}
+
+/*
+ * Checks that a header was written by a compatible version on a
+ * machine with the same byte order, and that its sections are
+ * aligned, lie within the file, and are as long as the graph
+ * needs.
+ */
+static bool
+valid_header(struct graphfile_header const*header, size_t length)
+{
+    if (strncmp(header->magic, GRAPHFILE_MAGIC, sizeof(header->magic)) != 0
+            || header->version != GRAPHFILE_VERSION
+            || header->byte_order != BYTE_ORDER_MARK)
+        return false;
+
+    for (int i = 0; i < GRAPHFILE_SECTIONS; i += 1) {
+        if (header->lengths[i] == 0) continue;
+        if (header->sections[i] % GRAPHFILE_ALIGNMENT != 0
+                || header->sections[i] > length
+                || header->lengths[i] > length - header->sections[i])
+            return false;
+    }
+
+    const uint64_t size = header->size;
+    switch (header->kind) {
+    case GRAPHFILE_DENSE:
+        if (header->format > MATRIX_IMPLICIT) return false;
+        return header->lengths[0]
+                == size * size * matrix_weight_size(header->format)
+            && (header->lengths[1] == 0 || header->lengths[1]
+                == size * matrix_presence_words(size) * sizeof(uint64_t));
+    case GRAPHFILE_CSR:
+        // Bounded first, so that the lengths below can't overflow.
+        return header->nedges <= length / sizeof(int)
+            && header->lengths[0] == (size + 1) * sizeof(uint64_t)
+            && header->lengths[1] == header->nedges * sizeof(unsigned int)
+            && header->lengths[2] == header->nedges * sizeof(int);
+    default:
+        return false;
+    }
+}
+
+/*
+ * Checks that a CSR graph's offsets start at zero, never decrease
+ * and end at the number of edges, and that every edge has a vertex
+ * as its target and a non-negative weight, so that the engines can
+ * trust them.
+ */
+static bool
+valid_csr(struct csr_graph const*graph)
+{
+    const unsigned int size = graph->size;
+    if (graph->offsets[0] != 0 || graph->offsets[size] != graph->nedges)
+        return false;
+    for (unsigned int v = 0; v < size; v += 1)
+        if (graph->offsets[v] > graph->offsets[v+1]) return false;
+
+    for (size_t e = 0; e < graph->nedges; e += 1)
+        if (graph->targets[e] >= size || graph->weights[e] < 0)
+            return false;
+    return true;
+}
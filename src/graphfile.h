@@ -0,0 +1,145 @@
+#ifndef graphfile_H
+#define graphfile_H
+
+/**
+ * @file
+ * Versioned binary graph files, laid out so that a graph can be
+ * memory mapped and handed to the engines without copying.
+ *
+ * A file is a `struct graphfile_header` followed by its payload
+ * sections, each starting on a `GRAPHFILE_ALIGNMENT` byte
+ * boundary.  Dense files hold a matrix's weights in its format,
+ * then its presence bitmap if it has one; implicit matrices
+ * need no sections at all.  CSR files hold the offsets (as
+ * 64 bit integers), targets and weights of a `csr_graph`.
+ * Everything is in the byte order of the machine which wrote
+ * the file.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "csrgraph.h"
+#include "matrix.h"
+
+/** The first eight bytes of every graph file. */
+#define GRAPHFILE_MAGIC ("PDGRAPH")
+
+/** The version of the format written by this code. */
+#define GRAPHFILE_VERSION (1)
+
+/** The alignment of every payload section. */
+#define GRAPHFILE_ALIGNMENT (64)
+
+/** The most payload sections a file has. */
+#define GRAPHFILE_SECTIONS (3)
+
+/**
+ * What a graph file holds.
+ */
+enum graphfile_kind {
+    /** A `struct matrix`, in any format. */
+    GRAPHFILE_DENSE = 1,
+    /** A `struct csr_graph`. */
+    GRAPHFILE_CSR = 2,
+};
+
+/**
+ * The header at the start of every graph file.
+ */
+struct graphfile_header {
+    /** `GRAPHFILE_MAGIC`, NUL padded. */
+    char magic[8];
+    /** `GRAPHFILE_VERSION` when written. */
+    uint32_t version;
+    /** 0x01020304 in the writer's byte order. */
+    uint32_t byte_order;
+    /** An `enum graphfile_kind`. */
+    uint32_t kind;
+    /** For dense files, the matrix's `enum matrix_format`. */
+    uint32_t format;
+    /** The number of vertices in the graph. */
+    uint32_t size;
+    /** For implicit matrices, the upper bound edge weight. */
+    uint32_t max_weight;
+    /** For CSR files, the number of edges. */
+    uint64_t nedges;
+    /** For implicit matrices, the hashed seed. */
+    uint64_t key;
+    /** For implicit matrices, the edge threshold. */
+    uint64_t threshold;
+    /** The offset of each section from the start of the file, or 0. */
+    uint64_t sections[GRAPHFILE_SECTIONS];
+    /** The length in bytes of each section. */
+    uint64_t lengths[GRAPHFILE_SECTIONS];
+    /** Zeroes, padding the header to 128 bytes. */
+    uint8_t reserved[24];
+};
+
+/**
+ * A graph file mapped into memory.
+ *
+ * The graph's arrays point straight into the mapping, so they
+ * are read only and live until `graphfile_close`.
+ */
+struct graphfile {
+    /** What the file holds. */
+    enum graphfile_kind kind;
+    /** The graph, for `GRAPHFILE_DENSE` files. */
+    struct matrix matrix;
+    /** The graph, for `GRAPHFILE_CSR` files. */
+    struct csr_graph csr;
+    /** The mapping. */
+    void *map;
+    /** The length of the mapping. */
+    size_t length;
+};
+
+/**
+ * Writes a matrix, in its own format, to a graph file.
+ *
+ * @param path  the file to write, replacing any existing file.
+ *
+ * @param matrix  the matrix to save; not partitioned, since
+ * the file's weights are a single block of rows.
+ *
+ * @return whether the whole file was written.
+ */
+bool graphfile_save_matrix(char const* path,
+                           struct matrix const* matrix);
+
+/**
+ * Writes a CSR graph to a graph file.
+ *
+ * @param path  the file to write, replacing any existing file.
+ *
+ * @param graph  the graph to save.
+ *
+ * @return whether the whole file was written.
+ */
+bool graphfile_save_csr(char const* path,
+                        struct csr_graph const* graph);
+
+/**
+ * Memory maps a graph file and checks its header.
+ *
+ * Pages are only read from disk as the engines touch them,
+ * so opening even a very large dense file is quick.  A CSR
+ * file's edges are read once on opening, to check that the
+ * offsets are in order and every target and weight is valid.
+ *
+ * @param path  the file to open.
+ *
+ * @return the mapped graph, to be released with `graphfile_close`,
+ * or NULL, with errno set, if the file could not be mapped or is
+ * not a valid graph file for this machine.
+ */
+struct graphfile *graphfile_open(char const* path);
+
+/**
+ * Unmaps a graph file opened by `graphfile_open`.
+ */
+void graphfile_close(struct graphfile * file);
+
+#endif // graphfile_H
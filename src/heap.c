@@ -0,0 +1,139 @@
+#include "heap.h"
+
+static inline bool precedes(struct heap const*, unsigned int, unsigned int);
+static inline void place(struct heap*, unsigned int, unsigned int);
+static inline void sift_up(struct heap*, unsigned int);
+static inline void sift_down(struct heap*, unsigned int);
+
+/*
+ * Creates an empty heap for the vertex ids less than capacity.
+ */
+struct heap *
+heap_create(unsigned int capacity)
+{
+    struct heap *heap = malloc(sizeof(struct heap));
+    if (heap == NULL) return NULL;
+
+    heap->capacity = capacity;
+    heap->count = 0;
+    heap->items = malloc(capacity * sizeof(unsigned int));
+    heap->positions = malloc(capacity * sizeof(unsigned int));
+    heap->keys = malloc(capacity * sizeof(int));
+    if (heap->items == NULL || heap->positions == NULL || heap->keys == NULL) {
+        heap_destroy(heap);
+        return NULL;
+    }
+
+    for (unsigned int v = 0; v < capacity; v += 1)
+        heap->positions[v] = HEAP_ABSENT;
+    return heap;
+}
+
+/*
+ * Releases a heap created by `heap_create`.
+ */
+void
+heap_destroy(struct heap *heap)
+{
+    if (heap == NULL) return;
+    free(heap->items);
+    free(heap->positions);
+    free(heap->keys);
+    free(heap);
+}
+
+/*
+ * Removes every vertex from the heap,
+ * in time proportional to the number removed.
+ */
+void
+heap_clear(struct heap *heap)
+{
+    for (unsigned int i = 0; i < heap->count; i += 1)
+        heap->positions[heap->items[i]] = HEAP_ABSENT;
+    heap->count = 0;
+}
+
+/*
+ * Inserts the vertex v with the specified key, or lowers
+ * its key if it is already in the heap.
+ */
+void
+heap_push(struct heap *heap, unsigned int v, int key)
+{
+    heap->keys[v] = key;
+    if (heap->positions[v] == HEAP_ABSENT) {
+        place(heap, heap->count, v);
+        heap->count += 1;
+    }
+    sift_up(heap, heap->positions[v]);
+}
+
+/*
+ * Removes and returns the vertex with the smallest key.
+ * The heap must not be empty.
+ */
+unsigned int
+heap_pop(struct heap *heap)
+{
+    const unsigned int v = heap->items[0];
+    heap->positions[v] = HEAP_ABSENT;
+    heap->count -= 1;
+
+    if (heap->count > 0) {
+        place(heap, 0, heap->items[heap->count]);
+        sift_down(heap, 0);
+    }
+    return v;
+}
+
+/*
+ * Checks whether the vertex u belongs above the vertex w;
+ * ties on key are broken by the lower vertex id.
+ */
+static inline bool
+precedes(struct heap const*heap, unsigned int u, unsigned int w)
+{
+    return heap->keys[u] < heap->keys[w]
+        || (heap->keys[u] == heap->keys[w] && u < w);
+}
+
+/*
+ * Put the vertex v at position i, keeping its index up to date.
+ */
+static inline void
+place(struct heap *heap, unsigned int i, unsigned int v)
+{
+    heap->items[i] = v;
+    heap->positions[v] = i;
+}
+
+static inline void
+sift_up(struct heap *heap, unsigned int i)
+{
+    const unsigned int v = heap->items[i];
+    while (i > 0) {
+        const unsigned int parent = (i - 1) / 2;
+        if (!precedes(heap, v, heap->items[parent])) break;
+        place(heap, i, heap->items[parent]);
+        i = parent;
+    }
+    place(heap, i, v);
+}
+
+static inline void
+sift_down(struct heap *heap, unsigned int i)
+{
+    const unsigned int v = heap->items[i];
+    for (;;) {
+        unsigned int child = 2*i + 1;
+        if (child >= heap->count) break;
+        if (child + 1 < heap->count
+                && precedes(heap, heap->items[child + 1], heap->items[child]))
+            child += 1;
+        if (!precedes(heap, heap->items[child], v)) break;
+        place(heap, i, heap->items[child]);
+        i = child;
+    }
+    place(heap, i, v);
+}
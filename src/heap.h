@@ -0,0 +1,91 @@
+#ifndef heap_H
+#define heap_H
+
+/**
+ * @file
+ * Indexed binary min-heap of vertices keyed by distance,
+ * supporting decrease-key for Dijkstra's algorithm.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * A min-heap over the vertex ids `0` to `capacity - 1`.
+ *
+ * Vertices with equal keys are ordered by id, so that
+ * extraction order matches a linear scan for the minimum.
+ */
+struct heap {
+    /** The number of vertex ids the heap can hold. */
+    unsigned int capacity;
+    /** The number of vertices currently in the heap. */
+    unsigned int count;
+    /** The vertices, in heap order. */
+    unsigned int *items;
+    /** Each vertex's position in `items`, or `HEAP_ABSENT`. */
+    unsigned int *positions;
+    /** Each vertex's key; only meaningful while it's in the heap. */
+    int *keys;
+};
+
+/** Position of vertices which aren't in the heap. */
+#define HEAP_ABSENT (UINT_MAX)
+
+/**
+ * Creates an empty heap for the vertex ids less than capacity.
+ *
+ * @return the new heap, to be released with `heap_destroy`,
+ * or NULL if memory could not be allocated.
+ */
+struct heap *heap_create(unsigned int capacity);
+
+/**
+ * Releases a heap created by `heap_create`.
+ */
+void heap_destroy(struct heap *heap);
+
+/**
+ * Removes every vertex from the heap,
+ * in time proportional to the number removed.
+ */
+void heap_clear(struct heap *heap);
+
+/**
+ * Inserts the vertex v with the specified key, or lowers
+ * its key if it is already in the heap.
+ *
+ * @param v  the vertex; less than the heap's capacity.
+ *
+ * @param key  the new key; if v is already in the heap,
+ * no greater than its current key.
+ */
+void heap_push(struct heap *heap, unsigned int v, int key);
+
+/**
+ * Removes and returns the vertex with the smallest key.
+ * The heap must not be empty.
+ */
+unsigned int heap_pop(struct heap *heap);
+
+/**
+ * Checks whether the heap has no vertices in it.
+ */
+static inline bool
+heap_empty(struct heap const*heap)
+{
+    return heap->count == 0;
+}
+
+/**
+ * The smallest key of any vertex in the heap.
+ * The heap must not be empty.
+ */
+static inline int
+heap_min_key(struct heap const*heap)
+{
+    return heap->keys[heap->items[0]];
+}
+
+#endif // heap_H
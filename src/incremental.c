@@ -0,0 +1,153 @@
+#include "incremental.h"
+
+static void mark_affected(struct workspace*, unsigned int, unsigned int,
+        int const*);
+static inline bool affected(struct workspace const*, unsigned int);
+static inline void improve(struct workspace*, unsigned int, unsigned int,
+        int, int*, int*);
+
+/*
+ * Applies a batch of edge weight changes to the matrix, and
+ * repairs the paths and distances from the source to match.
+ *
+ *  1. Apply the changes, noting which tree edges they broke:
+ *     those whose weight no longer adds up to the distance of
+ *     the vertex they lead to.
+ *  2. Mark the subtrees under the broken edges as affected, and
+ *     forget their distances and paths; every other distance is
+ *     still right, since no increase is on its tree path and no
+ *     decrease can have lengthened it.
+ *  3. Queue each affected vertex at its best distance through
+ *     an unaffected vertex, and the target of each lightened
+ *     edge at its distance through it if that's shorter.
+ *  4. Run Dijkstra's algorithm from the queue; vertices only go
+ *     back on the queue when their distance improves, so this
+ *     stops at the edge of the affected region.
+ */
+bool
+incremental_update(struct workspace *ws, struct matrix *matrix,
+        unsigned int source, struct edge_update const*updates,
+        unsigned int nupdates, int *paths, int *distances)
+{
+    const unsigned int size = matrix->size;
+    for (unsigned int i = 0; i < nupdates; i += 1) {
+        if (updates[i].from >= size || updates[i].to >= size
+                || !matrix_can_store(matrix->format, updates[i].weight))
+            return false;
+    }
+
+    for (unsigned int i = 0; i < nupdates; i += 1)
+        matrix_set_weight(matrix, updates[i].from, updates[i].to,
+                updates[i].weight);
+
+    // The marks say which vertices are affected: `seen` for the
+    // roots of broken subtrees, then for the whole subtrees.
+    workspace_begin(ws);
+    bool broken = false;
+    for (unsigned int i = 0; i < nupdates; i += 1) {
+        const unsigned int v = updates[i].from;
+        const unsigned int w = updates[i].to;
+        if (w == source || paths[w] != (int) v) continue;
+        const int weight = matrix_weight(matrix, v, w);
+        if (weight == -1 || distances[v] + weight > distances[w]) {
+            ws->marks[w] = ws->seen;
+            broken = true;
+        }
+    }
+
+    if (broken) {
+        mark_affected(ws, size, source, paths);
+        for (unsigned int w = 0; w < size; w += 1) {
+            if (!affected(ws, w)) continue;
+            distances[w] = -1;
+            paths[w] = -1;
+        }
+
+        // Best distance to each affected vertex through an
+        // unaffected one.
+        for (unsigned int w = 0; w < size; w += 1) {
+            if (!affected(ws, w)) continue;
+            for (unsigned int v = 0; v < size; v += 1) {
+                if (distances[v] == -1 || affected(ws, v)) continue;
+                const int weight = matrix_weight(matrix, v, w);
+                if (weight != -1)
+                    improve(ws, v, w, distances[v] + weight, paths, distances);
+            }
+        }
+    }
+
+    // Shortcuts through the lightened edges, from vertices whose
+    // distances are known; the affected vertices' edges are all
+    // relaxed once they're settled anyway.
+    for (unsigned int i = 0; i < nupdates; i += 1) {
+        const unsigned int v = updates[i].from;
+        const int weight = matrix_weight(matrix, v, updates[i].to);
+        if (weight == -1 || distances[v] == -1 || affected(ws, v)) continue;
+        improve(ws, v, updates[i].to, distances[v] + weight, paths, distances);
+    }
+
+    while (!heap_empty(ws->heap)) {
+        const unsigned int v = heap_pop(ws->heap);
+        for (unsigned int w = 0; w < size; w += 1) {
+            const int weight = matrix_weight(matrix, v, w);
+            if (weight != -1)
+                improve(ws, v, w, distances[v] + weight, paths, distances);
+        }
+    }
+    return true;
+}
+
+/*
+ * Extend the affected marks from the roots to every vertex whose
+ * path leads back through one of them, and mark the rest as
+ * unaffected with `visited`.
+ *
+ * Each vertex's path is followed back until it reaches a vertex
+ * already decided, then followed again to mark the way, so every
+ * vertex is only passed through a couple of times overall.
+ */
+static void
+mark_affected(struct workspace *ws, unsigned int size, unsigned int source,
+        int const*paths)
+{
+    ws->marks[source] = ws->visited;
+    for (unsigned int v = 0; v < size; v += 1) {
+        unsigned int u = v;
+        while (ws->marks[u] != ws->seen && ws->marks[u] != ws->visited
+                && paths[u] != -1)
+            u = paths[u];
+        // Unreachable vertices aren't affected; nothing changes
+        // for them unless a lighter edge reaches them.
+        const unsigned int mark = (ws->marks[u] == ws->seen)
+            ? ws->seen : ws->visited;
+
+        for (u = v; ws->marks[u] != ws->seen && ws->marks[u] != ws->visited;
+                u = paths[u]) {
+            ws->marks[u] = mark;
+            if (paths[u] == -1) break;
+        }
+    }
+}
+
+/*
+ * Checks whether the vertex is in an affected subtree.
+ */
+static inline bool
+affected(struct workspace const*ws, unsigned int v)
+{
+    return ws->marks[v] == ws->seen;
+}
+
+/*
+ * If the specified distance to w through v is shorter than w's
+ * current one, take it, and queue w to have its edges relaxed.
+ */
+static inline void
+improve(struct workspace *ws, unsigned int v, unsigned int w, int distance,
+        int *paths, int *distances)
+{
+    if (distances[w] != -1 && distances[w] <= distance) return;
+    distances[w] = distance;
+    paths[w] = v;
+    heap_push(ws->heap, w, distance);
+}
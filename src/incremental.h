@@ -0,0 +1,84 @@
+#ifndef incremental_H
+#define incremental_H
+
+/**
+ * @file
+ * Keeps shortest paths from a source up to date as a dense
+ * graph's edge weights change, repairing only the part of the
+ * shortest path tree the changes affect rather than starting
+ * again from scratch.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "matrix.h"
+#include "workspace.h"
+
+/**
+ * A change to the weight of one edge.
+ */
+struct edge_update {
+    /** The vertex the edge leaves. */
+    unsigned int from;
+    /** The vertex the edge arrives at. */
+    unsigned int to;
+    /** The new weight, or -1 to remove the edge. */
+    int weight;
+};
+
+/**
+ * Applies a batch of edge weight changes to the matrix, and
+ * repairs the paths and distances from the source to match,
+ * in the style of Ramalingam and Reps.
+ *
+ * The vertices whose tree paths used an edge which got heavier
+ * or was removed are found by following the paths, and are the
+ * only ones whose distances are forgotten.  Each is then given
+ * the best distance through the vertices whose distances still
+ * hold, and those and the targets of any edges which got lighter
+ * seed a Dijkstra search which only spreads as far as distances
+ * keep improving.  A batch of changes affecting k vertices costs
+ * O(k size) time beyond an O(size) pass over the paths, rather
+ * than the O(size^2) of running again.
+ *
+ * The distances end up the same as a new run's would be, and
+ * the paths a tree of shortest paths, though where there are
+ * ties it may not pick the same ones as a new run would.
+ *
+ * @param ws  a workspace with capacity at least the matrix size,
+ * for its heap.
+ *
+ * @param matrix  the matrix the paths and distances were found
+ * for, which is updated in place; not `MATRIX_IMPLICIT`.
+ *
+ * @param source  the source the paths and distances were found
+ * from.
+ *
+ * @param updates  the changes to make, in order.
+ *
+ * @param nupdates  the number of changes.
+ *
+ * @param paths  the paths from the source, as an engine such as
+ * `dijkstra_matrix` found them, to be repaired.
+ *
+ * @param distances  each node's distance from the source, with
+ * -1 meaning no path, as `dijkstra_distances` copies out, to be
+ * repaired too.
+ *
+ * @return whether the changes were made: false, leaving
+ * everything as it was, if any edge is out of range or any
+ * weight can't be stored in the matrix's format.
+ */
+bool incremental_update(struct workspace * ws,
+                        struct matrix * matrix,
+                        unsigned int source,
+                        struct edge_update const* updates,
+                        unsigned int nupdates,
+                        int * paths,
+                        int * distances);
+
+#endif // incremental_H
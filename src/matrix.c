@@ -0,0 +1,323 @@
+#include <sys/mman.h>
+
+#include "matrix.h"
+
+#define PAGE_SIZE (4096)
+#define HUGE_PAGE_SIZE (2 << 20)
+
+static void *allocate(size_t, enum matrix_pages);
+static void release(void*, size_t, enum matrix_pages);
+static size_t weights_bytes(struct matrix const*);
+static size_t part_bytes(struct matrix const*, unsigned int);
+static size_t presence_bytes(struct matrix const*);
+
+static enum matrix_pages selected_pages = MATRIX_PAGES_DEFAULT;
+
+/*
+ * The narrowest format which can hold every weight from 0
+ * to max_weight, besides its no edge value.
+ */
+enum matrix_format
+matrix_format_for(unsigned int max_weight)
+{
+    if (max_weight < MATRIX_U8_NO_EDGE) return MATRIX_U8;
+    if (max_weight < MATRIX_U16_NO_EDGE) return MATRIX_U16;
+    return MATRIX_INT;
+}
+
+/*
+ * The size in bytes of one weight in the specified format.
+ */
+size_t
+matrix_weight_size(enum matrix_format format)
+{
+    switch (format) {
+    case MATRIX_U16: return sizeof(uint16_t);
+    case MATRIX_U8: return sizeof(uint8_t);
+    case MATRIX_IMPLICIT: return 0;
+    default: return sizeof(int);
+    }
+}
+
+/*
+ * Sets the kind of pages to back the buffers of the matrices
+ * created from now on with.
+ */
+void
+matrix_use_pages(enum matrix_pages pages)
+{
+    selected_pages = pages;
+}
+
+/*
+ * Creates a matrix of the specified size and format,
+ * with the weights uninitialised.
+ */
+struct matrix *
+matrix_create(unsigned int size, enum matrix_format format)
+{
+    struct matrix *matrix = malloc(sizeof(struct matrix));
+    if (matrix == NULL) return NULL;
+
+    matrix->format = format;
+    matrix->size = size;
+    matrix->presence = NULL;
+    matrix->weights = NULL;
+    matrix->implicit = (struct matrix_implicit) {0};
+    matrix->nparts = 0;
+    matrix->parts = NULL;
+    matrix->pages = selected_pages;
+    if (format == MATRIX_IMPLICIT) return matrix;
+
+    matrix->weights = allocate(weights_bytes(matrix), matrix->pages);
+    if (matrix->weights == NULL) {
+        free(matrix);
+        return NULL;
+    }
+    return matrix;
+}
+
+/*
+ * Creates a matrix of the specified size and format, with a
+ * presence bitmap, and with both uninitialised.
+ */
+struct matrix *
+matrix_create_bitmap(unsigned int size, enum matrix_format format)
+{
+    struct matrix *matrix = matrix_create(size, format);
+    if (matrix == NULL) return NULL;
+
+    matrix->presence = allocate(presence_bytes(matrix), matrix->pages);
+    if (matrix->presence == NULL) {
+        matrix_destroy(matrix);
+        return NULL;
+    }
+    return matrix;
+}
+
+/*
+ * Creates a matrix of the specified size and format, partitioned
+ * into nparts blocks of columns, with the weights uninitialised.
+ *
+ * Each block gets its own pages, so that no page straddles two
+ * blocks and the first touch of each block decides where all of
+ * it goes.
+ */
+struct matrix *
+matrix_create_partitioned(unsigned int size, enum matrix_format format,
+        unsigned int nparts)
+{
+    struct matrix *matrix = malloc(sizeof(struct matrix));
+    if (matrix == NULL) return NULL;
+
+    matrix->format = format;
+    matrix->size = size;
+    matrix->weights = NULL;
+    matrix->presence = NULL;
+    matrix->implicit = (struct matrix_implicit) {0};
+    matrix->nparts = nparts;
+    matrix->pages = selected_pages;
+    matrix->parts = calloc(nparts, sizeof(void*));
+    if (matrix->parts == NULL) {
+        free(matrix);
+        return NULL;
+    }
+
+    for (unsigned int part = 0; part < nparts; part += 1) {
+        matrix->parts[part] = allocate(part_bytes(matrix, part),
+                matrix->pages);
+        if (matrix->parts[part] == NULL) {
+            matrix_destroy(matrix);
+            return NULL;
+        }
+    }
+    return matrix;
+}
+
+/*
+ * Sets the matrix's presence bitmap from its weights.
+ *
+ * Parallelise by rows, so that no two threads write the
+ * same word.
+ */
+void
+matrix_mark_presence(struct matrix *matrix)
+{
+    const unsigned int size = matrix->size;
+    const size_t nwords = matrix_presence_words(size);
+    uint64_t *const presence = matrix->presence;
+    // The weights alone, so `matrix_weight` ignores the bitmap.
+    struct matrix weights = *matrix;
+    weights.presence = NULL;
+
+#pragma omp parallel for
+    for (unsigned int v = 0; v < size; v += 1) {
+        uint64_t *const row = presence + v * nwords;
+        for (size_t i = 0; i < nwords; i += 1)
+            row[i] = 0;
+        for (unsigned int w = 0; w < size; w += 1)
+            if (matrix_weight(&weights, v, w) != -1)
+                row[w/64] |= (uint64_t) 1 << (w % 64);
+    }
+}
+
+/*
+ * Checks whether a matrix of the specified format can store
+ * the specified weight, or -1 for no edge.
+ */
+bool
+matrix_can_store(enum matrix_format format, int weight)
+{
+    switch (format) {
+    case MATRIX_IMPLICIT: return false;
+    case MATRIX_U16: return -1 <= weight && weight < MATRIX_U16_NO_EDGE;
+    case MATRIX_U8: return -1 <= weight && weight < MATRIX_U8_NO_EDGE;
+    default: return -1 <= weight;
+    }
+}
+
+/*
+ * Sets the weight of the edge from the vertex v to the vertex w,
+ * keeping the presence bitmap up to date if there is one.
+ */
+void
+matrix_set_weight(struct matrix *matrix, unsigned int v, unsigned int w,
+        int weight)
+{
+    size_t i = (size_t) v * matrix->size + w;
+    void *weights = matrix->weights;
+    if (matrix->parts != NULL) {
+        const unsigned int part = matrix_part_of(matrix->size,
+                matrix->nparts, w);
+        unsigned int min, max;
+        matrix_partition(matrix->size, matrix->nparts, part, &min, &max);
+        weights = matrix->parts[part];
+        i = (size_t) v * (max - min) + (w - min);
+    }
+
+    switch (matrix->format) {
+    case MATRIX_U16:
+        ((uint16_t*) weights)[i] = (weight == -1) ? MATRIX_U16_NO_EDGE : weight;
+        break;
+    case MATRIX_U8:
+        ((uint8_t*) weights)[i] = (weight == -1) ? MATRIX_U8_NO_EDGE : weight;
+        break;
+    default:
+        ((int*) weights)[i] = weight;
+    }
+
+    if (matrix->presence != NULL) {
+        uint64_t *const word = matrix->presence
+            + v * matrix_presence_words(matrix->size) + w/64;
+        const uint64_t bit = (uint64_t) 1 << (w % 64);
+        *word = (weight == -1) ? (*word & ~bit) : (*word | bit);
+    }
+}
+
+/*
+ * Releases a matrix created by `matrix_create`,
+ * `matrix_create_bitmap` or `matrix_create_partitioned`.
+ */
+void
+matrix_destroy(struct matrix *matrix)
+{
+    if (matrix == NULL) return;
+    release(matrix->presence, presence_bytes(matrix), matrix->pages);
+    release(matrix->weights, weights_bytes(matrix), matrix->pages);
+    for (unsigned int part = 0; part < matrix->nparts; part += 1)
+        release(matrix->parts[part], part_bytes(matrix, part), matrix->pages);
+    free(matrix->parts);
+    free(matrix);
+}
+
+/*
+ * Allocate a page aligned buffer backed by the specified kind of
+ * pages, or return NULL on failure.
+ *
+ * Huge pages are mapped directly, in whole huge pages, so that no
+ * other allocation shares them; for transparent ones, the mapping
+ * is made a huge page larger and trimmed to the alignment the
+ * kernel needs to use them.
+ */
+static void *
+allocate(size_t bytes, enum matrix_pages pages)
+{
+    // Keep empty buffers distinct from allocation failure.
+    if (bytes == 0) bytes = 1;
+    if (pages == MATRIX_PAGES_DEFAULT) {
+        void *buffer;
+        return (posix_memalign(&buffer, PAGE_SIZE, bytes) == 0)
+            ? buffer : NULL;
+    }
+
+    const size_t length = (bytes + HUGE_PAGE_SIZE - 1)
+        / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    if (pages == MATRIX_PAGES_EXPLICIT) {
+        void *const buffer = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        return (buffer != MAP_FAILED) ? buffer : NULL;
+    }
+
+    char *const mapping = mmap(NULL, length + HUGE_PAGE_SIZE,
+            PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) return NULL;
+    const size_t head = (HUGE_PAGE_SIZE
+            - (uintptr_t) mapping % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+    char *const buffer = mapping + head;
+    if (head > 0) munmap(mapping, head);
+    munmap(buffer + length, HUGE_PAGE_SIZE - head);
+#ifdef MADV_HUGEPAGE
+    madvise(buffer, length, MADV_HUGEPAGE);
+#endif
+    return buffer;
+}
+
+/*
+ * Release a buffer from `allocate` of the specified size and kind
+ * of pages.  Does nothing for NULL.
+ */
+static void
+release(void *buffer, size_t bytes, enum matrix_pages pages)
+{
+    if (buffer == NULL) return;
+    if (pages == MATRIX_PAGES_DEFAULT) {
+        free(buffer);
+        return;
+    }
+    if (bytes == 0) bytes = 1;
+    munmap(buffer, (bytes + HUGE_PAGE_SIZE - 1)
+            / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+}
+
+/*
+ * The size in bytes of an unpartitioned matrix's weights.
+ */
+static size_t
+weights_bytes(struct matrix const*matrix)
+{
+    return (size_t) matrix->size * matrix->size
+        * matrix_weight_size(matrix->format);
+}
+
+/*
+ * The size in bytes of the specified block of a partitioned
+ * matrix's weights.
+ */
+static size_t
+part_bytes(struct matrix const*matrix, unsigned int part)
+{
+    unsigned int min, max;
+    matrix_partition(matrix->size, matrix->nparts, part, &min, &max);
+    return (size_t) matrix->size * (max - min)
+        * matrix_weight_size(matrix->format);
+}
+
+/*
+ * The size in bytes of a matrix's presence bitmap.
+ */
+static size_t
+presence_bytes(struct matrix const*matrix)
+{
+    return (size_t) matrix->size * matrix_presence_words(matrix->size)
+        * sizeof(uint64_t);
+}
@@ -0,0 +1,330 @@
+#ifndef matrix_H
+#define matrix_H
+
+/**
+ * @file
+ * Dense adjacency matrices with a choice of weight widths,
+ * so that graphs with small weights take less memory and
+ * less bandwidth to scan.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * The ways a matrix's weights can be stored.
+ */
+enum matrix_format {
+    /** `int` weights, with -1 meaning no edge. */
+    MATRIX_INT,
+    /** `uint16_t` weights, with `MATRIX_U16_NO_EDGE` meaning no edge. */
+    MATRIX_U16,
+    /** `uint8_t` weights, with `MATRIX_U8_NO_EDGE` meaning no edge. */
+    MATRIX_U8,
+    /**
+     * No stored weights at all: each weight is computed when it
+     * is needed by hashing the generator's seed with the cell's
+     * index, so the graph takes no memory whatever its size.
+     */
+    MATRIX_IMPLICIT,
+};
+
+/**
+ * The kinds of pages a matrix's buffers can be backed by.
+ *
+ * A row scan of a large matrix touches a new 4KB page every few
+ * thousand weights, and each needs a TLB entry; 2MB huge pages
+ * cut those misses by a factor of 512.
+ */
+enum matrix_pages {
+    /** Ordinary pages. */
+    MATRIX_PAGES_DEFAULT,
+    /**
+     * Transparent huge pages: huge page aligned buffers which the
+     * kernel is advised to back with huge pages, when it can.
+     */
+    MATRIX_PAGES_TRANSPARENT,
+    /**
+     * Explicit huge pages, from the pool the administrator reserved
+     * with `vm.nr_hugepages`; allocation fails if it's too small.
+     */
+    MATRIX_PAGES_EXPLICIT,
+};
+
+/** The `MATRIX_U16` weight meaning no edge. */
+#define MATRIX_U16_NO_EDGE (UINT16_MAX)
+
+/** The `MATRIX_U8` weight meaning no edge. */
+#define MATRIX_U8_NO_EDGE (UINT8_MAX)
+
+/**
+ * What an implicit matrix's weights are computed from.
+ */
+struct matrix_implicit {
+    /** The hashed seed. */
+    uint64_t key;
+    /** Cells whose hashes' upper 32 bits are below this have edges. */
+    uint64_t threshold;
+    /** The upper bound edge weight. */
+    unsigned int max_weight;
+};
+
+/**
+ * A weighted adjacency matrix.
+ *
+ * The weight of the edge from the vertex v to the vertex w is
+ * element `v*size + w` of `weights`, which is an array of the
+ * type given by `format`.
+ *
+ * A matrix may also have a presence bitmap, with bit `w % 64`
+ * of word `v*matrix_presence_words(size) + w/64` set if and
+ * only if there is an edge from v to w.  The engines then only
+ * read the weights of the edges which are present, and skip
+ * whole words of absent edges, which pays off for sparse graphs.
+ *
+ * Or a matrix may be partitioned: split into `nparts` blocks
+ * of columns, as `matrix_partition` splits them, with each
+ * block stored row by row in its own page aligned buffer.
+ * When each block is first touched by the threads that sweep
+ * it, a whole block lands on their NUMA node, rather than just
+ * the pages of it that no other node's columns share.
+ */
+struct matrix {
+    /** How the weights are stored. */
+    enum matrix_format format;
+    /** The number of vertices in the graph. */
+    unsigned int size;
+    /** The weights; not owned unless made by `matrix_create`. */
+    void *weights;
+    /** The presence bitmap, or NULL if there is none. */
+    uint64_t *presence;
+    /** For `MATRIX_IMPLICIT`, what the weights are computed from. */
+    struct matrix_implicit implicit;
+    /** The number of blocks of columns, or 0 if not partitioned. */
+    unsigned int nparts;
+    /**
+     * For partitioned matrices, the blocks, in place of `weights`:
+     * the weight from v to w is element `v*(max - min) + (w - min)`
+     * of the block whose columns are `min` to `max`.
+     */
+    void **parts;
+    /** The kind of pages the matrix's own buffers are backed by. */
+    enum matrix_pages pages;
+};
+
+/**
+ * Finds the columns, `min` (inclusive) to `max` (exclusive),
+ * of the specified part of a matrix split into nparts blocks.
+ * The last part takes any remainder.
+ *
+ * It's how the dense parallel engines split each row between
+ * their threads, so memory first touched by this split is local
+ * to the threads that will read it.
+ */
+static inline void
+matrix_partition(unsigned int size, unsigned int nparts, unsigned int part,
+        unsigned int *min, unsigned int *max)
+{
+    *min = part * (size / nparts);
+    *max = (part < nparts-1) ? (part+1) * (size / nparts) : size;
+}
+
+/**
+ * The part of a matrix split into nparts blocks, by
+ * `matrix_partition`, which holds the column w.
+ */
+static inline unsigned int
+matrix_part_of(unsigned int size, unsigned int nparts, unsigned int w)
+{
+    const unsigned int width = size / nparts;
+    if (width == 0) return nparts-1;
+    return (w / width < nparts) ? w / width : nparts-1;
+}
+
+/**
+ * The SplitMix64 finaliser; a bijection scrambling every bit
+ * of x into every bit of the result.
+ */
+static inline uint64_t
+matrix_hash(uint64_t x)
+{
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * The weight of the specified cell, `v*size + w`, of an
+ * implicit matrix, with -1 meaning no edge.
+ * The upper half of the cell's hash decides whether it has an
+ * edge, and the lower half picks the edge's weight.
+ */
+static inline int
+matrix_implicit_weight(struct matrix_implicit const*implicit, size_t cell)
+{
+    const uint64_t rng = matrix_hash(
+            implicit->key + (cell + 1) * 0x9E3779B97F4A7C15ull);
+    return ((rng >> 32) < implicit->threshold)
+        ? (int) ((uint32_t) rng % (implicit->max_weight+1)) : -1;
+}
+
+/**
+ * The number of 64 bit words in each row of a presence bitmap
+ * for a matrix of the specified size.
+ */
+static inline size_t
+matrix_presence_words(unsigned int size)
+{
+    return ((size_t) size + 63) / 64;
+}
+
+/**
+ * The narrowest format which can hold every weight from 0
+ * to max_weight, besides its no edge value.
+ */
+enum matrix_format matrix_format_for(unsigned int max_weight);
+
+/**
+ * The size in bytes of one weight in the specified format.
+ */
+size_t matrix_weight_size(enum matrix_format format);
+
+/**
+ * Sets the kind of pages to back the buffers of the matrices
+ * created from now on with; `MATRIX_PAGES_DEFAULT` until set.
+ * Not thread safe; set it before creating any matrices.
+ */
+void matrix_use_pages(enum matrix_pages pages);
+
+/**
+ * Creates a matrix of the specified size and format,
+ * with the weights uninitialised.
+ * `MATRIX_IMPLICIT` matrices have no weights to allocate;
+ * their parameters are set by `pgenerate_matrix`.
+ *
+ * @return the new matrix, to be released with `matrix_destroy`,
+ * or NULL if memory could not be allocated.
+ */
+struct matrix *matrix_create(unsigned int size, enum matrix_format format);
+
+/**
+ * Creates a matrix of the specified size and format, with a
+ * presence bitmap, and with both uninitialised.
+ * Not for `MATRIX_IMPLICIT` matrices.
+ *
+ * @return the new matrix, to be released with `matrix_destroy`,
+ * or NULL if memory could not be allocated.
+ */
+struct matrix *matrix_create_bitmap(unsigned int size,
+                                    enum matrix_format format);
+
+/**
+ * Creates a matrix of the specified size and format, partitioned
+ * into nparts blocks of columns, with the weights uninitialised.
+ * Not for `MATRIX_IMPLICIT` matrices.
+ *
+ * The blocks are placed in memory by whichever threads touch
+ * them first, which `pgenerate_matrix` arranges to be those
+ * that sweep them, so use one part per NUMA node (or thread).
+ *
+ * @param nparts  the number of blocks of columns; positive.
+ *
+ * @return the new matrix, to be released with `matrix_destroy`,
+ * or NULL if memory could not be allocated.
+ */
+struct matrix *matrix_create_partitioned(unsigned int size,
+                                         enum matrix_format format,
+                                         unsigned int nparts);
+
+/**
+ * Sets the matrix's presence bitmap from its weights,
+ * in parallel over the rows.
+ *
+ * @param matrix  a matrix with a presence bitmap.
+ */
+void matrix_mark_presence(struct matrix * matrix);
+
+/**
+ * Checks whether a matrix of the specified format can store
+ * the specified weight, or -1 for no edge.  Implicit matrices
+ * can't store any.
+ */
+bool matrix_can_store(enum matrix_format format, int weight);
+
+/**
+ * Sets the weight of the edge from the vertex v to the vertex w,
+ * keeping the presence bitmap up to date if there is one.
+ *
+ * @param weight  the new weight, or -1 for no edge; one which
+ * `matrix_can_store` says the matrix's format can store.
+ */
+void matrix_set_weight(struct matrix * matrix,
+                       unsigned int v,
+                       unsigned int w,
+                       int weight);
+
+/**
+ * Releases a matrix created by `matrix_create`,
+ * `matrix_create_bitmap` or `matrix_create_partitioned`.
+ */
+void matrix_destroy(struct matrix *matrix);
+
+/**
+ * Wraps an existing `int` matrix, with -1 meaning no edge,
+ * without copying it.
+ */
+static inline struct matrix
+matrix_of_ints(int const*edges, unsigned int size)
+{
+    struct matrix matrix = {
+        .format = MATRIX_INT, .size = size, .weights = (void*) edges
+    };
+    return matrix;
+}
+
+/**
+ * The weight of the edge from the vertex v to the vertex w,
+ * with -1 meaning no edge, whatever the format.
+ *
+ * For occasional lookups; the engines read whole rows
+ * in their native format.
+ */
+static inline int
+matrix_weight(struct matrix const*matrix, unsigned int v, unsigned int w)
+{
+    if (matrix->presence != NULL) {
+        const uint64_t word = matrix->presence[
+            v * matrix_presence_words(matrix->size) + w/64];
+        if (!(word >> (w % 64) & 1)) return -1;
+    }
+
+    size_t i = (size_t) v * matrix->size + w;
+    if (matrix->format == MATRIX_IMPLICIT)
+        return matrix_implicit_weight(&matrix->implicit, i);
+
+    void const*weights = matrix->weights;
+    if (matrix->parts != NULL) {
+        const unsigned int part = matrix_part_of(matrix->size,
+                matrix->nparts, w);
+        unsigned int min, max;
+        matrix_partition(matrix->size, matrix->nparts, part, &min, &max);
+        weights = matrix->parts[part];
+        i = (size_t) v * (max - min) + (w - min);
+    }
+
+    switch (matrix->format) {
+    case MATRIX_U16: {
+        const uint16_t weight = ((uint16_t const*) weights)[i];
+        return (weight == MATRIX_U16_NO_EDGE) ? -1 : weight;
+    }
+    case MATRIX_U8: {
+        const uint8_t weight = ((uint8_t const*) weights)[i];
+        return (weight == MATRIX_U8_NO_EDGE) ? -1 : weight;
+    }
+    default:
+        return ((int const*) weights)[i];
+    }
+}
+
+#endif // matrix_H
@@ -0,0 +1,84 @@
+#include "mpidijkstra.h"
+#include "sweep.h"
+
+/*
+ * Finds the block of columns (vertices) owned by the specified
+ * rank, from `min` (inclusive) to `max` (exclusive).
+ * The last rank gets any remainder.
+ */
+void
+mpidijkstra_block(unsigned int size, int rank, int nranks,
+        unsigned int *min, unsigned int *max)
+{
+    *min = rank * (size / nranks);
+    *max = (rank < (nranks-1)) ? (rank+1) * (size / nranks) : size;
+}
+
+/*
+ * Applies Dijkstra's algorithm to the distributed input graph
+ * with the specified source.
+ *
+ * @param block  this rank's block of the matrix of edge weights.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * @param source  the id of the node to visit as the source for the
+ * algorithm; non-negative, less than size.
+ *
+ * @param paths  the buffer in which to place this rank's slice of
+ * the paths.
+ *
+ * @param comm  the communicator the matrix is distributed over.
+ *
+ * The local sweep is `sweep_row` over the rank's slices, which are
+ * indexed from zero, so local candidates are offset by `min` to
+ * get global vertex ids.  Ranks with no candidate contribute an
+ * infinite distance, and MINLOC breaks distance ties by the
+ * lower vertex, as `dijkstra` does.
+ */
+void
+mpidijkstra(int const*block, unsigned int size, unsigned int source,
+        int *paths, MPI_Comm comm)
+{
+    int rank, nranks;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nranks);
+    unsigned int min, max;
+    mpidijkstra_block(size, rank, nranks, &min, &max);
+    const unsigned int ncols = max - min;
+
+    unsigned int *states = malloc((ncols + 1) * sizeof(unsigned int));
+    // The other ranks would wait in the reduction forever.
+    if (states == NULL) {
+        fprintf(stderr, "rank %d couldn't allocate its vertex states\n", rank);
+        MPI_Abort(comm, 1);
+    }
+    for (unsigned int i = 0; i < ncols; i += 1) {
+        states[i] = STATE_UNSEEN;
+        paths[i] = -1;
+    }
+    if (min <= source && source < max)
+        paths[source - min] = source;
+
+    struct { int distance; int v; } nearest = { 0, source };
+    // For (at most) every vertex:
+    while (nearest.distance != INT_MAX) {
+        const unsigned int v = nearest.v;
+        const unsigned int vstate = state_at(nearest.distance);
+        if (min <= v && v < max) states[v - min] = vstate | STATE_VISITED;
+
+        const uint64_t local = sweep_row(block + (size_t) v*ncols, v, vstate,
+                states, paths, 0, ncols);
+        if (local == CANDIDATE_NONE) {
+            nearest.distance = INT_MAX;
+            nearest.v = size;
+        } else {
+            nearest.distance = state_distance(candidate_state(local));
+            nearest.v = candidate_vertex(local) + min;
+        }
+
+        MPI_Allreduce(MPI_IN_PLACE, &nearest, 1, MPI_2INT, MPI_MINLOC, comm);
+    }
+
+    free(states);
+}
@@ -0,0 +1,64 @@
+#ifndef mpidijkstra_H
+#define mpidijkstra_H
+
+/**
+ * @file
+ * Distributed memory implementation of Dijkstra's algorithm,
+ * with the adjacency matrix partitioned into column blocks.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <mpi.h>
+
+/**
+ * Finds the block of columns (vertices) owned by the specified
+ * rank, from `min` (inclusive) to `max` (exclusive).
+ * The last rank gets any remainder.
+ */
+void mpidijkstra_block(unsigned int size,
+                       int rank,
+                       int nranks,
+                       unsigned int * min,
+                       unsigned int * max);
+
+/**
+ * Applies Dijkstra's algorithm to the distributed input graph
+ * with the specified source.
+ *
+ * Must be called collectively by every rank of the communicator.
+ * Each rank owns the block of columns given by `mpidijkstra_block`,
+ * and is responsible for the distances and paths of those vertices.
+ * On each iteration, each rank relaxes its block of the visited
+ * vertex's row, finding its nearest vertex in the same pass,
+ * then the nearest vertex overall is agreed on with an
+ * `MPI_Allreduce` using `MPI_MINLOC`.
+ *
+ * Produces the same paths as `dijkstra` on the whole matrix.
+ *
+ * @param block  this rank's block of the matrix of edge weights.
+ * `block[v*(max - min) + (w - min)]` should be the weight of the
+ * edge from the vertex v to the vertex w, with -1 meaning no edge.
+ *
+ * @param size  the number of nodes in the graph; positive,
+ * at most `INT_MAX`.
+ *
+ * @param source  the id of the node to use as the source for the
+ * algorithm; non-negative, less than size.
+ *
+ * @param paths  the buffer in which to place this rank's slice of
+ * the paths, with `paths[w - min]` being the predecessor of w.
+ *
+ * @param comm  the communicator the matrix is distributed over.
+ * It's aborted if any rank can't allocate its buffers.
+ */
+void mpidijkstra(int const* block,
+                 unsigned int size,
+                 unsigned int source,
+                 int * paths,
+                 MPI_Comm comm);
+
+#endif // mpidijkstra_H
@@ -0,0 +1,335 @@
+#include "p2p.h"
+#include "batch.h"
+#include "sdijkstra.h"
+
+static bool prepare_landmarks(struct p2p*);
+static int search(struct p2p*, unsigned int, unsigned int, bool, int*);
+static int bidirectional(struct p2p*, unsigned int, unsigned int, int*);
+static inline int lower_bound(struct p2p const*, unsigned int, unsigned int);
+static inline void start(struct workspace*, unsigned int, int);
+static inline int distance_of(struct workspace const*, unsigned int);
+static void join_paths(struct p2p*, unsigned int, unsigned int,
+        unsigned int, int*);
+
+/** A lower bound meaning the target can't be reached at all. */
+#define UNREACHABLE (INT_MAX)
+
+/*
+ * Prepares for point to point queries over the specified graph.
+ */
+struct p2p *
+p2p_create(struct csr_graph const*graph, unsigned int nlandmarks)
+{
+    struct p2p *p2p = calloc(1, sizeof(struct p2p));
+    if (p2p == NULL) return NULL;
+
+    const unsigned int size = graph->size;
+    p2p->graph = graph;
+    p2p->nlandmarks = (nlandmarks < size) ? nlandmarks : size;
+    p2p->reverse = csr_transpose(graph);
+    p2p->forward = workspace_create(size);
+    p2p->backward = workspace_create(size);
+    p2p->successors = malloc(size * sizeof(int));
+    p2p->on_path = calloc(size, sizeof(unsigned int));
+    if (p2p->reverse == NULL || p2p->forward == NULL || p2p->backward == NULL
+            || p2p->successors == NULL || p2p->on_path == NULL
+            || !prepare_landmarks(p2p)) {
+        p2p_destroy(p2p);
+        return NULL;
+    }
+    return p2p;
+}
+
+/*
+ * Releases query state created by `p2p_create`.
+ */
+void
+p2p_destroy(struct p2p *p2p)
+{
+    if (p2p == NULL) return;
+    csr_free(p2p->reverse);
+    free(p2p->landmarks);
+    free(p2p->from_landmarks);
+    free(p2p->to_landmarks);
+    workspace_destroy(p2p->forward);
+    workspace_destroy(p2p->backward);
+    free(p2p->successors);
+    free(p2p->on_path);
+    free(p2p);
+}
+
+/*
+ * Finds the shortest path from the source to the target.
+ */
+int
+p2p_query(struct p2p *p2p, unsigned int source, unsigned int target,
+        enum p2p_mode mode, int *paths)
+{
+    p2p->settled = 0;
+    switch (mode) {
+    case P2P_BIDIRECTIONAL:
+        return bidirectional(p2p, source, target, paths);
+    case P2P_ALT:
+        return search(p2p, source, target, p2p->nlandmarks > 0, paths);
+    default:
+        return search(p2p, source, target, false, paths);
+    }
+}
+
+/*
+ * Picks the landmarks and fills in their distance tables.
+ *
+ * Each landmark after the first is the vertex farthest from its
+ * nearest landmark so far, among those any landmark reaches, so
+ * that the landmarks end up spread around the edge of the graph,
+ * where their bounds are tightest.  The distances from them come
+ * out of the search for the next one for free.
+ * Returns false if memory could not be allocated.
+ */
+static bool
+prepare_landmarks(struct p2p *p2p)
+{
+    const unsigned int size = p2p->graph->size;
+    const unsigned int nlandmarks = p2p->nlandmarks;
+    if (nlandmarks == 0) return true;
+
+    const size_t table = (size_t) nlandmarks * size;
+    p2p->landmarks = malloc(nlandmarks * sizeof(unsigned int));
+    p2p->from_landmarks = malloc(table * sizeof(int));
+    p2p->to_landmarks = malloc(table * sizeof(int));
+    int *paths = malloc(table * sizeof(int));
+    int *nearest = malloc(size * sizeof(int));
+    if (p2p->landmarks == NULL || p2p->from_landmarks == NULL
+            || p2p->to_landmarks == NULL || paths == NULL || nearest == NULL) {
+        free(paths);
+        free(nearest);
+        return false;
+    }
+
+    for (unsigned int v = 0; v < size; v += 1)
+        nearest[v] = -1;
+
+    unsigned int landmark = 0;
+    for (unsigned int i = 0; i < nlandmarks; i += 1) {
+        int *const from = p2p->from_landmarks + (size_t) i*size;
+        p2p->landmarks[i] = landmark;
+        sdijkstra_with(p2p->forward, p2p->graph, landmark, paths);
+        sdijkstra_distances(p2p->forward, size, from);
+
+        int farthest = -1;
+        for (unsigned int v = 0; v < size; v += 1) {
+            if (from[v] != -1 && (nearest[v] == -1 || from[v] < nearest[v]))
+                nearest[v] = from[v];
+            if (nearest[v] > farthest) {
+                farthest = nearest[v];
+                landmark = v;
+            }
+        }
+    }
+
+    const bool found = batch_sdijkstra(p2p->reverse, p2p->landmarks,
+            nlandmarks, paths, p2p->to_landmarks);
+    free(paths);
+    free(nearest);
+    return found;
+}
+
+/*
+ * Searches from the source until the target is settled, like
+ * `sdijkstra`, or with `use_landmarks` as A* search with the
+ * landmarks' lower bounds added to the keys.
+ *
+ * The landmark bounds are consistent, so no settled vertex ever
+ * needs settling again, and vertices which the bounds show can't
+ * reach the target are never queued at all.
+ */
+static int
+search(struct p2p *p2p, unsigned int source, unsigned int target,
+        bool use_landmarks, int *paths)
+{
+    struct csr_graph const*const graph = p2p->graph;
+    struct workspace *const ws = p2p->forward;
+    const int source_bound = (use_landmarks)
+        ? lower_bound(p2p, source, target) : 0;
+    if (source_bound == UNREACHABLE) return -1;
+
+    start(ws, source, source_bound);
+    paths[source] = source;
+
+    while (!heap_empty(ws->heap)) {
+        const unsigned int v = heap_pop(ws->heap);
+        ws->marks[v] = ws->visited;
+        p2p->settled += 1;
+        if (v == target) return ws->distances[v];
+
+        const int vdistance = ws->distances[v];
+        for (size_t e = graph->offsets[v]; e < graph->offsets[v+1]; e += 1) {
+            const unsigned int w = graph->targets[e];
+            if (ws->marks[w] == ws->visited) continue;
+
+            const int bound = (use_landmarks) ? lower_bound(p2p, w, target) : 0;
+            if (bound == UNREACHABLE) continue;
+            if (ws->marks[w] != ws->seen) {
+                ws->marks[w] = ws->seen;
+                ws->distances[w] = INT_MAX;
+            }
+
+            if (ws->distances[w] > vdistance + graph->weights[e]) {
+                ws->distances[w] = vdistance + graph->weights[e];
+                paths[w] = v;
+                heap_push(ws->heap, w, ws->distances[w] + bound);
+            }
+        }
+    }
+    return -1;
+}
+
+/*
+ * Searches forwards from the source and backwards from the
+ * target at once, always advancing whichever search has the
+ * nearer frontier.  Whenever an edge joins the two searches,
+ * the path through it is a candidate for the shortest; the
+ * best candidate is the shortest once the frontiers' distances
+ * add up to at least its length.
+ */
+static int
+bidirectional(struct p2p *p2p, unsigned int source, unsigned int target,
+        int *paths)
+{
+    struct workspace *const sides[2] = { p2p->forward, p2p->backward };
+    struct csr_graph const*const graphs[2] = { p2p->graph, p2p->reverse };
+    int *const trees[2] = { paths, p2p->successors };
+
+    start(p2p->forward, source, 0);
+    start(p2p->backward, target, 0);
+    paths[source] = source;
+    p2p->successors[target] = target;
+
+    int best = (source == target) ? 0 : -1;
+    unsigned int meeting = source;
+    while (!heap_empty(p2p->forward->heap) && !heap_empty(p2p->backward->heap)) {
+        const int forward_key = heap_min_key(p2p->forward->heap);
+        const int backward_key = heap_min_key(p2p->backward->heap);
+        if (best != -1 && forward_key + backward_key >= best) break;
+
+        const int side = (forward_key <= backward_key) ? 0 : 1;
+        struct workspace *const ws = sides[side];
+        struct workspace const*const other = sides[1 - side];
+        struct csr_graph const*const graph = graphs[side];
+        int *const tree = trees[side];
+
+        const unsigned int v = heap_pop(ws->heap);
+        ws->marks[v] = ws->visited;
+        p2p->settled += 1;
+
+        const int vdistance = ws->distances[v];
+        for (size_t e = graph->offsets[v]; e < graph->offsets[v+1]; e += 1) {
+            const unsigned int w = graph->targets[e];
+            if (ws->marks[w] == ws->visited) continue;
+            if (ws->marks[w] != ws->seen) {
+                ws->marks[w] = ws->seen;
+                ws->distances[w] = INT_MAX;
+            }
+
+            if (ws->distances[w] > vdistance + graph->weights[e]) {
+                ws->distances[w] = vdistance + graph->weights[e];
+                tree[w] = v;
+                heap_push(ws->heap, w, ws->distances[w]);
+
+                const int rest = distance_of(other, w);
+                if (rest != -1 && (best == -1
+                            || ws->distances[w] + rest < best)) {
+                    best = ws->distances[w] + rest;
+                    meeting = w;
+                }
+            }
+        }
+    }
+
+    if (best != -1 && source != target) join_paths(p2p, source, target, meeting, paths);
+    return best;
+}
+
+/*
+ * A lower bound on the distance from v to the target, from the
+ * triangle inequality with each landmark L:
+ *
+ *     d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L)
+ *
+ * Or `UNREACHABLE` if some landmark shows there's no path:
+ * one which reaches v but not t, or which t reaches but v can't.
+ */
+static inline int
+lower_bound(struct p2p const*p2p, unsigned int v, unsigned int target)
+{
+    const unsigned int size = p2p->graph->size;
+    int bound = 0;
+    for (unsigned int i = 0; i < p2p->nlandmarks; i += 1) {
+        int const*const from = p2p->from_landmarks + (size_t) i*size;
+        int const*const to = p2p->to_landmarks + (size_t) i*size;
+
+        if (from[v] != -1) {
+            if (from[target] == -1) return UNREACHABLE;
+            if (from[target] - from[v] > bound) bound = from[target] - from[v];
+        }
+        if (to[target] != -1) {
+            if (to[v] == -1) return UNREACHABLE;
+            if (to[v] - to[target] > bound) bound = to[v] - to[target];
+        }
+    }
+    return bound;
+}
+
+/*
+ * Start a new search in the workspace from the specified vertex,
+ * queued with the specified key.
+ */
+static inline void
+start(struct workspace *ws, unsigned int v, int key)
+{
+    workspace_begin(ws);
+    ws->marks[v] = ws->seen;
+    ws->distances[v] = 0;
+    heap_push(ws->heap, v, key);
+}
+
+/*
+ * The best distance the search in the workspace has found to v
+ * so far, or -1 if it hasn't reached v.
+ */
+static inline int
+distance_of(struct workspace const*ws, unsigned int v)
+{
+    return (ws->marks[v] == ws->seen || ws->marks[v] == ws->visited)
+        ? ws->distances[v] : -1;
+}
+
+/*
+ * Extend the forward search's paths from the meeting vertex on
+ * to the target, along the backward search's successors.
+ *
+ * With zero weight edges, the two halves may cross; any vertex
+ * on both is already on the forward half, so the path skips to
+ * it instead of overwriting its predecessor with a cycle.
+ */
+static void
+join_paths(struct p2p *p2p, unsigned int source, unsigned int target,
+        unsigned int meeting, int *paths)
+{
+    p2p->query += 1;
+    if (p2p->query == 0) {
+        memset(p2p->on_path, 0, p2p->graph->size * sizeof(unsigned int));
+        p2p->query = 1;
+    }
+
+    for (unsigned int v = meeting; v != source; v = paths[v])
+        p2p->on_path[v] = p2p->query;
+    p2p->on_path[source] = p2p->query;
+
+    unsigned int v = meeting;
+    while (v != target) {
+        const unsigned int w = p2p->successors[v];
+        if (p2p->on_path[w] != p2p->query) paths[w] = v;
+        v = w;
+    }
+}
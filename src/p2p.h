@@ -0,0 +1,128 @@
+#ifndef p2p_H
+#define p2p_H
+
+/**
+ * @file
+ * Point to point shortest path queries, which stop as soon as
+ * the target's distance is known instead of finding the paths
+ * to every vertex.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "csrgraph.h"
+#include "workspace.h"
+
+/**
+ * The ways a point to point query can search.
+ */
+enum p2p_mode {
+    /** Dijkstra's algorithm from the source, until the target. */
+    P2P_DIJKSTRA,
+    /**
+     * Dijkstra's algorithm from the source over the graph and from
+     * the target over its transpose at once, until they meet.
+     */
+    P2P_BIDIRECTIONAL,
+    /**
+     * A* search from the source, with lower bounds on the distance
+     * to the target from the triangle inequality with each of a few
+     * landmarks (ALT), whose distances to and from every vertex are
+     * precomputed.
+     */
+    P2P_ALT,
+};
+
+/**
+ * Everything needed to answer point to point queries over one
+ * graph: its transpose, the landmark tables, and the buffers for
+ * the searches, so that queries don't allocate.
+ */
+struct p2p {
+    /** The graph; not owned. */
+    struct csr_graph const*graph;
+    /** The graph's transpose, for searching backwards. */
+    struct csr_graph *reverse;
+    /** The number of landmarks; 0 if there are none. */
+    unsigned int nlandmarks;
+    /** The landmarks' vertex ids. */
+    unsigned int *landmarks;
+    /**
+     * `from_landmarks[i*size + v]` is the distance from the `i`th
+     * landmark to v, and `to_landmarks[i*size + v]` from v to it,
+     * with -1 meaning no path.
+     */
+    int *from_landmarks;
+    int *to_landmarks;
+    /** The forward search's buffers. */
+    struct workspace *forward;
+    /** The backward search's buffers. */
+    struct workspace *backward;
+    /** Each vertex's successor on the backward search's paths. */
+    int *successors;
+    /** Stamps the vertices on the current query's forward path. */
+    unsigned int *on_path;
+    /** The current query's stamp for `on_path`. */
+    unsigned int query;
+    /** The number of vertices the last query settled. */
+    unsigned long settled;
+};
+
+/**
+ * Prepares for point to point queries over the specified graph,
+ * building its transpose and precomputing the distances to and
+ * from the specified number of landmarks for `P2P_ALT`.
+ *
+ * The first landmark is vertex 0, and each of the rest is the
+ * vertex farthest from all of the landmarks so far, found with
+ * `sdijkstra`; the distances to the landmarks come from running
+ * `batch_sdijkstra` over the transpose.
+ *
+ * @param graph  the graph, which must outlive the queries.
+ *
+ * @param nlandmarks  the number of landmarks; 0 to only
+ * answer `P2P_DIJKSTRA` and `P2P_BIDIRECTIONAL` queries.
+ *
+ * @return the new query state, to be released with `p2p_destroy`,
+ * or NULL if memory could not be allocated.
+ */
+struct p2p *p2p_create(struct csr_graph const* graph,
+                       unsigned int nlandmarks);
+
+/**
+ * Releases query state created by `p2p_create`.
+ */
+void p2p_destroy(struct p2p *p2p);
+
+/**
+ * Finds the shortest path from the source to the target.
+ *
+ * @param p2p  the query state; not for more than one query at a time.
+ *
+ * @param source  the id of the node to start from; less than
+ * the graph's size.
+ *
+ * @param target  the id of the node to find the path to; less
+ * than the graph's size.
+ *
+ * @param mode  how to search; `P2P_ALT` needs landmarks.
+ *
+ * @param paths  the buffer in which to place the path, with a
+ * predecessor for each node as `sdijkstra` would.  Only the nodes
+ * on the path from the source to the target are set; following
+ * their predecessors back from the target leads to the source.
+ *
+ * @return the target's distance from the source, or -1
+ * if there's no path to it.
+ */
+int p2p_query(struct p2p * p2p,
+              unsigned int source,
+              unsigned int target,
+              enum p2p_mode mode,
+              int * paths);
+
+#endif // p2p_H
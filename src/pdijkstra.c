@@ -2,10 +2,27 @@
 
 #include "pdijkstra.h"
 
-static inline void prepare_buffers(int, int, int*, int*, bool*, bool*);
-static inline int nearest_vertex(int, bool const*, bool const*, int const*);
-static inline void visit_vertex(int, int const*, int, bool*, int*, int*);
-static inline int thread_nearest_vertex(int, int const*, bool const*, bool const*);
+static inline void prepare_buffers(int, int, unsigned int*, int*);
+static inline uint64_t visit_vertex(uint64_t, struct matrix const*,
+        unsigned int*, int*, struct engine_stats*);
+static inline void thread_range(int, int*, int*);
+
+#define CACHE_LINE_SIZE (64)
+
+/*
+ * A thread's candidate for the nearest vertex, padded out to
+ * its own cache line so that threads publishing their
+ * candidates don't invalidate each other's lines.
+ */
+struct nearest_slot {
+    uint64_t nearest;
+    /** The thread's sweep time, when collecting stats. */
+    double sweep_time;
+    /** The paths the thread's sweep improved, likewise. */
+    unsigned long improvements;
+    char padding[CACHE_LINE_SIZE - sizeof(uint64_t) - sizeof(double)
+        - sizeof(unsigned long)];
+};
 
 // Uncomment for unity tests.
 // static inline int omp_get_max_threads() { return 1; }
@@ -15,15 +32,46 @@ static inline int thread_nearest_vertex(int, int const*, bool const*, bool const
  * Applies Dijkstra's algorithm to the input graph
  * with the specified source, using parallelisation.
  *
+ * @param edges  a buffer containing a matrix of edge weights.
+ * `edges[v*size + w]` should be the weight of the edge from
+ * the vertex v to the vertex w, with -1 meaning no edge.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * @param source  the id of the node to visit as the source for the
+ * algorithm; non-negative, less than size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ *
+ * Paths are repesented by storing each node's predecessor
+ * in the specified buffer, with node ids as the indices.
+ */
+bool
+pdijkstra(int const*edges, unsigned int size, unsigned int source, int *paths)
+{
+    struct workspace *ws = workspace_create(size);
+    if (ws == NULL) return false;
+    pdijkstra_with(ws, edges, size, source, paths);
+    workspace_destroy(ws);
+    return true;
+}
+
+/*
+ * Applies Dijkstra's algorithm to the input graph
+ * with the specified source, using parallelisation
+ * and the buffers of the specified workspace.
+ *
  * Parallelisation:
  *
  *  1. The buffer initialisation is parallelised by having
  *     each processor initialise a subset of the buffer.
- *  2. Finding the nearest vertex is parallelised by using
- *     the parallel min algorithm discussed in lectures.
- *  3. Extending the visited_set is done by having each
- *     processor check neighbour/path details for a subset
- *     of the vertices.
+ *  2. Visiting a vertex is done by having each processor
+ *     relax v's edges to a subset of the vertices, finding
+ *     the nearest vertex of that subset in the same pass.
+ *  3. The nearest vertex overall is found by a `min`
+ *     reduction of each processor's nearest vertex.
+ *
+ * @param ws  the workspace; its capacity at least size.
  *
  * @param edges  a buffer containing a matrix of edge weights.
  * `edges[v*size + w]` should be the weight of the edge from
@@ -35,26 +83,43 @@ static inline int thread_nearest_vertex(int, int const*, bool const*, bool const
  * algorithm; non-negative, less than size.
  *
  * @param paths  the buffer in which to place the paths.
- *
- * Paths are repesented by storing each node's predecessor
- * in the specified buffer, with node ids as the indices.
  */
 void
-pdijkstra(int const*edges, unsigned int size, unsigned int source, int *paths)
+pdijkstra_with(struct workspace *ws, int const*edges, unsigned int size,
+        unsigned int source, int *paths)
+{
+    const struct matrix matrix = matrix_of_ints(edges, size);
+    pdijkstra_matrix(ws, &matrix, source, paths);
+}
+
+/*
+ * Applies Dijkstra's algorithm to a graph given as a matrix
+ * in any format, using parallelisation and the buffers of
+ * the specified workspace.
+ */
+void
+pdijkstra_matrix(struct workspace *ws, struct matrix const*matrix,
+        unsigned int source, int *paths)
 {
     // Can't parallise this function I think... only its subroutines.
-    bool seen_set[size];
-    bool visited_set[size];
-    int distances[size];
-    prepare_buffers(size, source, distances, paths, seen_set, visited_set);
+    unsigned int *const states = ws->states;
+    struct engine_stats *const stats = (STATS_ENABLED) ? ws->stats : NULL;
+    const double start = (stats != NULL) ? stats_now() : 0;
+    prepare_buffers(matrix->size, source, states, paths);
+    if (stats != NULL) stats->prepare_time += stats_now() - start;
 
     // For (at most) every vertex:
-    for (int nvisited = 0; nvisited < size; nvisited += 1) {
-        int v = nearest_vertex(size, seen_set, visited_set, distances);
-        if (v == size) break; // No more seen but unvisited vertices.
-        visited_set[v] = true;
+    unsigned long iteration = 0;
+    uint64_t nearest = candidate(source, states[source]);
+    while (nearest != CANDIDATE_NONE) {
+        nearest = visit_vertex(nearest, matrix, states, paths, stats);
+        iteration += 1;
+    }
 
-        visit_vertex(v, edges, size, seen_set, distances, paths);
+    if (stats != NULL) {
+        stats->runs += 1;
+        stats->exit_iteration = iteration;
+        stats->total_time += stats_now() - start;
     }
 }
 
@@ -64,101 +129,228 @@ pdijkstra(int const*edges, unsigned int size, unsigned int source, int *paths)
  * Begin with the seen set being just the source.
  *
  * Parallelise by making each processer initialise
- * a `p`th of the elements.
+ * the same range of the elements it will sweep, so that
+ * they are first touched by, and so local to, that thread.
  */
 inline static void
-prepare_buffers(int size, int source, int *distances, int *paths,
-        bool *seen_set, bool *visited_set)
+prepare_buffers(int size, int source, unsigned int *states, int *paths)
 {
-#pragma omp parallel for
-    for (int i = 0; i < size; i += 1) {
-        distances[i] = INT_MAX;
-        paths[i] = -1;
-        seen_set[i] = false;
-        visited_set[i] = false;
+#pragma omp parallel
+    {
+        int min, max;
+        thread_range(size, &min, &max);
+        for (int i = min; i < max; i += 1) {
+            states[i] = STATE_UNSEEN;
+            paths[i] = -1;
+        }
     }
-    seen_set[source] = true;
-    distances[source] = 0;
+    states[source] = state_at(0);
     paths[source] = source;
 }
 
 /*
- * Pick the unvisited, but seen vertex with the shortest
- * path from the source.
- * Returns `size` if there are no valid vertices.
+ * Visit the nearest vertex, v, then check each of v's
+ * neighbours, w.  If the path to w through v is shorter than
+ * the previous shortest known path, remember it.
+ * Returns the next nearest vertex as a candidate.
  */
-static inline int
-nearest_vertex(int size, bool const*seen_set, bool const*visited_set,
-        int const*distances)
+static inline uint64_t
+visit_vertex(uint64_t nearest, struct matrix const*matrix,
+        unsigned int *states, int *paths, struct engine_stats *stats)
 {
-    // Parallelise by using the paralel min algorithm.
-    int v = size;
-    int vdistance = INT_MAX;
+    const unsigned int v = candidate_vertex(nearest);
+    const unsigned int vstate = candidate_state(nearest);
+    states[v] = vstate | STATE_VISITED;
+    const double start = (stats != NULL) ? stats_now() : 0;
+    double sweep_times[(stats != NULL) ? omp_get_max_threads() : 1];
+    int nthreads = 1;
 
-    // Have each thread handle a fairly sized chunk of the input.
-#pragma omp parallel shared(v, vdistance)
+    // Parallelise by having each processer check one
+    // `p`th of the vertices as `w`, then reduce each
+    // processor's nearest vertex using `min`.
+    uint64_t next = CANDIDATE_NONE;
+    unsigned long improvements = 0;
+#pragma omp parallel reduction(min: next) reduction(+: improvements)
     {
-        const int my_v = thread_nearest_vertex(size, distances, visited_set, seen_set);
-
-        const int my_vdistance = distances[my_v];
-
-        // Reduce the chunks using `min`.
-#pragma omp critical
-        {
-            if (my_v < size && my_vdistance < vdistance) {
-                vdistance = my_vdistance;
-                v = my_v;
-            }
+        int min, max;
+        thread_range(matrix->size, &min, &max);
+        const double sweep_start = (stats != NULL) ? stats_now() : 0;
+        next = sweep_matrix_row(matrix, v, vstate, states, paths, min, max);
+        if (stats != NULL) {
+            sweep_times[omp_get_thread_num()] = stats_now() - sweep_start;
+            improvements = stats_count_improvements(paths, v, min, max);
+            if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
         }
     }
 
-    return v;
+    if (stats != NULL) {
+        stats_add_iteration(stats, sweep_times, nthreads, stats_now() - start);
+        stats->edges_scanned += matrix->size;
+        stats->improvements += improvements;
+    }
+    return next;
 }
 
-static inline int
-thread_nearest_vertex(int size, int const*distances, bool const*visited_set,
-        bool const*seen_set)
+/*
+ * Find the range of vertices, `min` (inclusive) to `max`
+ * (exclusive), which the calling thread is responsible for.
+ * Last thread should fill out the remaining vertices.
+ * The generator first touches the matrix by the same ranges.
+ */
+static inline void
+thread_range(int size, int *min, int *max)
 {
-    const int nthreads = omp_get_num_threads();
-    const int ithread = omp_get_thread_num();
-    const int min = ithread * (size / nthreads);
-    // Exclusive max.
-    // Last thread should fill out the remaining vertices.
-    const int max = (ithread < (nthreads-1))
-        ? (ithread+1) * (size / nthreads) : size;
-    int v = size; // Return value for function failure.
-    int vdistance = INT_MAX;
-
-    // Find the closest valid vertex in my chunk.
-    for (int u = min; u < max; u += 1) {
-        if (!visited_set[u] && seen_set[u] && (distances[u] < vdistance)) {
-            v = u;
-            vdistance = distances[v];
-        }
-    }
+    unsigned int part_min, part_max;
+    matrix_partition(size, omp_get_num_threads(), omp_get_thread_num(),
+            &part_min, &part_max);
+    *min = part_min;
+    *max = part_max;
+}
+
+/*
+ * Applies Dijkstra's algorithm to the input graph
+ * with the specified source, using a single parallel region.
+ *
+ * @param edges  a buffer containing a matrix of edge weights.
+ * `edges[v*size + w]` should be the weight of the edge from
+ * the vertex v to the vertex w, with -1 meaning no edge.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * @param source  the id of the node to visit as the source for the
+ * algorithm; non-negative, less than size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ */
+bool
+pdijkstra_persistent(int const*edges, unsigned int size, unsigned int source,
+        int *paths)
+{
+    struct workspace *ws = workspace_create(size);
+    if (ws == NULL) return false;
+    pdijkstra_persistent_with(ws, edges, size, source, paths);
+    workspace_destroy(ws);
+    return true;
+}
 
-    return v;
+/*
+ * Applies Dijkstra's algorithm to the input graph
+ * with the specified source, using a single parallel region
+ * and the buffers of the specified workspace.
+ *
+ * Parallelisation:
+ *
+ *  1. Each thread owns the range of vertices given by
+ *     `thread_range` for the whole run, and is the only
+ *     thread to read or write their buffer entries.
+ *     The visited vertex's state comes from its candidate.
+ *  2. Each thread relaxes its range of v's row, finding the
+ *     nearest vertex in its range in the same pass, and
+ *     publishes that to its own slot.  After one barrier
+ *     every thread reduces all of the slots itself.
+ *     The slots alternate between two sets on each iteration,
+ *     so a thread can't overwrite a slot that a slower thread
+ *     is still reducing from the previous iteration.
+ *
+ * @param ws  the workspace; its capacity at least size.
+ *
+ * @param edges  a buffer containing a matrix of edge weights.
+ * `edges[v*size + w]` should be the weight of the edge from
+ * the vertex v to the vertex w, with -1 meaning no edge.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * @param source  the id of the node to visit as the source for the
+ * algorithm; non-negative, less than size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ */
+void
+pdijkstra_persistent_with(struct workspace *ws, int const*edges,
+        unsigned int size, unsigned int source, int *paths)
+{
+    const struct matrix matrix = matrix_of_ints(edges, size);
+    pdijkstra_persistent_matrix(ws, &matrix, source, paths);
 }
 
 /*
- * Check each of v's neighbours, w, marking them as seen.
- * If the path to w through v is shorter than the previous
- * shortest known path, remember it.
+ * Applies Dijkstra's algorithm to a graph given as a matrix
+ * in any format, using a single parallel region and the
+ * buffers of the specified workspace.
  */
-static inline void
-visit_vertex(int v, int const*edges, int size,
-        bool *seen_set, int *distances, int*paths)
+void
+pdijkstra_persistent_matrix(struct workspace *ws, struct matrix const*matrix,
+        unsigned int source, int *paths)
 {
-    // Parallelise by having each processer check one
-    // `p`th of the vertices as `w`.
-#pragma omp parallel for
-    for (int w = 0; w < size; w += 1) {
-        if (edges[v*size + w] == -1) continue;
-        seen_set[w] = true;
-
-        if (distances[w] > distances[v] + edges[v*size + w]) {
-            distances[w] = distances[v] + edges[v*size + w];
-            paths[w] = v;
+    const unsigned int size = matrix->size;
+    const int max_threads = omp_get_max_threads();
+    struct nearest_slot slots[2 * max_threads]
+        __attribute__((aligned(CACHE_LINE_SIZE)));
+    unsigned int *const states = ws->states;
+    struct engine_stats *const stats = (STATS_ENABLED) ? ws->stats : NULL;
+    const double start = (stats != NULL) ? stats_now() : 0;
+
+#pragma omp parallel
+    {
+        const int nthreads = omp_get_num_threads();
+        const int ithread = omp_get_thread_num();
+        // Only the first thread adds to the stats.
+        struct engine_stats *const my_stats = (ithread == 0) ? stats : NULL;
+        int min, max;
+        thread_range(size, &min, &max);
+
+        for (int i = min; i < max; i += 1) {
+            states[i] = STATE_UNSEEN;
+            paths[i] = -1;
         }
+        if (min <= source && source < max)
+            paths[source] = source;
+        if (my_stats != NULL) my_stats->prepare_time += stats_now() - start;
+
+        // For (at most) every vertex:
+        int round = 0;
+        uint64_t nearest = candidate(source, state_at(0));
+        for (; nearest != CANDIDATE_NONE; round += 1) {
+            struct nearest_slot *const slot = slots + (round % 2) * nthreads;
+            const unsigned int v = candidate_vertex(nearest);
+            const unsigned int vstate = candidate_state(nearest);
+            if (min <= v && v < max) states[v] = vstate | STATE_VISITED;
+
+            // Check my range of v's neighbours, and publish the
+            // closest valid vertex in my range.
+            const double round_start = (stats != NULL) ? stats_now() : 0;
+            slot[ithread].nearest = sweep_matrix_row(matrix,
+                    v, vstate, states, paths, min, max);
+            if (stats != NULL) {
+                slot[ithread].sweep_time = stats_now() - round_start;
+                slot[ithread].improvements =
+                    stats_count_improvements(paths, v, min, max);
+            }
+
+#pragma omp barrier
+
+            // Reduce the slots using `min`.
+            nearest = CANDIDATE_NONE;
+            for (int t = 0; t < nthreads; t += 1)
+                if (slot[t].nearest < nearest) nearest = slot[t].nearest;
+
+            if (my_stats != NULL) {
+                double sweep_times[nthreads];
+                for (int t = 0; t < nthreads; t += 1) {
+                    sweep_times[t] = slot[t].sweep_time;
+                    my_stats->improvements += slot[t].improvements;
+                }
+                stats_add_iteration(my_stats, sweep_times, nthreads,
+                        stats_now() - round_start);
+                my_stats->edges_scanned += size;
+            }
+        }
+
+        if (my_stats != NULL) my_stats->exit_iteration = round;
+    }
+
+    if (stats != NULL) {
+        stats->runs += 1;
+        stats->total_time += stats_now() - start;
     }
 }
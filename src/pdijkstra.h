@@ -13,6 +13,9 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "sweep.h"
+#include "workspace.h"
+
 /**
  * Applies Dijkstra's algorithm to the input graph
  * with the specified source, using parallelisation.
@@ -31,10 +34,134 @@
  * @param paths  the buffer in which to place the paths.
  * Paths are repesented by storing each node's predecessor
  * in the specified buffer, with node ids as the indices.
+ *
+ * @return false if memory could not be allocated, in which
+ * case the paths are left as they were.
  */
-void pdijkstra(int const* edges,
+bool pdijkstra(int const* edges,
               unsigned int size,
               unsigned int source,
               int * paths);
 
+/**
+ * Applies `pdijkstra` to the input graph with the specified
+ * source, using the buffers of the specified workspace
+ * instead of allocating its own.
+ *
+ * @param ws  the workspace; its capacity at least size.
+ * It may be reused for any number of runs, but not for
+ * more than one run at a time.
+ *
+ * @param edges  a buffer containing a matrix of edge weights.
+ * `edges[v*size + w]` should be the weight of the edge from
+ * the vertex v to the vertex w, with -1 meaning no edge.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * @param source  the id of the node to use as the source for the
+ * algorithm; non-negative, less than size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ */
+void pdijkstra_with(struct workspace * ws,
+                    int const* edges,
+                    unsigned int size,
+                    unsigned int source,
+                    int * paths);
+
+/**
+ * Applies `pdijkstra_with` to a graph given as a matrix in any
+ * format.  Narrower formats give the same paths as `int` ones
+ * with the same weights, but stream less memory per visit.
+ *
+ * @param ws  the workspace; its capacity at least the matrix size.
+ *
+ * @param matrix  the matrix of edge weights.
+ *
+ * @param source  the id of the node to use as the source for the
+ * algorithm; non-negative, less than the matrix size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ */
+void pdijkstra_matrix(struct workspace * ws,
+                      struct matrix const* matrix,
+                      unsigned int source,
+                      int * paths);
+
+/**
+ * Applies Dijkstra's algorithm to the input graph
+ * with the specified source, using a single parallel region.
+ *
+ * Produces the same paths as `pdijkstra`, but the threads are
+ * forked once for the whole run instead of once per visited
+ * vertex.  Each thread owns a fixed range of the vertices for
+ * the whole run, and the per-iteration minimum is reduced
+ * through cache line padded per-thread slots and a barrier
+ * instead of a reduction clause.
+ *
+ * @param edges  a buffer containing a matrix of edge weights.
+ * `edges[v*size + w]` should be the weight of the edge from
+ * the vertex v to the vertex w, with -1 meaning no edge.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * @param source  the id of the node to use as the source for the
+ * algorithm; non-negative, less than size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ * Paths are repesented by storing each node's predecessor
+ * in the specified buffer, with node ids as the indices.
+ *
+ * @return false if memory could not be allocated, in which
+ * case the paths are left as they were.
+ */
+bool pdijkstra_persistent(int const* edges,
+                          unsigned int size,
+                          unsigned int source,
+                          int * paths);
+
+/**
+ * Applies `pdijkstra_persistent` to the input graph with the specified
+ * source, using the buffers of the specified workspace
+ * instead of allocating its own.
+ *
+ * @param ws  the workspace; its capacity at least size.
+ * It may be reused for any number of runs, but not for
+ * more than one run at a time.
+ *
+ * @param edges  a buffer containing a matrix of edge weights.
+ * `edges[v*size + w]` should be the weight of the edge from
+ * the vertex v to the vertex w, with -1 meaning no edge.
+ *
+ * @param size  the number of nodes in the graph; positive.
+ *
+ * @param source  the id of the node to use as the source for the
+ * algorithm; non-negative, less than size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ */
+void pdijkstra_persistent_with(struct workspace * ws,
+                               int const* edges,
+                               unsigned int size,
+                               unsigned int source,
+                               int * paths);
+
+/**
+ * Applies `pdijkstra_persistent_with` to a graph given as a
+ * matrix in any format.
+ *
+ * @param ws  the workspace; its capacity at least the matrix size.
+ *
+ * @param matrix  the matrix of edge weights.
+ *
+ * @param source  the id of the node to use as the source for the
+ * algorithm; non-negative, less than the matrix size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ */
+void pdijkstra_persistent_matrix(struct workspace * ws,
+                                 struct matrix const* matrix,
+                                 unsigned int source,
+                                 int * paths);
+
 #endif // pdijkstra_H
@@ -0,0 +1,187 @@
+#include <omp.h>
+
+#include "pipeline.h"
+#include "pdijkstra.h"
+#include "prnggraph.h"
+
+/*
+ * One instance's buffers: a matrix to generate into while the
+ * other is solved, and the paths and workspace for solving.
+ */
+struct instance {
+    struct matrix *matrices[2];
+    struct workspace *ws;
+    int *paths;
+    double generate_time;
+    double solve_time;
+};
+
+static bool prepare_instance(struct pipeline const*, struct instance*);
+static void release_instance(struct instance*);
+static void run_instance(struct pipeline const*, struct instance*,
+        unsigned int, unsigned int const*, unsigned int);
+static void generate(struct pipeline const*, struct instance*,
+        unsigned int, unsigned int);
+static void solve(struct pipeline const*, struct instance*,
+        unsigned int, unsigned int);
+
+/*
+ * Generates and solves the graph for each of the seeds.
+ *
+ * Parallelisation: nested parallel regions.  The outer one has a
+ * thread per instance; each of those starts a team of two, a
+ * generator and a solver, which meet at a barrier after each graph;
+ * and each of those starts a team for `pgenerate_matrix_seeded` or
+ * `pdijkstra_matrix` with its share of the threads.
+ */
+bool
+pipeline_run(struct pipeline const*pipeline, unsigned int const*seeds,
+        unsigned int nseeds, struct pipeline_report *report)
+{
+    const unsigned int ninstances = pipeline->ninstances;
+    struct instance *instances = calloc(ninstances, sizeof(struct instance));
+    if (instances == NULL) return false;
+
+    bool prepared = true;
+    for (unsigned int k = 0; k < ninstances; k += 1)
+        if (!prepare_instance(pipeline, &instances[k])) prepared = false;
+    if (!prepared) {
+        for (unsigned int k = 0; k < ninstances; k += 1)
+            release_instance(&instances[k]);
+        free(instances);
+        return false;
+    }
+
+    const int saved_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(3);
+    const double start = omp_get_wtime();
+
+#pragma omp parallel for num_threads(ninstances) schedule(static, 1)
+    for (unsigned int k = 0; k < ninstances; k += 1)
+        run_instance(pipeline, &instances[k], k, seeds, nseeds);
+
+    report->wall_time = omp_get_wtime() - start;
+    omp_set_max_active_levels(saved_levels);
+
+    report->graphs = nseeds;
+    report->generate_time = 0;
+    report->solve_time = 0;
+    for (unsigned int k = 0; k < ninstances; k += 1) {
+        report->generate_time += instances[k].generate_time;
+        report->solve_time += instances[k].solve_time;
+        release_instance(&instances[k]);
+    }
+    report->graphs_per_second = (report->wall_time > 0)
+        ? nseeds / report->wall_time : 0;
+    free(instances);
+    return true;
+}
+
+/*
+ * Allocate an instance's matrices and buffers.
+ * Returns false if memory could not be allocated.
+ */
+static bool
+prepare_instance(struct pipeline const*pipeline, struct instance *instance)
+{
+    const unsigned int size = pipeline->size;
+    const enum matrix_format format = matrix_format_for(pipeline->max_weight);
+    for (int i = 0; i < 2; i += 1) {
+        instance->matrices[i] = (pipeline->bitmap)
+            ? matrix_create_bitmap(size, format)
+            : matrix_create(size, format);
+    }
+    instance->ws = workspace_create(size);
+    instance->paths = malloc(size * sizeof(int));
+    return instance->matrices[0] != NULL && instance->matrices[1] != NULL
+        && instance->ws != NULL && instance->paths != NULL;
+}
+
+/*
+ * Release an instance's matrices and buffers.
+ */
+static void
+release_instance(struct instance *instance)
+{
+    matrix_destroy(instance->matrices[0]);
+    matrix_destroy(instance->matrices[1]);
+    workspace_destroy(instance->ws);
+    free(instance->paths);
+}
+
+/*
+ * Run the kth instance over its graphs: the kth seed, then every
+ * `ninstances`th one after it.
+ *
+ * Step j generates the instance's jth graph into matrix `j % 2`
+ * while solving its (j-1)th from the other, so each graph is
+ * solved one step after it's generated, and neither matrix is
+ * written while it's read.
+ */
+static void
+run_instance(struct pipeline const*pipeline, struct instance *instance,
+        unsigned int k, unsigned int const*seeds, unsigned int nseeds)
+{
+    const unsigned int ninstances = pipeline->ninstances;
+    const unsigned int ngraphs = (k < nseeds)
+        ? (nseeds - k + ninstances - 1) / ninstances : 0;
+    int nthreads = pipeline->nthreads / ninstances;
+    if ((int) k < pipeline->nthreads % (int) ninstances) nthreads += 1;
+    if (nthreads < 1) nthreads = 1;
+
+    if (nthreads == 1) {
+        omp_set_num_threads(1);
+        for (unsigned int j = 0; j < ngraphs; j += 1) {
+            generate(pipeline, instance, j % 2, seeds[k + j*ninstances]);
+            solve(pipeline, instance, j % 2, k + j*ninstances);
+        }
+        return;
+    }
+
+    const int generate_threads = nthreads / 2;
+    const int solve_threads = nthreads - generate_threads;
+#pragma omp parallel num_threads(2)
+    {
+        const bool generator = (omp_get_thread_num() == 0);
+        omp_set_num_threads((generator) ? generate_threads : solve_threads);
+
+        for (unsigned int j = 0; j <= ngraphs; j += 1) {
+            if (generator && j < ngraphs)
+                generate(pipeline, instance, j % 2, seeds[k + j*ninstances]);
+            if (!generator && j > 0)
+                solve(pipeline, instance, (j-1) % 2, k + (j-1)*ninstances);
+#pragma omp barrier
+        }
+    }
+}
+
+/*
+ * Generate the graph for the seed into the instance's specified
+ * matrix, with the calling thread's number of threads.
+ */
+static void
+generate(struct pipeline const*pipeline, struct instance *instance,
+        unsigned int matrix, unsigned int seed)
+{
+    const double start = omp_get_wtime();
+    pgenerate_matrix_seeded(instance->matrices[matrix], seed, pipeline->b,
+            pipeline->max_weight);
+    instance->generate_time += omp_get_wtime() - start;
+}
+
+/*
+ * Solve the graph in the instance's specified matrix, which is
+ * the one for the ith seed, with the calling thread's number of
+ * threads, and pass its paths on.
+ */
+static void
+solve(struct pipeline const*pipeline, struct instance *instance,
+        unsigned int matrix, unsigned int i)
+{
+    const double start = omp_get_wtime();
+    pdijkstra_matrix(instance->ws, instance->matrices[matrix],
+            pipeline->source, instance->paths);
+    instance->solve_time += omp_get_wtime() - start;
+    if (pipeline->solved != NULL)
+        pipeline->solved(i, instance->paths, pipeline->context);
+}
@@ -0,0 +1,86 @@
+#ifndef pipeline_H
+#define pipeline_H
+
+/**
+ * @file
+ * Throughput mode for runs over many generated graphs, which
+ * generates the next graph while solving the current one.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "matrix.h"
+
+/**
+ * What to run a pipeline over, and how to split its threads.
+ *
+ * The graphs are dealt out round robin to `ninstances` instances
+ * running at once, each with its own share of the threads.  Each
+ * instance has two matrices: while one of its threads leads the
+ * generation of its next graph into one, another leads `pdijkstra`
+ * on its current graph in the other, each with half of the
+ * instance's threads.  With only one thread an instance generates
+ * and solves in turn.
+ */
+struct pipeline {
+    /** The number of vertices in each graph; positive. */
+    unsigned int size;
+    /** The graphs' branching factor, as for `pgenerate_matrix`. */
+    float b;
+    /** The graphs' maximum edge weight. */
+    unsigned int max_weight;
+    /** Whether to keep a presence bitmap with each matrix. */
+    bool bitmap;
+    /** The source to solve each graph from; less than size. */
+    unsigned int source;
+    /** The number of instances to run at once; positive. */
+    unsigned int ninstances;
+    /** The number of threads in all; at least `ninstances`. */
+    int nthreads;
+    /**
+     * Called with the index of each graph's seed and its paths
+     * once it's solved, from whichever thread solved it; or NULL.
+     */
+    void (*solved)(unsigned int i, int const* paths, void * context);
+    /** Passed on to `solved`. */
+    void *context;
+};
+
+/**
+ * How long a pipeline took.
+ */
+struct pipeline_report {
+    /** The number of graphs solved. */
+    unsigned int graphs;
+    /** The wall time of the whole pipeline, in seconds. */
+    double wall_time;
+    /** The time spent generating, summed over the instances. */
+    double generate_time;
+    /** The time spent solving, summed over the instances. */
+    double solve_time;
+    /** The graphs solved per second of wall time. */
+    double graphs_per_second;
+};
+
+/**
+ * Generates and solves the graph for each of the seeds, with
+ * the same graphs that `pset_seed` and `pgenerate_matrix` would
+ * generate for them.
+ *
+ * @param pipeline  the graphs' parameters and the threads to use.
+ *
+ * @param seeds  the graphs' seeds.
+ *
+ * @param nseeds  the number of seeds.
+ *
+ * @param report  where to put the timings.
+ *
+ * @return false if memory could not be allocated.
+ */
+bool pipeline_run(struct pipeline const* pipeline,
+                  unsigned int const* seeds,
+                  unsigned int nseeds,
+                  struct pipeline_report * report);
+
+#endif // pipeline_H
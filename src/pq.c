@@ -0,0 +1,511 @@
+#include <string.h>
+#include "pq.h"
+
+#define ALWAYS_INLINE __attribute__((always_inline)) inline
+
+static inline bool precedes(struct pq const*, unsigned int, unsigned int);
+static inline void place(struct pq*, unsigned int, unsigned int);
+static ALWAYS_INLINE void sift_up(struct pq*, unsigned int, unsigned int);
+static ALWAYS_INLINE void sift_down(struct pq*, unsigned int, unsigned int);
+static ALWAYS_INLINE void implicit_push(struct pq*, unsigned int, int,
+        unsigned int);
+static ALWAYS_INLINE unsigned int implicit_pop(struct pq*, unsigned int);
+static void pairing_push(struct pq*, unsigned int, int);
+static unsigned int pairing_pop(struct pq*);
+static inline unsigned int link(struct pq*, unsigned int, unsigned int);
+static unsigned int merge_pairs(struct pq*, unsigned int);
+static void pairing_clear(struct pq*);
+static inline unsigned int bucket_of(struct pq const*, int);
+static inline void bucket_insert(struct pq*, unsigned int, unsigned int);
+static inline void bucket_remove(struct pq*, unsigned int);
+static void radix_push(struct pq*, unsigned int, int);
+static void radix_settle(struct pq*);
+static unsigned int radix_pop(struct pq*);
+static void radix_clear(struct pq*);
+
+static char const*const names[] = {
+    [PQ_BINARY] = "binary",
+    [PQ_QUATERNARY] = "4ary",
+    [PQ_PAIRING] = "pairing",
+    [PQ_RADIX] = "radix",
+};
+
+/*
+ * Creates an empty queue of the specified kind for the vertex
+ * ids less than capacity.
+ */
+struct pq *
+pq_create(enum pq_kind kind, unsigned int capacity)
+{
+    struct pq *pq = calloc(1, sizeof(struct pq));
+    if (pq == NULL) return NULL;
+
+    pq->kind = kind;
+    pq->capacity = capacity;
+    pq->root = PQ_ABSENT;
+    pq->keys = malloc(capacity * sizeof(int));
+    pq->slots = malloc(capacity * sizeof(unsigned int));
+    bool allocated = pq->keys != NULL && pq->slots != NULL;
+    switch (kind) {
+    case PQ_PAIRING:
+        pq->child = malloc(capacity * sizeof(unsigned int));
+        allocated = allocated && pq->child != NULL;
+        // Fall through, for the siblings.
+    case PQ_RADIX:
+        pq->next = malloc(capacity * sizeof(unsigned int));
+        pq->prev = malloc(capacity * sizeof(unsigned int));
+        allocated = allocated && pq->next != NULL && pq->prev != NULL;
+        break;
+    default:
+        pq->items = malloc(capacity * sizeof(unsigned int));
+        allocated = allocated && pq->items != NULL;
+        break;
+    }
+    if (!allocated) {
+        pq_destroy(pq);
+        return NULL;
+    }
+
+    for (unsigned int v = 0; v < capacity; v += 1)
+        pq->slots[v] = PQ_ABSENT;
+    for (unsigned int i = 0; i < PQ_RADIX_BUCKETS; i += 1)
+        pq->heads[i] = PQ_ABSENT;
+    return pq;
+}
+
+/*
+ * Releases a queue created by `pq_create`.
+ */
+void
+pq_destroy(struct pq *pq)
+{
+    if (pq == NULL) return;
+    free(pq->keys);
+    free(pq->slots);
+    free(pq->items);
+    free(pq->child);
+    free(pq->next);
+    free(pq->prev);
+    free(pq);
+}
+
+/*
+ * Removes every vertex from the queue,
+ * in time proportional to the number removed.
+ */
+void
+pq_clear(struct pq *pq)
+{
+    switch (pq->kind) {
+    case PQ_PAIRING:
+        pairing_clear(pq);
+        break;
+    case PQ_RADIX:
+        radix_clear(pq);
+        break;
+    default:
+        for (unsigned int i = 0; i < pq->count; i += 1)
+            pq->slots[pq->items[i]] = PQ_ABSENT;
+        break;
+    }
+    pq->count = 0;
+}
+
+/*
+ * Inserts the vertex v with the specified key, or lowers
+ * its key if it is already in the queue.
+ */
+void
+pq_push(struct pq *pq, unsigned int v, int key)
+{
+    switch (pq->kind) {
+    case PQ_BINARY:
+        implicit_push(pq, v, key, 2);
+        break;
+    case PQ_QUATERNARY:
+        implicit_push(pq, v, key, 4);
+        break;
+    case PQ_PAIRING:
+        pairing_push(pq, v, key);
+        break;
+    case PQ_RADIX:
+        radix_push(pq, v, key);
+        break;
+    }
+}
+
+/*
+ * Removes and returns a vertex with the smallest key.
+ * The queue must not be empty.
+ */
+unsigned int
+pq_pop(struct pq *pq)
+{
+    switch (pq->kind) {
+    case PQ_BINARY:
+        return implicit_pop(pq, 2);
+    case PQ_QUATERNARY:
+        return implicit_pop(pq, 4);
+    case PQ_PAIRING:
+        return pairing_pop(pq);
+    default:
+        return radix_pop(pq);
+    }
+}
+
+/*
+ * The smallest key of any vertex in the queue.
+ * The queue must not be empty.
+ */
+int
+pq_min_key(struct pq *pq)
+{
+    switch (pq->kind) {
+    case PQ_PAIRING:
+        return pq->keys[pq->root];
+    case PQ_RADIX:
+        radix_settle(pq);
+        return pq->last;
+    default:
+        return pq->keys[pq->items[0]];
+    }
+}
+
+/*
+ * Finds the kind of queue with the specified name.
+ */
+bool
+pq_kind_named(char const*name, enum pq_kind *kind)
+{
+    for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i += 1) {
+        if (strcmp(name, names[i]) == 0) {
+            *kind = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * The name of the kind of queue, as `pq_kind_named` takes.
+ */
+char const*
+pq_kind_name(enum pq_kind kind)
+{
+    return names[kind];
+}
+
+/*
+ * Checks whether the vertex u belongs above the vertex w in an
+ * implicit heap; ties on key are broken by the lower vertex id.
+ */
+static inline bool
+precedes(struct pq const*pq, unsigned int u, unsigned int w)
+{
+    return pq->keys[u] < pq->keys[w]
+        || (pq->keys[u] == pq->keys[w] && u < w);
+}
+
+/*
+ * Put the vertex v at position i, keeping its slot up to date.
+ */
+static inline void
+place(struct pq *pq, unsigned int i, unsigned int v)
+{
+    pq->items[i] = v;
+    pq->slots[v] = i;
+}
+
+/*
+ * The implicit heaps' operations, with the number of children
+ * per node a constant wherever they're inlined.
+ */
+static ALWAYS_INLINE void
+sift_up(struct pq *pq, unsigned int i, unsigned int arity)
+{
+    const unsigned int v = pq->items[i];
+    while (i > 0) {
+        const unsigned int parent = (i - 1) / arity;
+        if (!precedes(pq, v, pq->items[parent])) break;
+        place(pq, i, pq->items[parent]);
+        i = parent;
+    }
+    place(pq, i, v);
+}
+
+static ALWAYS_INLINE void
+sift_down(struct pq *pq, unsigned int i, unsigned int arity)
+{
+    const unsigned int v = pq->items[i];
+    for (;;) {
+        const unsigned int first = arity*i + 1;
+        if (first >= pq->count) break;
+        const unsigned int end = (first + arity < pq->count)
+            ? first + arity : pq->count;
+
+        unsigned int child = first;
+        for (unsigned int c = first + 1; c < end; c += 1)
+            if (precedes(pq, pq->items[c], pq->items[child])) child = c;
+        if (!precedes(pq, pq->items[child], v)) break;
+        place(pq, i, pq->items[child]);
+        i = child;
+    }
+    place(pq, i, v);
+}
+
+static ALWAYS_INLINE void
+implicit_push(struct pq *pq, unsigned int v, int key, unsigned int arity)
+{
+    pq->keys[v] = key;
+    if (pq->slots[v] == PQ_ABSENT) {
+        place(pq, pq->count, v);
+        pq->count += 1;
+    }
+    sift_up(pq, pq->slots[v], arity);
+}
+
+static ALWAYS_INLINE unsigned int
+implicit_pop(struct pq *pq, unsigned int arity)
+{
+    const unsigned int v = pq->items[0];
+    pq->slots[v] = PQ_ABSENT;
+    pq->count -= 1;
+
+    if (pq->count > 0) {
+        place(pq, 0, pq->items[pq->count]);
+        sift_down(pq, 0, arity);
+    }
+    return v;
+}
+
+/*
+ * Insert v as a tree of its own and meld it with the root, or
+ * lower its key, cutting it away from its parent first unless
+ * it's the root itself.
+ */
+static void
+pairing_push(struct pq *pq, unsigned int v, int key)
+{
+    pq->keys[v] = key;
+    if (pq->slots[v] == PQ_ABSENT) {
+        pq->slots[v] = 0;
+        pq->child[v] = PQ_ABSENT;
+        pq->count += 1;
+    } else if (v == pq->root) {
+        return;
+    } else {
+        const unsigned int before = pq->prev[v];
+        const unsigned int after = pq->next[v];
+        if (pq->child[before] == v)
+            pq->child[before] = after;
+        else
+            pq->next[before] = after;
+        if (after != PQ_ABSENT) pq->prev[after] = before;
+    }
+
+    pq->next[v] = PQ_ABSENT;
+    pq->prev[v] = PQ_ABSENT;
+    pq->root = (pq->root == PQ_ABSENT) ? v : link(pq, pq->root, v);
+}
+
+/*
+ * Remove the root, and meld its children back into one tree.
+ */
+static unsigned int
+pairing_pop(struct pq *pq)
+{
+    const unsigned int v = pq->root;
+    pq->root = merge_pairs(pq, pq->child[v]);
+    pq->slots[v] = PQ_ABSENT;
+    pq->count -= 1;
+    return v;
+}
+
+/*
+ * Meld the trees rooted at u and w, making whichever has the
+ * larger key the other's first child, and return the new root.
+ * The new root's siblings are left as they were.
+ */
+static inline unsigned int
+link(struct pq *pq, unsigned int u, unsigned int w)
+{
+    if (pq->keys[w] < pq->keys[u]) {
+        const unsigned int t = u;
+        u = w;
+        w = t;
+    }
+    const unsigned int first = pq->child[u];
+    pq->prev[w] = u;
+    pq->next[w] = first;
+    if (first != PQ_ABSENT) pq->prev[first] = w;
+    pq->child[u] = w;
+    return u;
+}
+
+/*
+ * Meld a list of sibling trees, from the first, into one, in two
+ * passes: pairing them up from left to right, then melding the
+ * pairs from right to left, which keeps pops O(log n) amortised.
+ * The pairs are stacked on their own `next` between the passes.
+ */
+static unsigned int
+merge_pairs(struct pq *pq, unsigned int first)
+{
+    if (first == PQ_ABSENT) return PQ_ABSENT;
+
+    unsigned int stack = PQ_ABSENT;
+    while (first != PQ_ABSENT) {
+        const unsigned int u = first;
+        const unsigned int w = pq->next[u];
+        unsigned int tree = u;
+        if (w == PQ_ABSENT) {
+            first = PQ_ABSENT;
+        } else {
+            first = pq->next[w];
+            tree = link(pq, u, w);
+        }
+        pq->next[tree] = stack;
+        stack = tree;
+    }
+
+    unsigned int root = stack;
+    stack = pq->next[stack];
+    while (stack != PQ_ABSENT) {
+        const unsigned int below = pq->next[stack];
+        root = link(pq, root, stack);
+        stack = below;
+    }
+    pq->next[root] = PQ_ABSENT;
+    pq->prev[root] = PQ_ABSENT;
+    return root;
+}
+
+/*
+ * Walk every tree in the pairing heap, splicing each vertex's
+ * children into the list still to visit in place of it.
+ */
+static void
+pairing_clear(struct pq *pq)
+{
+    unsigned int v = pq->root;
+    while (v != PQ_ABSENT) {
+        unsigned int rest = pq->next[v];
+        const unsigned int first = pq->child[v];
+        if (first != PQ_ABSENT) {
+            unsigned int last = first;
+            while (pq->next[last] != PQ_ABSENT)
+                last = pq->next[last];
+            pq->next[last] = rest;
+            rest = first;
+        }
+        pq->slots[v] = PQ_ABSENT;
+        v = rest;
+    }
+    pq->root = PQ_ABSENT;
+}
+
+/*
+ * The radix heap's bucket for the key: 0 if it's the last key
+ * popped, or one more than the highest bit in which they differ.
+ */
+static inline unsigned int
+bucket_of(struct pq const*pq, int key)
+{
+    const unsigned int differ = (unsigned int) key ^ (unsigned int) pq->last;
+    return (differ == 0) ? 0 : 32 - __builtin_clz(differ);
+}
+
+static inline void
+bucket_insert(struct pq *pq, unsigned int v, unsigned int bucket)
+{
+    const unsigned int head = pq->heads[bucket];
+    pq->slots[v] = bucket;
+    pq->prev[v] = PQ_ABSENT;
+    pq->next[v] = head;
+    if (head != PQ_ABSENT) pq->prev[head] = v;
+    pq->heads[bucket] = v;
+}
+
+static inline void
+bucket_remove(struct pq *pq, unsigned int v)
+{
+    const unsigned int before = pq->prev[v];
+    const unsigned int after = pq->next[v];
+    if (before != PQ_ABSENT)
+        pq->next[before] = after;
+    else
+        pq->heads[pq->slots[v]] = after;
+    if (after != PQ_ABSENT) pq->prev[after] = before;
+}
+
+/*
+ * Insert v into its key's bucket, or move it to the bucket of
+ * its lower key; a lower key's bucket is never a later one.
+ */
+static void
+radix_push(struct pq *pq, unsigned int v, int key)
+{
+    const unsigned int bucket = bucket_of(pq, key);
+    pq->keys[v] = key;
+    if (pq->slots[v] == PQ_ABSENT) {
+        pq->count += 1;
+    } else {
+        if (pq->slots[v] == bucket) return;
+        bucket_remove(pq, v);
+    }
+    bucket_insert(pq, v, bucket);
+}
+
+/*
+ * Make sure the first bucket holds the smallest keys.
+ *
+ * If it's empty, the smallest key is in the first bucket with
+ * anything in it; that becomes the last key, and the rest of
+ * that bucket's keys agree with it in every bit above the
+ * bucket's, so they all move to earlier buckets.  Each key only
+ * moves down, so at most 32 times in all.
+ */
+static void
+radix_settle(struct pq *pq)
+{
+    if (pq->heads[0] != PQ_ABSENT) return;
+
+    unsigned int bucket = 1;
+    while (pq->heads[bucket] == PQ_ABSENT)
+        bucket += 1;
+
+    int smallest = INT_MAX;
+    for (unsigned int v = pq->heads[bucket]; v != PQ_ABSENT; v = pq->next[v])
+        if (pq->keys[v] < smallest) smallest = pq->keys[v];
+    pq->last = smallest;
+
+    unsigned int v = pq->heads[bucket];
+    pq->heads[bucket] = PQ_ABSENT;
+    while (v != PQ_ABSENT) {
+        const unsigned int after = pq->next[v];
+        bucket_insert(pq, v, bucket_of(pq, pq->keys[v]));
+        v = after;
+    }
+}
+
+static unsigned int
+radix_pop(struct pq *pq)
+{
+    radix_settle(pq);
+    const unsigned int v = pq->heads[0];
+    bucket_remove(pq, v);
+    pq->slots[v] = PQ_ABSENT;
+    pq->count -= 1;
+    return v;
+}
+
+static void
+radix_clear(struct pq *pq)
+{
+    for (unsigned int i = 0; i < PQ_RADIX_BUCKETS; i += 1) {
+        for (unsigned int v = pq->heads[i]; v != PQ_ABSENT; v = pq->next[v])
+            pq->slots[v] = PQ_ABSENT;
+        pq->heads[i] = PQ_ABSENT;
+    }
+    pq->last = 0;
+}
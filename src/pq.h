@@ -0,0 +1,150 @@
+#ifndef pq_H
+#define pq_H
+
+/**
+ * @file
+ * Indexed priority queues of vertices keyed by distance, with
+ * decrease-key, behind one interface so that they can be compared
+ * on the same work: binary and 4-ary heaps, a pairing heap and a
+ * radix heap.
+ *
+ * The engines don't take a `struct pq`: `sdijkstra`, `p2p` and
+ * `incremental` use the workspace's `struct heap`, which
+ * `PQ_BINARY` matches.  `target/pqbench` replays the operations
+ * Dijkstra's algorithm performs on generated graphs on each queue,
+ * to show which would suit a workload before an engine is
+ * changed to use it.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * The kinds of queue.
+ */
+enum pq_kind {
+    /** An implicit binary heap, like `struct heap`. */
+    PQ_BINARY,
+    /** An implicit heap with four children per node: half as deep,
+     *  with each node's children next to each other in memory. */
+    PQ_QUATERNARY,
+    /** A pairing heap: O(1) pushes and decreases, with the work
+     *  put off until the pops. */
+    PQ_PAIRING,
+    /** A radix heap: buckets by the highest bit in which a key
+     *  differs from the last key popped.  Keys pushed must never be
+     *  less than that, as in Dijkstra's algorithm. */
+    PQ_RADIX,
+};
+
+/** The number of buckets in a radix heap: one for the last key
+ *  popped, and one for each bit in which a key could differ. */
+#define PQ_RADIX_BUCKETS (33)
+
+/**
+ * A min-queue over the vertex ids `0` to `capacity - 1`,
+ * keyed by non-negative integers.
+ *
+ * The implicit heaps break ties by the lower vertex id, as
+ * `struct heap` does; the others pop any vertex with the
+ * smallest key.
+ */
+struct pq {
+    enum pq_kind kind;
+    /** The number of vertex ids the queue can hold. */
+    unsigned int capacity;
+    /** The number of vertices currently in the queue. */
+    unsigned int count;
+    /** Each vertex's key; only meaningful while it's queued. */
+    int *keys;
+    /** Each vertex's slot: its position in `items` for the
+     *  implicit heaps, its bucket for the radix heap, or 0 for the
+     *  pairing heap; `PQ_ABSENT` while it isn't queued. */
+    unsigned int *slots;
+    /** The implicit heaps' vertices, in heap order. */
+    unsigned int *items;
+    /** The pairing heap's root, each vertex's first child, and
+     *  each vertex's siblings; `prev` of a first child is its
+     *  parent.  Or `PQ_ABSENT`. */
+    unsigned int root;
+    unsigned int *child;
+    /** Also the radix heap's doubly linked buckets. */
+    unsigned int *next;
+    unsigned int *prev;
+    /** The radix heap's first vertex in each bucket. */
+    unsigned int heads[PQ_RADIX_BUCKETS];
+    /** The radix heap's last key popped. */
+    int last;
+};
+
+/** Slot of vertices which aren't queued, and the end of lists. */
+#define PQ_ABSENT (UINT_MAX)
+
+/**
+ * Creates an empty queue of the specified kind for the vertex
+ * ids less than capacity.
+ *
+ * @return the new queue, to be released with `pq_destroy`,
+ * or NULL if memory could not be allocated.
+ */
+struct pq *pq_create(enum pq_kind kind, unsigned int capacity);
+
+/**
+ * Releases a queue created by `pq_create`.
+ */
+void pq_destroy(struct pq *pq);
+
+/**
+ * Removes every vertex from the queue,
+ * in time proportional to the number removed.
+ */
+void pq_clear(struct pq *pq);
+
+/**
+ * Inserts the vertex v with the specified key, or lowers
+ * its key if it is already in the queue.
+ *
+ * @param v  the vertex; less than the queue's capacity.
+ *
+ * @param key  the new key; if v is already in the queue,
+ * no greater than its current key.  For `PQ_RADIX`, no less
+ * than the last key popped or returned by `pq_min_key`.
+ */
+void pq_push(struct pq *pq, unsigned int v, int key);
+
+/**
+ * Removes and returns a vertex with the smallest key.
+ * The queue must not be empty.
+ */
+unsigned int pq_pop(struct pq *pq);
+
+/**
+ * The smallest key of any vertex in the queue.
+ * The queue must not be empty.
+ */
+int pq_min_key(struct pq *pq);
+
+/**
+ * Checks whether the queue has no vertices in it.
+ */
+static inline bool
+pq_empty(struct pq const*pq)
+{
+    return pq->count == 0;
+}
+
+/**
+ * Finds the kind of queue with the specified name:
+ * "binary", "4ary", "pairing" or "radix".
+ *
+ * @return true if there is one.
+ */
+bool pq_kind_named(char const*name, enum pq_kind *kind);
+
+/**
+ * The name of the kind of queue, as `pq_kind_named` takes.
+ */
+char const*pq_kind_name(enum pq_kind kind);
+
+#endif // pq_H
@@ -2,14 +2,22 @@
 
 unsigned int current_seed;
 
-const static int BIG_POWER_OF_TWO = 2 << (sizeof(int)*8 - 3);
+static void generate(struct matrix_implicit const*, unsigned int,
+        unsigned int, unsigned int, enum matrix_format, void*);
+static void generate_partitioned(struct matrix_implicit const*,
+        struct matrix*);
+static inline void fill(struct matrix_implicit const*, size_t, unsigned int,
+        enum matrix_format, void*);
+static struct matrix_implicit next_implicit(float, unsigned int);
+static struct matrix_implicit implicit_for(unsigned int, float, unsigned int);
+static void generate_matrix(struct matrix_implicit const*, struct matrix*);
 
 /*
  * Resets the seed for randomly generated graphs.
  *
  * The same series of `set_seed` and `generate_graph` calls
  * should produce the same series of graph reliably,
- * but not when used in parallel.
+ * whatever the number of threads.
  */
 void pset_seed(unsigned int seed)
 {
@@ -27,29 +35,229 @@ void pset_seed(unsigned int seed)
  *
  * @param max_weight  the upper bound edge weight; each edge
  * has a pseudorandomly chosen non-negative weight at most this.
- * Must be a power of 2 less than RAND_MAX for a fair weight
- * distribution.
+ * Must be a power of 2 for a perfectly fair weight distribution.
  */
 void pgenerate_graph(unsigned int size,
                     float b,
                     unsigned int max_weight,
                     int *edges)
 {
-    int bint = b * (double) BIG_POWER_OF_TWO;
+    pgenerate_block(size, 0, size, b, max_weight, edges);
+}
+
+/*
+ * Randomly generates a graph into the specified matrix, in
+ * whatever format the matrix has, with the same edges that
+ * `pgenerate_graph` would have generated in its place,
+ * and its presence bitmap too if it has one.
+ * Each thread generates the columns it will sweep, so that
+ * the weights are placed local to it on NUMA systems.
+ * An implicit matrix just takes on the seed and parameters
+ * its weights will be computed from.
+ */
+void pgenerate_matrix(struct matrix *matrix,
+                      float b,
+                      unsigned int max_weight)
+{
+    const struct matrix_implicit implicit = next_implicit(b, max_weight);
+    generate_matrix(&implicit, matrix);
+}
+
+/*
+ * Randomly generates the graph for the specified seed into the
+ * matrix, as `pgenerate_matrix` would after `pset_seed`, leaving
+ * the current seed alone.
+ */
+void pgenerate_matrix_seeded(struct matrix *matrix,
+                             unsigned int seed,
+                             float b,
+                             unsigned int max_weight)
+{
+    const struct matrix_implicit implicit = implicit_for(seed, b, max_weight);
+    generate_matrix(&implicit, matrix);
+}
+
+/*
+ * Randomly generates the columns `col_min` (inclusive) to
+ * `col_max` (exclusive) of a graph of the specified size,
+ * branching factor, and maximum edge weight.
+ *
+ * @param block  the buffer for the block, with
+ * `block[v*(col_max - col_min) + (w - col_min)]` set to the
+ * weight of the edge from the vertex v to the vertex w.
+ *
+ * Each cell depends only on the seed and its place in the
+ * whole graph, so blocks generated with the same seed piece
+ * together into exactly the graph `pgenerate_graph` would.
+ */
+void pgenerate_block(unsigned int size,
+                     unsigned int col_min,
+                     unsigned int col_max,
+                     float b,
+                     unsigned int max_weight,
+                     int *block)
+{
+    const struct matrix_implicit implicit = next_implicit(b, max_weight);
+    generate(&implicit, size, col_min, col_max, MATRIX_INT, block);
+}
+
+/*
+ * Generates the columns `col_min` to `col_max` of a graph
+ * into rows of weights in the specified format.
+ *
+ * Rather than a stream of random numbers per thread, each cell
+ * hashes the seed with its index in the whole graph (like
+ * SplitMix64), so the graph is the same for any number of
+ * threads or schedule.  It's the same hash implicit matrices
+ * compute their weights with.
+ *
+ * Parallelise by making each processor generate the same
+ * columns of every row that `pdijkstra` will have it sweep,
+ * so that on NUMA systems each page is first touched, and
+ * so placed, on the node of the thread that will read it.
+ */
+static void
+generate(struct matrix_implicit const*implicit, unsigned int size,
+        unsigned int col_min, unsigned int col_max,
+        enum matrix_format format, void *weights)
+{
+    const unsigned int ncols = col_max - col_min;
+    const size_t width = matrix_weight_size(format);
+
+#pragma omp parallel
+    {
+        unsigned int min, max;
+        matrix_partition(ncols, omp_get_num_threads(), omp_get_thread_num(),
+                &min, &max);
+        for (unsigned int v = 0; v < size; v += 1) {
+            fill(implicit, (size_t) v * size + col_min + min, max - min,
+                    format, (char*) weights
+                    + ((size_t) v * ncols + min) * width);
+        }
+    }
+}
+
+/*
+ * Generates a whole graph into a partitioned matrix.
+ *
+ * Parallelise as `generate` does, so that each block is first
+ * touched by the threads that will sweep it.
+ */
+static void
+generate_partitioned(struct matrix_implicit const*implicit,
+        struct matrix *matrix)
+{
+    const unsigned int size = matrix->size;
+    const unsigned int nparts = matrix->nparts;
+    const size_t width = matrix_weight_size(matrix->format);
 
 #pragma omp parallel
     {
-        struct drand48_data buffer;
-        srand48_r(current_seed + omp_get_thread_num(), &buffer);
-
-#pragma omp for
-        for (int i = 0; i < (size*size); i += 1) {
-            long rng;
-            lrand48_r(&buffer, &rng);
-            const bool should_add_edge = ((int) rng % BIG_POWER_OF_TWO) < bint;
-            edges[i] = (should_add_edge) ? (int) rng % (max_weight+1) : -1;
+        unsigned int min, max;
+        matrix_partition(size, omp_get_num_threads(), omp_get_thread_num(),
+                &min, &max);
+        unsigned int part = (min < max) ? matrix_part_of(size, nparts, min)
+            : nparts;
+        for (; part < nparts; part += 1) {
+            unsigned int part_min, part_max;
+            matrix_partition(size, nparts, part, &part_min, &part_max);
+            if (part_min >= max) break;
+            const unsigned int lo = (min > part_min) ? min : part_min;
+            const unsigned int hi = (max < part_max) ? max : part_max;
+            if (lo >= hi) continue;
+
+            char *const block = matrix->parts[part];
+            for (unsigned int v = 0; v < size; v += 1) {
+                fill(implicit, (size_t) v * size + lo, hi - lo,
+                        matrix->format, block + ((size_t) v
+                        * (part_max - part_min) + (lo - part_min)) * width);
+            }
+        }
+    }
+}
+
+/*
+ * Fills count weights in the specified format with those of
+ * consecutive cells of the graph, from the specified cell on.
+ * The loop has no dependencies between iterations, so the
+ * compiler can vectorise it.
+ */
+static inline void
+fill(struct matrix_implicit const*implicit, size_t cell, unsigned int count,
+        enum matrix_format format, void *out)
+{
+    switch (format) {
+    case MATRIX_U16: {
+        uint16_t *const row = out;
+#pragma omp simd
+        for (unsigned int w = 0; w < count; w += 1) {
+            const int weight = matrix_implicit_weight(implicit, cell + w);
+            row[w] = (weight == -1) ? MATRIX_U16_NO_EDGE : weight;
         }
+        break;
+    }
+    case MATRIX_U8: {
+        uint8_t *const row = out;
+#pragma omp simd
+        for (unsigned int w = 0; w < count; w += 1) {
+            const int weight = matrix_implicit_weight(implicit, cell + w);
+            row[w] = (weight == -1) ? MATRIX_U8_NO_EDGE : weight;
+        }
+        break;
+    }
+    default: {
+        int *const row = out;
+#pragma omp simd
+        for (unsigned int w = 0; w < count; w += 1)
+            row[w] = matrix_implicit_weight(implicit, cell + w);
+    }
     }
+}
+
+/*
+ * Generates the graph with the specified parameters into the
+ * matrix, in whatever form the matrix has.
+ */
+static void
+generate_matrix(struct matrix_implicit const*implicit, struct matrix *matrix)
+{
+    if (matrix->format == MATRIX_IMPLICIT) {
+        matrix->implicit = *implicit;
+        return;
+    }
+    if (matrix->parts != NULL)
+        generate_partitioned(implicit, matrix);
+    else
+        generate(implicit, matrix->size, 0, matrix->size,
+                matrix->format, matrix->weights);
+    if (matrix->presence != NULL) matrix_mark_presence(matrix);
+}
+
+/*
+ * The parameters of a graph generated from the current seed,
+ * then moves on to the next seed.
+ */
+static struct matrix_implicit
+next_implicit(float b, unsigned int max_weight)
+{
+    const struct matrix_implicit implicit = implicit_for(current_seed,
+            b, max_weight);
     srand(current_seed);
     current_seed = rand();
+    return implicit;
+}
+
+/*
+ * The parameters of the graph generated from the specified seed.
+ */
+static struct matrix_implicit
+implicit_for(unsigned int seed, float b, unsigned int max_weight)
+{
+    const struct matrix_implicit implicit = {
+        .key = matrix_hash(seed),
+        // Edges are where the hash's upper 32 bits fall below this.
+        .threshold = b * 4294967296.0,
+        .max_weight = max_weight,
+    };
+    return implicit;
 }
@@ -12,13 +12,15 @@
 #include <stdio.h>
 #include <omp.h>
 
+#include "matrix.h"
+
 
 /**
  * Resets the seed for randomly generated graphs.
  *
  * The same series of `set_seed` and `generate_graph` calls
  * should produce the same series of graph reliably,
- * but not when used in parallel.
+ * whatever the number of threads.
  */
 void pset_seed(unsigned int seed);
 
@@ -39,4 +41,78 @@ void pgenerate_graph(unsigned int size,
                     unsigned int max_weight,
                     int *edges);
 
+/**
+ * Randomly generates a graph into the specified matrix, in
+ * whatever format the matrix has, with the same edges that
+ * `pgenerate_graph` would have generated in its place.
+ *
+ * @param matrix  the matrix; every weight up to max_weight must
+ * fit its format, as chosen by `matrix_format_for`.  If it has
+ * a presence bitmap, that is filled in as well.  An implicit
+ * matrix only takes on the seed and parameters its weights
+ * will be computed from, so the graph is never stored.
+ *
+ * @param b  the branching factor; probability that any given
+ * source destination pair will have an edge.
+ *
+ * @param max_weight  the upper bound edge weight; each edge
+ * has a randomly chosen non-negative weight at most this.
+ */
+void pgenerate_matrix(struct matrix * matrix,
+                      float b,
+                      unsigned int max_weight);
+
+/**
+ * Randomly generates the graph for the specified seed into the
+ * matrix, exactly as `pset_seed` followed by `pgenerate_matrix`
+ * would, but without reading or moving on the current seed, so
+ * that several threads can generate graphs at once.
+ *
+ * @param matrix  the matrix, as for `pgenerate_matrix`.
+ *
+ * @param seed  the seed of the graph.
+ *
+ * @param b  the branching factor; probability that any given
+ * source destination pair will have an edge.
+ *
+ * @param max_weight  the upper bound edge weight; each edge
+ * has a randomly chosen non-negative weight at most this.
+ */
+void pgenerate_matrix_seeded(struct matrix * matrix,
+                             unsigned int seed,
+                             float b,
+                             unsigned int max_weight);
+
+/**
+ * Randomly generates a block of columns of a graph of the
+ * specified size, branching factor, and maximum edge weight,
+ * so that distributed programs needn't hold the whole graph.
+ *
+ * Blocks generated with the same seed piece together into
+ * exactly the graph `pgenerate_graph` would generate.
+ *
+ * @param size  the number of vertices in the graph; positive.
+ *
+ * @param col_min  the first column of the block.
+ *
+ * @param col_max  the column after the last of the block;
+ * greater than col_min, at most size.
+ *
+ * @param b  the branching factor; probability that any given
+ * source destination pair will have an edge.
+ *
+ * @param max_weight  the upper bound edge weight; each edge
+ * has a randomly chosen non-negative weight at most this.
+ *
+ * @param block  the buffer for the block, with
+ * `block[v*(col_max - col_min) + (w - col_min)]` set to the
+ * weight of the edge from the vertex v to the vertex w.
+ */
+void pgenerate_block(unsigned int size,
+                     unsigned int col_min,
+                     unsigned int col_max,
+                     float b,
+                     unsigned int max_weight,
+                     int *block);
+
 #endif // rnggraph_H
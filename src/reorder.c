@@ -0,0 +1,272 @@
+#include "reorder.h"
+
+static void breadth_first(struct csr_graph const*, struct csr_graph const*,
+        unsigned int const*, bool, unsigned int*, unsigned int*, uint64_t*,
+        unsigned int*);
+static inline unsigned int enqueue_neighbours(struct csr_graph const*,
+        unsigned int, unsigned int*, unsigned int*, unsigned int);
+static void sort_keys(uint64_t*, size_t);
+static int compare_keys(void const*, void const*);
+
+/** `rank` of vertices not yet numbered, while the order is built. */
+#define UNNUMBERED (UINT_MAX)
+
+static char const*const names[] = {
+    [REORDER_BFS] = "bfs",
+    [REORDER_RCM] = "rcm",
+    [REORDER_DEGREE] = "degree",
+};
+
+/*
+ * Computes the specified order of a graph's vertices.
+ *
+ * The orders are over the graph with its edges undirected: each
+ * vertex's neighbours are those its edges leave for, from the
+ * graph, and arrive from, from its transpose.  A vertex's degree
+ * counts both.
+ */
+struct reorder *
+reorder_create(struct csr_graph const*graph, enum reorder_kind kind)
+{
+    const unsigned int size = graph->size;
+    struct reorder *reorder = malloc(sizeof(struct reorder));
+    if (reorder == NULL) return NULL;
+    reorder->size = size;
+    reorder->order = malloc(((size_t) size + 1) * sizeof(unsigned int));
+    reorder->rank = malloc(((size_t) size + 1) * sizeof(unsigned int));
+
+    struct csr_graph *reverse = csr_transpose(graph);
+    unsigned int *degrees = malloc(((size_t) size + 1) * sizeof(unsigned int));
+    unsigned int *roots = malloc(((size_t) size + 1) * sizeof(unsigned int));
+    uint64_t *keys = malloc(((size_t) size + 1) * sizeof(uint64_t));
+    if (reorder->order == NULL || reorder->rank == NULL || reverse == NULL
+            || degrees == NULL || roots == NULL || keys == NULL) {
+        reorder_destroy(reorder);
+        csr_free(reverse);
+        free(degrees);
+        free(roots);
+        free(keys);
+        return NULL;
+    }
+
+    for (unsigned int v = 0; v < size; v += 1)
+        degrees[v] = graph->offsets[v+1] - graph->offsets[v]
+            + reverse->offsets[v+1] - reverse->offsets[v];
+
+    switch (kind) {
+    case REORDER_DEGREE:
+        // Ties stay in order of id.
+        for (unsigned int v = 0; v < size; v += 1)
+            keys[v] = (uint64_t) (UINT_MAX - degrees[v]) << 32 | v;
+        sort_keys(keys, size);
+        for (unsigned int i = 0; i < size; i += 1)
+            reorder->order[i] = (unsigned int) keys[i];
+        break;
+    default:
+        breadth_first(graph, reverse, degrees, kind == REORDER_RCM,
+                reorder->order, roots, keys, reorder->rank);
+        break;
+    }
+
+    for (unsigned int i = 0; i < size; i += 1)
+        reorder->rank[reorder->order[i]] = i;
+
+    csr_free(reverse);
+    free(degrees);
+    free(roots);
+    free(keys);
+    return reorder;
+}
+
+/*
+ * Releases a permutation created by `reorder_create`.
+ */
+void
+reorder_destroy(struct reorder *reorder)
+{
+    if (reorder == NULL) return;
+    free(reorder->order);
+    free(reorder->rank);
+    free(reorder);
+}
+
+/*
+ * Builds a copy of a CSR graph with its vertices renumbered.
+ */
+struct csr_graph *
+reorder_csr(struct reorder const*reorder, struct csr_graph const*graph)
+{
+    return csr_permute(graph, reorder->rank);
+}
+
+/*
+ * Builds a copy of a matrix with its vertices renumbered.
+ *
+ * Each new row is one of the original rows, gathered in the new
+ * order of its columns; the rows are copied in parallel, and the
+ * presence bitmap, if any, is marked afterwards.
+ */
+struct matrix *
+reorder_matrix(struct reorder const*reorder, struct matrix const*matrix)
+{
+    const unsigned int size = matrix->size;
+    struct matrix *copy = (matrix->nparts > 0)
+        ? matrix_create_partitioned(size, matrix->format, matrix->nparts)
+        : (matrix->presence != NULL)
+        ? matrix_create_bitmap(size, matrix->format)
+        : matrix_create(size, matrix->format);
+    if (copy == NULL) return NULL;
+
+    uint64_t *const presence = copy->presence;
+    copy->presence = NULL;
+    unsigned int const*const order = reorder->order;
+#pragma omp parallel for schedule(static)
+    for (unsigned int v = 0; v < size; v += 1)
+        for (unsigned int w = 0; w < size; w += 1)
+            matrix_set_weight(copy, v, w,
+                    matrix_weight(matrix, order[v], order[w]));
+    copy->presence = presence;
+    if (presence != NULL) matrix_mark_presence(copy);
+    return copy;
+}
+
+/*
+ * Maps paths found over the renumbered graph back to the
+ * original ids.
+ */
+void
+reorder_paths(struct reorder const*reorder, int const*renumbered,
+        int *paths)
+{
+    unsigned int const*const order = reorder->order;
+    for (unsigned int v = 0; v < reorder->size; v += 1)
+        paths[order[v]] = (renumbered[v] == -1)
+            ? -1 : (int) order[renumbered[v]];
+}
+
+/*
+ * Maps per-vertex values computed over the renumbered graph
+ * back to the original ids.
+ */
+void
+reorder_values(struct reorder const*reorder, int const*renumbered,
+        int *values)
+{
+    unsigned int const*const order = reorder->order;
+    for (unsigned int v = 0; v < reorder->size; v += 1)
+        values[order[v]] = renumbered[v];
+}
+
+/*
+ * Finds the order with the specified name.
+ */
+bool
+reorder_kind_named(char const*name, enum reorder_kind *kind)
+{
+    for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i += 1) {
+        if (strcmp(name, names[i]) == 0) {
+            *kind = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Number the vertices breadth first into `order`, which doubles as
+ * the queue, starting each component from the lowest id not yet
+ * numbered, or with `cuthill_mckee` from one of the least degree,
+ * visiting each vertex's neighbours in order of increasing degree,
+ * and reversing the whole order at the end.
+ *
+ * @param roots  room for the `size` vertices to start from, in turn.
+ * @param keys  room for `size` keys to sort by degree.
+ * @param seen  room for `size` marks of which vertices are queued.
+ */
+static void
+breadth_first(struct csr_graph const*graph, struct csr_graph const*reverse,
+        unsigned int const*degrees, bool cuthill_mckee, unsigned int *order,
+        unsigned int *roots, uint64_t *keys, unsigned int *seen)
+{
+    const unsigned int size = graph->size;
+    for (unsigned int v = 0; v < size; v += 1)
+        seen[v] = UNNUMBERED;
+
+    if (cuthill_mckee) {
+        for (unsigned int v = 0; v < size; v += 1)
+            keys[v] = (uint64_t) degrees[v] << 32 | v;
+        sort_keys(keys, size);
+        for (unsigned int i = 0; i < size; i += 1)
+            roots[i] = (unsigned int) keys[i];
+    } else {
+        for (unsigned int i = 0; i < size; i += 1)
+            roots[i] = i;
+    }
+
+    unsigned int head = 0;
+    unsigned int tail = 0;
+    for (unsigned int r = 0; r < size; r += 1) {
+        const unsigned int root = roots[r];
+        if (seen[root] != UNNUMBERED) continue;
+        seen[root] = tail;
+        order[tail] = root;
+        tail += 1;
+
+        while (head < tail) {
+            const unsigned int v = order[head];
+            head += 1;
+            const unsigned int first = tail;
+            tail = enqueue_neighbours(graph, v, order, seen, tail);
+            tail = enqueue_neighbours(reverse, v, order, seen, tail);
+            if (!cuthill_mckee || tail - first < 2) continue;
+
+            const unsigned int count = tail - first;
+            for (unsigned int i = 0; i < count; i += 1) {
+                const unsigned int w = order[first + i];
+                keys[i] = (uint64_t) degrees[w] << 32 | w;
+            }
+            sort_keys(keys, count);
+            for (unsigned int i = 0; i < count; i += 1)
+                order[first + i] = (unsigned int) keys[i];
+        }
+    }
+
+    if (cuthill_mckee) {
+        for (unsigned int i = 0; i < size / 2; i += 1) {
+            const unsigned int t = order[i];
+            order[i] = order[size - 1 - i];
+            order[size - 1 - i] = t;
+        }
+    }
+}
+
+/*
+ * Queue the neighbours of v along the graph's edges which aren't
+ * queued yet, after `tail`, and return the new tail.
+ */
+static inline unsigned int
+enqueue_neighbours(struct csr_graph const*graph, unsigned int v,
+        unsigned int *order, unsigned int *seen, unsigned int tail)
+{
+    for (size_t e = graph->offsets[v]; e < graph->offsets[v+1]; e += 1) {
+        const unsigned int w = graph->targets[e];
+        if (seen[w] != UNNUMBERED) continue;
+        seen[w] = tail;
+        order[tail] = w;
+        tail += 1;
+    }
+    return tail;
+}
+
+static void
+sort_keys(uint64_t *keys, size_t count)
+{
+    qsort(keys, count, sizeof(uint64_t), compare_keys);
+}
+
+static int
+compare_keys(void const*a, void const*b)
+{
+    const uint64_t x = *(uint64_t const*) a, y = *(uint64_t const*) b;
+    return (x > y) - (x < y);
+}
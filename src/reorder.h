@@ -0,0 +1,115 @@
+#ifndef reorder_H
+#define reorder_H
+
+/**
+ * @file
+ * Renumbering of a graph's vertices so that those whose edges
+ * are relaxed together have nearby ids, and so nearby entries
+ * of the engines' per-vertex arrays, with the paths found over
+ * the renumbered graph mapped back to the original ids.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "csrgraph.h"
+#include "matrix.h"
+
+/**
+ * The orders a graph's vertices can be renumbered in.
+ */
+enum reorder_kind {
+    /** Breadth first from the lowest id not yet numbered, so that
+     *  each vertex's neighbours are numbered together. */
+    REORDER_BFS,
+    /** Reverse Cuthill-McKee: breadth first from a vertex of the
+     *  least degree, visiting neighbours in order of increasing
+     *  degree, reversed; keeps edges near the diagonal. */
+    REORDER_RCM,
+    /** By decreasing degree, so that the vertices relaxed most
+     *  often share cache lines. */
+    REORDER_DEGREE,
+};
+
+/**
+ * A permutation of a graph's vertex ids.
+ *
+ * Edges count in both directions, so the orders depend only
+ * on which vertices are adjacent.
+ */
+struct reorder {
+    /** The number of vertices in the graph. */
+    unsigned int size;
+    /** The original id of each new id. */
+    unsigned int *order;
+    /** The new id of each original id. */
+    unsigned int *rank;
+};
+
+/**
+ * Computes the specified order of a graph's vertices.
+ *
+ * @return the new permutation, to be released with
+ * `reorder_destroy`, or NULL if memory could not be allocated.
+ */
+struct reorder *reorder_create(struct csr_graph const*graph,
+        enum reorder_kind kind);
+
+/**
+ * Releases a permutation created by `reorder_create`.
+ */
+void reorder_destroy(struct reorder *reorder);
+
+/**
+ * Builds a copy of a CSR graph with its vertices renumbered.
+ *
+ * @return the new graph, to be released with `csr_free`,
+ * or NULL if memory could not be allocated.
+ */
+struct csr_graph *reorder_csr(struct reorder const*reorder,
+        struct csr_graph const*graph);
+
+/**
+ * Builds a copy of a matrix with its vertices renumbered, in the
+ * same format, with a presence bitmap or partitioned like it.
+ * Not for `MATRIX_IMPLICIT` matrices.
+ *
+ * @return the new matrix, to be released with `matrix_destroy`,
+ * or NULL if memory could not be allocated.
+ */
+struct matrix *reorder_matrix(struct reorder const*reorder,
+        struct matrix const*matrix);
+
+/**
+ * Maps paths found over the renumbered graph back to the
+ * original ids: `paths[order[v]] = order[renumbered[v]]`,
+ * keeping -1 for vertices with no path.
+ *
+ * @param renumbered  the paths over the renumbered graph.
+ *
+ * @param paths  where to write the paths over the original;
+ * not the same buffer.
+ */
+void reorder_paths(struct reorder const*reorder, int const*renumbered,
+        int *paths);
+
+/**
+ * Maps per-vertex values, such as distances, computed over the
+ * renumbered graph back to the original ids:
+ * `values[order[v]] = renumbered[v]`.
+ *
+ * @param values  where to write the values; not the same buffer.
+ */
+void reorder_values(struct reorder const*reorder, int const*renumbered,
+        int *values);
+
+/**
+ * Finds the order with the specified name: "bfs", "rcm" or "degree".
+ *
+ * @return true if there is one.
+ */
+bool reorder_kind_named(char const*name, enum reorder_kind *kind);
+
+#endif // reorder_H
@@ -39,7 +39,8 @@ void generate_graph(unsigned int size,
 
     int bint = b * BIG_POWER_OF_TWO;
 
-    for (int i = 0; i < (size*size); i += 1) {
+    const size_t ncells = (size_t) size * size;
+    for (size_t i = 0; i < ncells; i += 1) {
         const bool should_add_edge = (rand() % BIG_POWER_OF_TWO) < bint;
         edges[i] = (should_add_edge) ? rand() % (max_weight+1) : -1;
     }
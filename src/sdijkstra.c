@@ -0,0 +1,139 @@
+#include "sdijkstra.h"
+
+static inline void prepare_buffers(struct workspace*, int, int, int*);
+static inline unsigned long visit_vertex(struct workspace*, unsigned int,
+        struct csr_graph const*, int*);
+
+/*
+ * Applies Dijkstra's algorithm to the input graph
+ * with the specified source.
+ *
+ * @param graph  the graph, in compressed sparse row form.
+ *
+ * @param source  the id of the node to visit as the source for the
+ * algorithm; non-negative, less than the graph's size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ *
+ * Paths are repesented by storing each node's predecessor
+ * in the specified buffer, with node ids as the indices.
+ */
+bool
+sdijkstra(struct csr_graph const*graph, unsigned int source, int *paths)
+{
+    struct workspace *ws = workspace_create(graph->size);
+    if (ws == NULL) return false;
+    sdijkstra_with(ws, graph, source, paths);
+    workspace_destroy(ws);
+    return true;
+}
+
+/*
+ * Applies Dijkstra's algorithm to the input graph
+ * with the specified source, using the buffers of
+ * the specified workspace.
+ *
+ * @param ws  the workspace; its capacity at least the graph's size.
+ *
+ * @param graph  the graph, in compressed sparse row form.
+ *
+ * @param source  the id of the node to visit as the source for the
+ * algorithm; non-negative, less than the graph's size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ *
+ * Unlike `dijkstra`, the nearest vertex comes from a heap of
+ * the seen but unvisited vertices instead of a scan over all
+ * of them, and visiting only touches the vertex's own edges.
+ */
+void
+sdijkstra_with(struct workspace *ws, struct csr_graph const*graph,
+        unsigned int source, int *paths)
+{
+    struct engine_stats *const stats = (STATS_ENABLED) ? ws->stats : NULL;
+    const double start = (stats != NULL) ? stats_now() : 0;
+    prepare_buffers(ws, graph->size, source, paths);
+    if (stats != NULL) stats->prepare_time += stats_now() - start;
+
+    unsigned long iteration = 0;
+    heap_push(ws->heap, source, 0);
+    while (!heap_empty(ws->heap)) {
+        const unsigned int v = heap_pop(ws->heap);
+        ws->marks[v] = ws->visited;
+
+        const double visit_start = (stats != NULL) ? stats_now() : 0;
+        const unsigned long improvements = visit_vertex(ws, v, graph, paths);
+        if (stats != NULL) {
+            const double visit_time = stats_now() - visit_start;
+            stats_add_iteration(stats, &visit_time, 1, visit_time);
+            stats->edges_scanned += graph->offsets[v+1] - graph->offsets[v];
+            stats->improvements += improvements;
+        }
+        iteration += 1;
+    }
+
+    if (stats != NULL) {
+        stats->runs += 1;
+        stats->exit_iteration = iteration;
+        stats->total_time += stats_now() - start;
+    }
+}
+
+/*
+ * Copies out the distances found by the last run of
+ * `sdijkstra_with` which used the specified workspace.
+ * Only the vertices marked in that run have valid distances.
+ */
+void
+sdijkstra_distances(struct workspace const*ws, unsigned int size,
+        int *distances)
+{
+    for (unsigned int i = 0; i < size; i += 1)
+        distances[i] = (ws->marks[i] == ws->visited) ? ws->distances[i] : -1;
+}
+
+/*
+ * Mark all vertexs as unseen, unvisited, and having no
+ * path to the source.
+ * Begin with the seen set being just the source.
+ */
+static inline void
+prepare_buffers(struct workspace *ws, int size, int source, int *paths)
+{
+    workspace_begin(ws);
+    for (int i = 0; i < size; i += 1)
+        paths[i] = -1;
+    ws->marks[source] = ws->seen;
+    ws->distances[source] = 0;
+    paths[source] = source;
+}
+
+/*
+ * Check each of v's neighbours, w, marking them as seen.
+ * If the path to w through v is shorter than the previous
+ * shortest known path, remember it and queue w at its
+ * new distance.  Returns how many paths were improved.
+ */
+static inline unsigned long
+visit_vertex(struct workspace *ws, unsigned int v,
+        struct csr_graph const*graph, int *paths)
+{
+    unsigned long improvements = 0;
+    const int vdistance = ws->distances[v];
+    for (size_t e = graph->offsets[v]; e < graph->offsets[v+1]; e += 1) {
+        const unsigned int w = graph->targets[e];
+        if (ws->marks[w] == ws->visited) continue;
+        if (ws->marks[w] != ws->seen) {
+            ws->marks[w] = ws->seen;
+            ws->distances[w] = INT_MAX;
+        }
+
+        if (ws->distances[w] > vdistance + graph->weights[e]) {
+            ws->distances[w] = vdistance + graph->weights[e];
+            paths[w] = v;
+            heap_push(ws->heap, w, ws->distances[w]);
+            improvements += 1;
+        }
+    }
+    return improvements;
+}
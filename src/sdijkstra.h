@@ -0,0 +1,78 @@
+#ifndef sdijkstra_H
+#define sdijkstra_H
+
+/**
+ * @file
+ * Serial implementation of Dijkstra's algorithm using sparse
+ * graphs and a priority queue, in O((V+E) log V) time.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "csrgraph.h"
+#include "workspace.h"
+
+/**
+ * Applies Dijkstra's algorithm to the input graph
+ * with the specified source.
+ *
+ * Produces the same paths as `dijkstra` does for the
+ * adjacency matrix the graph was built from.
+ *
+ * @param graph  the graph, in compressed sparse row form.
+ *
+ * @param source  the id of the node to use as the source for the
+ * algorithm; non-negative, less than the graph's size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ * Paths are repesented by storing each node's predecessor
+ * in the specified buffer, with node ids as the indices.
+ *
+ * @return false if memory could not be allocated, in which
+ * case the paths are left as they were.
+ */
+bool sdijkstra(struct csr_graph const* graph,
+               unsigned int source,
+               int * paths);
+
+/**
+ * Applies `sdijkstra` to the input graph with the specified
+ * source, using the buffers of the specified workspace
+ * instead of allocating its own.
+ *
+ * @param ws  the workspace; its capacity at least the graph's size.
+ * It may be reused for any number of runs, but not for
+ * more than one run at a time.
+ *
+ * @param graph  the graph, in compressed sparse row form.
+ *
+ * @param source  the id of the node to use as the source for the
+ * algorithm; non-negative, less than the graph's size.
+ *
+ * @param paths  the buffer in which to place the paths.
+ */
+void sdijkstra_with(struct workspace * ws,
+                    struct csr_graph const* graph,
+                    unsigned int source,
+                    int * paths);
+
+/**
+ * Copies out the distances found by the last run of
+ * `sdijkstra_with` which used the specified workspace.
+ *
+ * @param ws  the workspace the run used.
+ *
+ * @param size  the number of nodes in the run's graph.
+ *
+ * @param distances  the buffer in which to place each node's
+ * distance from the source, with -1 meaning no path.
+ */
+void sdijkstra_distances(struct workspace const* ws,
+                         unsigned int size,
+                         int * distances);
+
+#endif // sdijkstra_H
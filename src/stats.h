@@ -0,0 +1,121 @@
+#ifndef stats_H
+#define stats_H
+
+/**
+ * @file
+ * Optional instrumentation of the engines' hot paths.
+ *
+ * Callers point a workspace's `stats` at a `struct engine_stats`
+ * and the engines which use that workspace add to it.  Nothing
+ * is collected, and the instrumentation compiles away entirely,
+ * unless the program is built with `PDIJKSTRA_STATS` defined
+ * (`make STATS=1 ...`), since timing every iteration costs
+ * more than some iterations do.
+ */
+
+#include <string.h>
+#include <time.h>
+
+#ifdef PDIJKSTRA_STATS
+#define STATS_ENABLED (1)
+#else
+#define STATS_ENABLED (0)
+#endif
+
+/**
+ * Totals over the runs which used a workspace with these stats.
+ *
+ * The sweep of each iteration is timed on every thread.  Its
+ * slowest thread is the iteration's sweep time, how much slower
+ * that is than the average thread is the imbalance, and the rest
+ * of the iteration, forking, reducing and waiting, is its
+ * synchronisation time.
+ */
+struct engine_stats {
+    /** The number of runs. */
+    unsigned long runs;
+    /** The total time of the runs, in seconds. */
+    double total_time;
+    /** The time spent resetting the buffers. */
+    double prepare_time;
+    /** The time spent in the slowest thread's sweeps. */
+    double sweep_time;
+    /** The time spent synchronising between sweeps. */
+    double sync_time;
+    /** The slowest threads' sweep times less the average threads'. */
+    double imbalance_time;
+    /** The number of vertices visited. */
+    unsigned long long iterations;
+    /** The number of matrix cells or edges read. */
+    unsigned long long edges_scanned;
+    /** The number of times a vertex's distance was decreased. */
+    unsigned long long improvements;
+    /**
+     * The iteration the last run stopped at, which is less than
+     * the graph's size if some vertices were unreachable.
+     */
+    unsigned long exit_iteration;
+};
+
+/**
+ * Zeroes the stats.
+ */
+static inline void
+stats_clear(struct engine_stats *stats)
+{
+    memset(stats, 0, sizeof(struct engine_stats));
+}
+
+/**
+ * The current time, in seconds, for timing phases.
+ */
+static inline double
+stats_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/**
+ * Adds one iteration's timings to the stats.
+ *
+ * @param sweep_times  each thread's sweep time.
+ *
+ * @param nthreads  the number of threads; positive.
+ *
+ * @param iteration_time  the time of the whole iteration.
+ */
+static inline void
+stats_add_iteration(struct engine_stats *stats, double const*sweep_times,
+        int nthreads, double iteration_time)
+{
+    double slowest = 0, sum = 0;
+    for (int i = 0; i < nthreads; i += 1) {
+        if (sweep_times[i] > slowest) slowest = sweep_times[i];
+        sum += sweep_times[i];
+    }
+    stats->iterations += 1;
+    stats->sweep_time += slowest;
+    stats->imbalance_time += slowest - sum / nthreads;
+    stats->sync_time += (iteration_time > slowest) ? iteration_time - slowest : 0;
+}
+
+/**
+ * The number of vertices from `min` to `max`, besides v,
+ * whose paths a sweep of v's row just improved.
+ *
+ * A dense sweep only visits v once, so any vertex whose
+ * predecessor is v was improved by that sweep.
+ */
+static inline unsigned long
+stats_count_improvements(int const*paths, unsigned int v,
+        unsigned int min, unsigned int max)
+{
+    unsigned long count = 0;
+    for (unsigned int w = min; w < max; w += 1)
+        if (paths[w] == (int) v && w != v) count += 1;
+    return count;
+}
+
+#endif // stats_H
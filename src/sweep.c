@@ -0,0 +1,696 @@
+#include "sweep.h"
+
+#if SWEEP_X86
+#include <immintrin.h>
+#endif
+
+#define ALWAYS_INLINE __attribute__((always_inline)) inline
+
+typedef uint64_t (*sweep_row_kernel)(void const*, unsigned int, unsigned int,
+        unsigned int*, int*, unsigned int, unsigned int);
+
+/*
+ * What the kernels take as the row of an implicit matrix.
+ */
+struct implicit_row {
+    struct matrix_implicit const*implicit;
+    /** The row's first cell. */
+    size_t cell;
+};
+
+/*
+ * Stands in for a matrix format in the kernels to make a kernel
+ * which only finds the nearest vertex, with no edges to relax.
+ */
+#define NO_WEIGHTS ((enum matrix_format) -1)
+
+/*
+ * One kernel for each matrix format, indexed by format, and
+ * one which only finds the nearest vertex.
+ */
+struct sweep_kernels {
+    sweep_row_kernel formats[4];
+    sweep_row_kernel nearest;
+};
+
+static const struct sweep_kernels scalar_kernels;
+#if SWEEP_X86
+static const struct sweep_kernels avx2_kernels;
+static const struct sweep_kernels avx512_kernels;
+#endif
+
+/*
+ * The kernels used by `sweep_row` and co; chosen on first use.
+ * Accessed atomically since the first use may well be from
+ * several threads at once.
+ */
+static struct sweep_kernels const*selected_kernels = NULL;
+static enum sweep_isa selected_isa = SWEEP_SCALAR;
+
+static inline uint64_t sweep(enum matrix_format, void const*, unsigned int,
+        unsigned int, unsigned int*, int*, unsigned int, unsigned int);
+static inline int load_weight(void const*, size_t, enum matrix_format);
+
+/*
+ * Relaxes the edges from the vertex v to the vertices `min`
+ * (inclusive) to `max` (exclusive), and finds the nearest seen
+ * but unvisited vertex in that range, in one pass.
+ *
+ * Uses the selected kernel, selecting the best the CPU
+ * supports if none has been selected yet.
+ */
+uint64_t
+sweep_row(int const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep(MATRIX_INT, row, v, vstate, states, paths, min, max);
+}
+
+/*
+ * `sweep_row` for rows of `MATRIX_U16` weights.
+ */
+uint64_t
+sweep_row_u16(uint16_t const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep(MATRIX_U16, row, v, vstate, states, paths, min, max);
+}
+
+/*
+ * `sweep_row` for rows of `MATRIX_U8` weights.
+ */
+uint64_t
+sweep_row_u8(uint8_t const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep(MATRIX_U8, row, v, vstate, states, paths, min, max);
+}
+
+/*
+ * `sweep_matrix_row` for `MATRIX_IMPLICIT` matrices.
+ */
+uint64_t
+sweep_implicit_row(struct matrix const*matrix, unsigned int v,
+        unsigned int vstate, unsigned int *states, int *paths,
+        unsigned int min, unsigned int max)
+{
+    const struct implicit_row row = {
+        &matrix->implicit, (size_t) v * matrix->size
+    };
+    return sweep(MATRIX_IMPLICIT, &row, v, vstate, states, paths, min, max);
+}
+
+/*
+ * Finds the nearest seen but unvisited vertex from `min`
+ * (inclusive) to `max` (exclusive), without relaxing anything.
+ */
+uint64_t
+sweep_nearest(unsigned int *states, unsigned int min, unsigned int max)
+{
+    return sweep(NO_WEIGHTS, NULL, 0, 0, states, NULL, min, max);
+}
+
+/*
+ * `sweep_matrix_row` for matrices with a presence bitmap.
+ *
+ * Relaxes only the edges whose presence bits are set, finding
+ * each with count trailing zeros and skipping words without
+ * any, then finds the nearest vertex in a second pass over the
+ * states alone.  The states end up the same as with a single
+ * pass, so the nearest vertex does too.
+ */
+uint64_t
+sweep_bitmap_row(struct matrix const*matrix, unsigned int v,
+        unsigned int vstate, unsigned int *states, int *paths,
+        unsigned int min, unsigned int max)
+{
+    if (min >= max) return CANDIDATE_NONE;
+
+    const size_t nwords = matrix_presence_words(matrix->size);
+    uint64_t const*const presence = matrix->presence + v * nwords;
+    const size_t row = (size_t) v * matrix->size;
+    const size_t first = min / 64;
+    const size_t last = (max - 1) / 64;
+
+    for (size_t i = first; i <= last; i += 1) {
+        uint64_t word = presence[i];
+        if (i == first) word &= ~(uint64_t) 0 << (min % 64);
+        if (i == last && max % 64 != 0)
+            word &= ~(~(uint64_t) 0 << (max % 64));
+
+        while (word != 0) {
+            const unsigned int w = i*64 + __builtin_ctzll(word);
+            word &= word - 1;
+
+            const unsigned int state = states[w];
+            if (state & STATE_VISITED) continue;
+            const unsigned int through_v = vstate + state_at(
+                    load_weight(matrix->weights, row + w, matrix->format));
+            if (through_v < state) {
+                states[w] = through_v;
+                paths[w] = v;
+            }
+        }
+    }
+
+    return sweep_nearest(states, min, max);
+}
+
+/*
+ * `sweep_matrix_row` for partitioned matrices.
+ *
+ * Sweeps the piece of the range in each block it overlaps,
+ * which is usually just the one when the blocks are split the
+ * same way as the threads.  Each piece is swept as though the
+ * block's first column were vertex 0, by offsetting the states
+ * and paths to match, then the nearest candidates of the
+ * pieces are shifted back and reduced with `min`.
+ */
+uint64_t
+sweep_partitioned_row(struct matrix const*matrix, unsigned int v,
+        unsigned int vstate, unsigned int *states, int *paths,
+        unsigned int min, unsigned int max)
+{
+    if (min >= max) return CANDIDATE_NONE;
+
+    const unsigned int size = matrix->size;
+    const unsigned int nparts = matrix->nparts;
+    const size_t width = matrix_weight_size(matrix->format);
+    uint64_t nearest = CANDIDATE_NONE;
+
+    unsigned int part = matrix_part_of(size, nparts, min);
+    for (; part < nparts; part += 1) {
+        unsigned int part_min, part_max;
+        matrix_partition(size, nparts, part, &part_min, &part_max);
+        if (part_min >= max) break;
+        const unsigned int lo = (min > part_min) ? min : part_min;
+        const unsigned int hi = (max < part_max) ? max : part_max;
+        if (lo >= hi) continue;
+
+        char const*const row = (char const*) matrix->parts[part]
+            + (size_t) v * (part_max - part_min) * width;
+        uint64_t next = sweep(matrix->format, row, v, vstate,
+                states + part_min, paths + part_min,
+                lo - part_min, hi - part_min);
+        if (next == CANDIDATE_NONE) continue;
+        next = candidate(candidate_vertex(next) + part_min,
+                candidate_state(next));
+        if (next < nearest) nearest = next;
+    }
+    return nearest;
+}
+
+/*
+ * Checks whether the CPU running the program supports
+ * the specified kernel.
+ */
+bool
+sweep_supports(enum sweep_isa isa)
+{
+    switch (isa) {
+    case SWEEP_SCALAR:
+        return true;
+#if SWEEP_X86
+    case SWEEP_AVX2:
+        return __builtin_cpu_supports("avx2");
+    case SWEEP_AVX512:
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    }
+}
+
+/*
+ * The fastest kernel the CPU running the program supports.
+ */
+enum sweep_isa
+sweep_best_isa(void)
+{
+    if (sweep_supports(SWEEP_AVX512)) return SWEEP_AVX512;
+    if (sweep_supports(SWEEP_AVX2)) return SWEEP_AVX2;
+    return SWEEP_SCALAR;
+}
+
+/*
+ * Makes `sweep_row` use the specified kernel from now on.
+ * Returns false, leaving the selection alone, if the CPU
+ * doesn't support it.
+ */
+bool
+sweep_select(enum sweep_isa isa)
+{
+    if (!sweep_supports(isa)) return false;
+
+    struct sweep_kernels const*kernels = &scalar_kernels;
+#if SWEEP_X86
+    if (isa == SWEEP_AVX2) kernels = &avx2_kernels;
+    if (isa == SWEEP_AVX512) kernels = &avx512_kernels;
+#endif
+    __atomic_store_n(&selected_isa, isa, __ATOMIC_RELAXED);
+    __atomic_store_n(&selected_kernels, kernels, __ATOMIC_RELEASE);
+    return true;
+}
+
+/*
+ * The kernel `sweep_row` is using; scalar if none has been
+ * selected yet.
+ */
+enum sweep_isa
+sweep_selected_isa(void)
+{
+    return __atomic_load_n(&selected_isa, __ATOMIC_RELAXED);
+}
+
+/*
+ * Run the selected kernel for the specified format.
+ */
+static inline uint64_t
+sweep(enum matrix_format format, void const*row, unsigned int v,
+        unsigned int vstate, unsigned int *states, int *paths,
+        unsigned int min, unsigned int max)
+{
+    struct sweep_kernels const*kernels =
+        __atomic_load_n(&selected_kernels, __ATOMIC_ACQUIRE);
+    if (kernels == NULL) {
+        sweep_select(sweep_best_isa());
+        kernels = __atomic_load_n(&selected_kernels, __ATOMIC_ACQUIRE);
+    }
+    const sweep_row_kernel kernel = (format == NO_WEIGHTS)
+        ? kernels->nearest : kernels->formats[format];
+    return kernel(row, v, vstate, states, paths, min, max);
+}
+
+/*
+ * The weight at w of a row in the specified format,
+ * with -1 meaning no edge, or always -1 for `NO_WEIGHTS`.
+ */
+static ALWAYS_INLINE int
+load_weight(void const*row, size_t w, enum matrix_format format)
+{
+    if (format == NO_WEIGHTS) return -1;
+    switch (format) {
+    case MATRIX_U16: {
+        const uint16_t weight = ((uint16_t const*) row)[w];
+        return (weight == MATRIX_U16_NO_EDGE) ? -1 : weight;
+    }
+    case MATRIX_U8: {
+        const uint8_t weight = ((uint8_t const*) row)[w];
+        return (weight == MATRIX_U8_NO_EDGE) ? -1 : weight;
+    }
+    case MATRIX_IMPLICIT: {
+        struct implicit_row const*const implicit = row;
+        return matrix_implicit_weight(implicit->implicit, implicit->cell + w);
+    }
+    default:
+        return ((int const*) row)[w];
+    }
+}
+
+/*
+ * Scalar version of `sweep_row`, for any CPU and format.
+ * Always inlined with a constant format, so each format's
+ * kernel has its own loop with the right loads.
+ *
+ * This replaces a visit pass, which wrote the distances and
+ * seen set, followed by a nearest vertex pass, which read them
+ * back along with the visited set: each vertex's state is read
+ * once and written at most once per visited vertex.
+ */
+static ALWAYS_INLINE uint64_t
+sweep_scalar(enum matrix_format format, void const*row, unsigned int v,
+        unsigned int vstate, unsigned int *states, int *paths,
+        unsigned int min, unsigned int max)
+{
+    uint64_t nearest = CANDIDATE_NONE;
+
+    for (unsigned int w = min; w < max; w += 1) {
+        unsigned int state = states[w];
+        if (state & STATE_VISITED) continue;
+
+        const int weight = load_weight(row, w, format);
+        if (weight != -1) {
+            const unsigned int through_v = vstate + state_at(weight);
+            if (through_v < state) {
+                state = through_v;
+                states[w] = state;
+                paths[w] = v;
+            }
+        }
+
+        if (state != STATE_UNSEEN && candidate(w, state) < nearest)
+            nearest = candidate(w, state);
+    }
+
+    return nearest;
+}
+
+static uint64_t
+sweep_scalar_int(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_scalar(MATRIX_INT, row, v, vstate, states, paths, min, max);
+}
+
+static uint64_t
+sweep_scalar_u16(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_scalar(MATRIX_U16, row, v, vstate, states, paths, min, max);
+}
+
+static uint64_t
+sweep_scalar_u8(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_scalar(MATRIX_U8, row, v, vstate, states, paths, min, max);
+}
+
+static uint64_t
+sweep_scalar_implicit(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_scalar(MATRIX_IMPLICIT, row, v, vstate, states, paths, min, max);
+}
+
+static uint64_t
+sweep_scalar_nearest(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_scalar(NO_WEIGHTS, row, v, vstate, states, paths, min, max);
+}
+
+static const struct sweep_kernels scalar_kernels = {{
+    [MATRIX_INT] = sweep_scalar_int,
+    [MATRIX_U16] = sweep_scalar_u16,
+    [MATRIX_U8] = sweep_scalar_u8,
+    [MATRIX_IMPLICIT] = sweep_scalar_implicit,
+}, sweep_scalar_nearest};
+
+#if SWEEP_X86
+
+/*
+ * The no edge weight of the specified format, once widened.
+ */
+static ALWAYS_INLINE int
+no_edge(enum matrix_format format)
+{
+    switch (format) {
+    case MATRIX_U16: return MATRIX_U16_NO_EDGE;
+    case MATRIX_U8: return MATRIX_U8_NO_EDGE;
+    default: return -1;
+    }
+}
+
+/*
+ * Finish a vectorised sweep: pick the smallest candidate of the
+ * per-lane minimums, whose states are in `lane_states` and whose
+ * vertices are in `lane_vertices`.
+ */
+static inline uint64_t
+reduce_lanes(unsigned int const*lane_states, unsigned int const*lane_vertices,
+        int nlanes)
+{
+    uint64_t nearest = CANDIDATE_NONE;
+    for (int i = 0; i < nlanes; i += 1) {
+        if (lane_states[i] >= STATE_UNSEEN) continue;
+        const uint64_t lane = candidate(lane_vertices[i], lane_states[i]);
+        if (lane < nearest) nearest = lane;
+    }
+    return nearest;
+}
+
+/*
+ * Load eight weights from w onwards, widened to 32 bits.
+ */
+__attribute__((target("avx2")))
+static ALWAYS_INLINE __m256i
+load8(void const*row, unsigned int w, enum matrix_format format)
+{
+    if (format == NO_WEIGHTS) return _mm256_set1_epi32(-1);
+    switch (format) {
+    case MATRIX_U16:
+        return _mm256_cvtepu16_epi32(
+                _mm_loadu_si128((__m128i const*) ((uint16_t const*) row + w)));
+    case MATRIX_U8:
+        return _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64((__m128i const*) ((uint8_t const*) row + w)));
+    case MATRIX_IMPLICIT: {
+        int weights[8];
+        for (int i = 0; i < 8; i += 1)
+            weights[i] = load_weight(row, w + i, format);
+        return _mm256_loadu_si256((__m256i const*) weights);
+    }
+    default:
+        return _mm256_loadu_si256((__m256i const*) ((int const*) row + w));
+    }
+}
+
+/*
+ * AVX2 version of `sweep_row`, eight vertices at a time.
+ *
+ * Each lane keeps its own nearest vertex, with strict
+ * comparisons so that it keeps the first of any ties, and the
+ * lanes are reduced at the end.  Unsigned comparisons are done
+ * as `min(a, b) == a && a != b`, since AVX2 only has signed ones.
+ * The remainder of the range is left to the scalar kernel.
+ */
+__attribute__((target("avx2")))
+static ALWAYS_INLINE uint64_t
+sweep_avx2(enum matrix_format format, void const*row, unsigned int v,
+        unsigned int vstate, unsigned int *states, int *paths,
+        unsigned int min, unsigned int max)
+{
+    const __m256i ones = _mm256_set1_epi32(-1);
+    const __m256i no_edges = _mm256_set1_epi32(no_edge(format));
+    const __m256i visited_bit = _mm256_set1_epi32(STATE_VISITED);
+    const __m256i through_base = _mm256_set1_epi32(vstate);
+    const __m256i vs = _mm256_set1_epi32(v);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i nearest_states = _mm256_set1_epi32(STATE_UNSEEN);
+    __m256i nearest_vertices = _mm256_setzero_si256();
+    __m256i ws = _mm256_add_epi32(_mm256_set1_epi32(min),
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+    unsigned int w = min;
+    for (; w + 8 <= max; w += 8) {
+        const __m256i weights = load8(row, w, format);
+        __m256i state = _mm256_loadu_si256((__m256i const*) (states + w));
+
+        const __m256i unvisited = _mm256_cmpeq_epi32(
+                _mm256_and_si256(state, visited_bit), _mm256_setzero_si256());
+        const __m256i no_edge = _mm256_cmpeq_epi32(weights, no_edges);
+        const __m256i through_v = _mm256_add_epi32(through_base,
+                _mm256_slli_epi32(weights, 1));
+        const __m256i shorter = _mm256_andnot_si256(
+                _mm256_cmpeq_epi32(through_v, state),
+                _mm256_cmpeq_epi32(_mm256_min_epu32(through_v, state), through_v));
+        const __m256i update = _mm256_andnot_si256(no_edge,
+                _mm256_and_si256(unvisited, shorter));
+
+        if (!_mm256_testz_si256(update, update)) {
+            state = _mm256_blendv_epi8(state, through_v, update);
+            _mm256_storeu_si256((__m256i*) (states + w), state);
+            const __m256i path = _mm256_loadu_si256((__m256i const*) (paths + w));
+            _mm256_storeu_si256((__m256i*) (paths + w),
+                    _mm256_blendv_epi8(path, vs, update));
+        }
+
+        // Visited vertices can't be the nearest.
+        const __m256i candidates = _mm256_or_si256(state,
+                _mm256_andnot_si256(unvisited, ones));
+        const __m256i nearer = _mm256_andnot_si256(
+                _mm256_cmpeq_epi32(candidates, nearest_states),
+                _mm256_cmpeq_epi32(_mm256_min_epu32(candidates, nearest_states),
+                    candidates));
+        nearest_states = _mm256_blendv_epi8(nearest_states, candidates, nearer);
+        nearest_vertices = _mm256_blendv_epi8(nearest_vertices, ws, nearer);
+        ws = _mm256_add_epi32(ws, step);
+    }
+
+    unsigned int lane_states[8], lane_vertices[8];
+    _mm256_storeu_si256((__m256i*) lane_states, nearest_states);
+    _mm256_storeu_si256((__m256i*) lane_vertices, nearest_vertices);
+    const uint64_t nearest = reduce_lanes(lane_states, lane_vertices, 8);
+    const uint64_t rest = sweep_scalar(format, row, v, vstate, states, paths, w, max);
+    return (rest < nearest) ? rest : nearest;
+}
+
+__attribute__((target("avx2")))
+static uint64_t
+sweep_avx2_int(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_avx2(MATRIX_INT, row, v, vstate, states, paths, min, max);
+}
+
+__attribute__((target("avx2")))
+static uint64_t
+sweep_avx2_u16(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_avx2(MATRIX_U16, row, v, vstate, states, paths, min, max);
+}
+
+__attribute__((target("avx2")))
+static uint64_t
+sweep_avx2_u8(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_avx2(MATRIX_U8, row, v, vstate, states, paths, min, max);
+}
+
+__attribute__((target("avx2")))
+static uint64_t
+sweep_avx2_implicit(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_avx2(MATRIX_IMPLICIT, row, v, vstate, states, paths, min, max);
+}
+
+__attribute__((target("avx2")))
+static uint64_t
+sweep_avx2_nearest(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_avx2(NO_WEIGHTS, row, v, vstate, states, paths, min, max);
+}
+
+static const struct sweep_kernels avx2_kernels = {{
+    [MATRIX_INT] = sweep_avx2_int,
+    [MATRIX_U16] = sweep_avx2_u16,
+    [MATRIX_U8] = sweep_avx2_u8,
+    [MATRIX_IMPLICIT] = sweep_avx2_implicit,
+}, sweep_avx2_nearest};
+
+/*
+ * Load sixteen weights from w onwards, widened to 32 bits.
+ */
+__attribute__((target("avx512f")))
+static ALWAYS_INLINE __m512i
+load16(void const*row, unsigned int w, enum matrix_format format)
+{
+    if (format == NO_WEIGHTS) return _mm512_set1_epi32(-1);
+    switch (format) {
+    case MATRIX_U16:
+        return _mm512_cvtepu16_epi32(
+                _mm256_loadu_si256((__m256i const*) ((uint16_t const*) row + w)));
+    case MATRIX_U8:
+        return _mm512_cvtepu8_epi32(
+                _mm_loadu_si128((__m128i const*) ((uint8_t const*) row + w)));
+    case MATRIX_IMPLICIT: {
+        int weights[16];
+        for (int i = 0; i < 16; i += 1)
+            weights[i] = load_weight(row, w + i, format);
+        return _mm512_loadu_si512(weights);
+    }
+    default:
+        return _mm512_loadu_si512((int const*) row + w);
+    }
+}
+
+/*
+ * AVX-512 version of `sweep_row`, sixteen vertices at a time.
+ *
+ * Like the AVX2 version, but the lane selections are mask
+ * registers, so only the improved states and paths are written.
+ */
+__attribute__((target("avx512f")))
+static ALWAYS_INLINE uint64_t
+sweep_avx512(enum matrix_format format, void const*row, unsigned int v,
+        unsigned int vstate, unsigned int *states, int *paths,
+        unsigned int min, unsigned int max)
+{
+    const __m512i no_edges = _mm512_set1_epi32(no_edge(format));
+    const __m512i visited_bit = _mm512_set1_epi32(STATE_VISITED);
+    const __m512i through_base = _mm512_set1_epi32(vstate);
+    const __m512i vs = _mm512_set1_epi32(v);
+    const __m512i step = _mm512_set1_epi32(16);
+    __m512i nearest_states = _mm512_set1_epi32(STATE_UNSEEN);
+    __m512i nearest_vertices = _mm512_setzero_si512();
+    __m512i ws = _mm512_add_epi32(_mm512_set1_epi32(min),
+            _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                8, 9, 10, 11, 12, 13, 14, 15));
+
+    unsigned int w = min;
+    for (; w + 16 <= max; w += 16) {
+        const __m512i weights = load16(row, w, format);
+        __m512i state = _mm512_loadu_si512(states + w);
+
+        const __mmask16 unvisited = _mm512_testn_epi32_mask(state, visited_bit);
+        const __mmask16 has_edge = _mm512_mask_cmpneq_epi32_mask(unvisited,
+                weights, no_edges);
+        const __m512i through_v = _mm512_add_epi32(through_base,
+                _mm512_slli_epi32(weights, 1));
+        const __mmask16 update = _mm512_mask_cmplt_epu32_mask(has_edge,
+                through_v, state);
+
+        if (update) {
+            state = _mm512_mask_mov_epi32(state, update, through_v);
+            _mm512_mask_storeu_epi32(states + w, update, through_v);
+            _mm512_mask_storeu_epi32(paths + w, update, vs);
+        }
+
+        const __mmask16 nearer = _mm512_mask_cmplt_epu32_mask(unvisited,
+                state, nearest_states);
+        nearest_states = _mm512_mask_mov_epi32(nearest_states, nearer, state);
+        nearest_vertices = _mm512_mask_mov_epi32(nearest_vertices, nearer, ws);
+        ws = _mm512_add_epi32(ws, step);
+    }
+
+    unsigned int lane_states[16], lane_vertices[16];
+    _mm512_storeu_si512(lane_states, nearest_states);
+    _mm512_storeu_si512(lane_vertices, nearest_vertices);
+    const uint64_t nearest = reduce_lanes(lane_states, lane_vertices, 16);
+    const uint64_t rest = sweep_scalar(format, row, v, vstate, states, paths, w, max);
+    return (rest < nearest) ? rest : nearest;
+}
+
+__attribute__((target("avx512f")))
+static uint64_t
+sweep_avx512_int(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_avx512(MATRIX_INT, row, v, vstate, states, paths, min, max);
+}
+
+__attribute__((target("avx512f")))
+static uint64_t
+sweep_avx512_u16(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_avx512(MATRIX_U16, row, v, vstate, states, paths, min, max);
+}
+
+__attribute__((target("avx512f")))
+static uint64_t
+sweep_avx512_u8(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_avx512(MATRIX_U8, row, v, vstate, states, paths, min, max);
+}
+
+__attribute__((target("avx512f")))
+static uint64_t
+sweep_avx512_implicit(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_avx512(MATRIX_IMPLICIT, row, v, vstate, states, paths, min, max);
+}
+
+__attribute__((target("avx512f")))
+static uint64_t
+sweep_avx512_nearest(void const*row, unsigned int v, unsigned int vstate,
+        unsigned int *states, int *paths, unsigned int min, unsigned int max)
+{
+    return sweep_avx512(NO_WEIGHTS, row, v, vstate, states, paths, min, max);
+}
+
+static const struct sweep_kernels avx512_kernels = {{
+    [MATRIX_INT] = sweep_avx512_int,
+    [MATRIX_U16] = sweep_avx512_u16,
+    [MATRIX_U8] = sweep_avx512_u8,
+    [MATRIX_IMPLICIT] = sweep_avx512_implicit,
+}, sweep_avx512_nearest};
+
+#endif // SWEEP_X86
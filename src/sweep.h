@@ -0,0 +1,254 @@
+#ifndef sweep_H
+#define sweep_H
+
+/**
+ * @file
+ * Fused relax-and-select kernel for the dense Dijkstra engines,
+ * over a packed per-vertex state.
+ *
+ * Each vertex's state is its distance from the source shifted
+ * left by one, with the low bit set once it has been visited.
+ * Vertices which haven't been seen have the state `STATE_UNSEEN`,
+ * which is even and greater than any reachable distance, so it is
+ * relaxed by any edge and never selected as the nearest vertex.
+ *
+ * Candidates for the nearest vertex are packed as the vertex's
+ * state in the high half and its id in the low half, so that the
+ * nearest vertex, with ties going to the lowest id, is simply
+ * the smallest candidate.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "matrix.h"
+
+/** Whether the vectorised x86 kernels are compiled in. */
+#if defined(__x86_64__) || defined(__i386__)
+#define SWEEP_X86 (1)
+#else
+#define SWEEP_X86 (0)
+#endif
+
+/**
+ * The instruction sets `sweep_row` has kernels for.
+ */
+enum sweep_isa {
+    SWEEP_SCALAR,
+    SWEEP_AVX2,
+    SWEEP_AVX512,
+};
+
+/** The state of vertices which haven't been seen. */
+#define STATE_UNSEEN (UINT_MAX - 1)
+
+/** The bit set in the state of visited vertices. */
+#define STATE_VISITED (1u)
+
+/** The candidate standing for no vertex at all. */
+#define CANDIDATE_NONE (UINT64_MAX)
+
+/**
+ * Packs the state of a vertex unvisited at the specified distance.
+ */
+static inline unsigned int
+state_at(int distance)
+{
+    return (unsigned int) distance << 1;
+}
+
+/**
+ * Unpacks the distance from a seen vertex's state.
+ */
+static inline int
+state_distance(unsigned int state)
+{
+    return state >> 1;
+}
+
+/**
+ * Packs a vertex and its state as a nearest vertex candidate.
+ */
+static inline uint64_t
+candidate(unsigned int v, unsigned int state)
+{
+    return ((uint64_t) state << 32) | v;
+}
+
+/**
+ * Unpacks the vertex from a candidate.
+ */
+static inline unsigned int
+candidate_vertex(uint64_t candidate)
+{
+    return (unsigned int) candidate;
+}
+
+/**
+ * Unpacks the vertex's state from a candidate.
+ */
+static inline unsigned int
+candidate_state(uint64_t candidate)
+{
+    return (unsigned int) (candidate >> 32);
+}
+
+/**
+ * Relaxes the edges from the vertex v to the vertices `min`
+ * (inclusive) to `max` (exclusive), and finds the nearest seen
+ * but unvisited vertex in that range, in one pass.
+ *
+ * @param row  v's row of the adjacency matrix, with -1
+ * meaning no edge.
+ *
+ * @param v  the vertex being visited.
+ *
+ * @param vstate  v's state; its distance at most `INT_MAX / 2`
+ * less than any distance it leads to.
+ *
+ * @param states  the vertices' states, updated in place.
+ *
+ * @param paths  the vertices' predecessors, updated in place.
+ *
+ * @return the smallest candidate in the range,
+ * or `CANDIDATE_NONE` if there are no valid vertices.
+ *
+ * Runs the kernel chosen by `sweep_select`, or the best kernel
+ * the CPU supports if none has been chosen; they all give the
+ * same results.
+ */
+uint64_t sweep_row(int const* row,
+                   unsigned int v,
+                   unsigned int vstate,
+                   unsigned int * states,
+                   int * paths,
+                   unsigned int min,
+                   unsigned int max);
+
+/**
+ * `sweep_row` for rows of `MATRIX_U16` weights.
+ */
+uint64_t sweep_row_u16(uint16_t const* row,
+                       unsigned int v,
+                       unsigned int vstate,
+                       unsigned int * states,
+                       int * paths,
+                       unsigned int min,
+                       unsigned int max);
+
+/**
+ * `sweep_row` for rows of `MATRIX_U8` weights.
+ */
+uint64_t sweep_row_u8(uint8_t const* row,
+                      unsigned int v,
+                      unsigned int vstate,
+                      unsigned int * states,
+                      int * paths,
+                      unsigned int min,
+                      unsigned int max);
+
+/**
+ * Finds the nearest seen but unvisited vertex from `min`
+ * (inclusive) to `max` (exclusive), as `sweep_row` would
+ * but without relaxing any edges.
+ */
+uint64_t sweep_nearest(unsigned int * states,
+                       unsigned int min,
+                       unsigned int max);
+
+/**
+ * `sweep_matrix_row` for matrices with a presence bitmap,
+ * which only reads the weights of the edges that are present.
+ */
+uint64_t sweep_bitmap_row(struct matrix const* matrix,
+                          unsigned int v,
+                          unsigned int vstate,
+                          unsigned int * states,
+                          int * paths,
+                          unsigned int min,
+                          unsigned int max);
+
+/**
+ * `sweep_matrix_row` for `MATRIX_IMPLICIT` matrices, which
+ * computes each weight of v's row as it goes.
+ */
+uint64_t sweep_implicit_row(struct matrix const* matrix,
+                            unsigned int v,
+                            unsigned int vstate,
+                            unsigned int * states,
+                            int * paths,
+                            unsigned int min,
+                            unsigned int max);
+
+/**
+ * `sweep_matrix_row` for partitioned matrices, which sweeps
+ * the range in each of the blocks of columns it overlaps.
+ */
+uint64_t sweep_partitioned_row(struct matrix const* matrix,
+                               unsigned int v,
+                               unsigned int vstate,
+                               unsigned int * states,
+                               int * paths,
+                               unsigned int min,
+                               unsigned int max);
+
+/**
+ * `sweep_row` for v's row of the matrix, whatever its format,
+ * using its presence bitmap if it has one, and its blocks if
+ * it's partitioned.
+ */
+static inline uint64_t
+sweep_matrix_row(struct matrix const*matrix, unsigned int v,
+        unsigned int vstate, unsigned int *states, int *paths,
+        unsigned int min, unsigned int max)
+{
+    if (matrix->presence != NULL)
+        return sweep_bitmap_row(matrix, v, vstate, states, paths, min, max);
+    if (matrix->parts != NULL)
+        return sweep_partitioned_row(matrix, v, vstate, states, paths,
+                min, max);
+
+    const size_t row = (size_t) v * matrix->size;
+    switch (matrix->format) {
+    case MATRIX_IMPLICIT:
+        return sweep_implicit_row(matrix, v, vstate, states, paths, min, max);
+    case MATRIX_U16:
+        return sweep_row_u16((uint16_t const*) matrix->weights + row,
+                v, vstate, states, paths, min, max);
+    case MATRIX_U8:
+        return sweep_row_u8((uint8_t const*) matrix->weights + row,
+                v, vstate, states, paths, min, max);
+    default:
+        return sweep_row((int const*) matrix->weights + row,
+                v, vstate, states, paths, min, max);
+    }
+}
+
+/**
+ * Checks whether the CPU running the program supports
+ * the specified kernel.
+ */
+bool sweep_supports(enum sweep_isa isa);
+
+/**
+ * The fastest kernel the CPU running the program supports.
+ */
+enum sweep_isa sweep_best_isa(void);
+
+/**
+ * Makes `sweep_row` use the specified kernel from now on.
+ *
+ * @return false, leaving the selection alone, if the CPU
+ * doesn't support the kernel.
+ */
+bool sweep_select(enum sweep_isa isa);
+
+/**
+ * The kernel `sweep_row` is using; scalar if none has been
+ * selected yet.
+ */
+enum sweep_isa sweep_selected_isa(void);
+
+#endif // sweep_H
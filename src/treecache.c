@@ -0,0 +1,130 @@
+#include "treecache.h"
+
+static void unlink_tree(struct treecache*, unsigned int);
+static void push_newest(struct treecache*, unsigned int);
+
+/*
+ * Creates an empty cache of up to capacity trees over a graph
+ * of the specified size.
+ */
+struct treecache *
+treecache_create(unsigned int size, unsigned int capacity)
+{
+    struct treecache *cache = calloc(1, sizeof(struct treecache));
+    if (cache == NULL) return NULL;
+
+    cache->size = size;
+    cache->capacity = capacity;
+    cache->newest = TREECACHE_NONE;
+    cache->oldest = TREECACHE_NONE;
+    cache->trees = calloc(capacity, sizeof(struct tree));
+    cache->slots = malloc(size * sizeof(unsigned int));
+    if (cache->trees == NULL || cache->slots == NULL) {
+        treecache_destroy(cache);
+        return NULL;
+    }
+
+    for (unsigned int i = 0; i < capacity; i += 1) {
+        cache->trees[i].paths = malloc(size * sizeof(int));
+        cache->trees[i].distances = malloc(size * sizeof(int));
+        if (cache->trees[i].paths == NULL
+                || cache->trees[i].distances == NULL) {
+            treecache_destroy(cache);
+            return NULL;
+        }
+    }
+    for (unsigned int v = 0; v < size; v += 1)
+        cache->slots[v] = TREECACHE_NONE;
+    return cache;
+}
+
+/*
+ * Releases a cache created by `treecache_create`.
+ */
+void
+treecache_destroy(struct treecache *cache)
+{
+    if (cache == NULL) return;
+    if (cache->trees != NULL) {
+        for (unsigned int i = 0; i < cache->capacity; i += 1) {
+            free(cache->trees[i].paths);
+            free(cache->trees[i].distances);
+        }
+    }
+    free(cache->trees);
+    free(cache->slots);
+    free(cache);
+}
+
+/*
+ * Finds the tree from the specified source, and makes it the
+ * most recently used.
+ */
+struct tree *
+treecache_find(struct treecache *cache, unsigned int source)
+{
+    const unsigned int slot = cache->slots[source];
+    if (slot == TREECACHE_NONE) return NULL;
+    unlink_tree(cache, slot);
+    push_newest(cache, slot);
+    return &cache->trees[slot];
+}
+
+/*
+ * Makes room for the tree from the specified source, evicting
+ * the least recently used tree if the cache is full.
+ *
+ * The slots fill up in order, then are reused oldest first.
+ */
+struct tree *
+treecache_insert(struct treecache *cache, unsigned int source)
+{
+    unsigned int slot;
+    if (cache->count < cache->capacity) {
+        slot = cache->count;
+        cache->count += 1;
+    } else {
+        slot = cache->oldest;
+        unlink_tree(cache, slot);
+        cache->slots[cache->trees[slot].source] = TREECACHE_NONE;
+    }
+
+    cache->trees[slot].source = source;
+    cache->slots[source] = slot;
+    push_newest(cache, slot);
+    return &cache->trees[slot];
+}
+
+/*
+ * Take the tree in the slot out of the recency list.
+ */
+static void
+unlink_tree(struct treecache *cache, unsigned int slot)
+{
+    struct tree *const tree = &cache->trees[slot];
+    if (tree->newer != TREECACHE_NONE)
+        cache->trees[tree->newer].older = tree->older;
+    else
+        cache->newest = tree->older;
+    if (tree->older != TREECACHE_NONE)
+        cache->trees[tree->older].newer = tree->newer;
+    else
+        cache->oldest = tree->newer;
+}
+
+/*
+ * Put the tree in the slot at the most recent end of the
+ * recency list.
+ */
+static void
+push_newest(struct treecache *cache, unsigned int slot)
+{
+    struct tree *const tree = &cache->trees[slot];
+    tree->newer = TREECACHE_NONE;
+    tree->older = cache->newest;
+    if (cache->newest != TREECACHE_NONE)
+        cache->trees[cache->newest].newer = slot;
+    else
+        cache->oldest = slot;
+    cache->newest = slot;
+}
@@ -0,0 +1,92 @@
+#ifndef treecache_H
+#define treecache_H
+
+/**
+ * @file
+ * Least recently used cache of shortest path trees, keyed by
+ * source, for answering many queries over one graph.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * One source's shortest path tree.
+ */
+struct tree {
+    /** The source the tree is from. */
+    unsigned int source;
+    /** Each vertex's predecessor, as the engines give them. */
+    int *paths;
+    /** Each vertex's distance from the source, -1 meaning no path. */
+    int *distances;
+    /** The next more and less recently used trees, or `TREECACHE_NONE`. */
+    unsigned int newer;
+    unsigned int older;
+};
+
+/**
+ * Up to `capacity` trees over a graph of `size` vertices.
+ *
+ * The trees' buffers are allocated up front, so the cache takes
+ * `2 * capacity * size` ints however many trees it holds, and
+ * inserting only reuses the least recently used tree's buffers.
+ * Finding a tree is O(1), through a table of each source's slot.
+ */
+struct treecache {
+    /** The number of vertices in the graph. */
+    unsigned int size;
+    /** The most trees the cache can hold. */
+    unsigned int capacity;
+    /** The number of trees held. */
+    unsigned int count;
+    /** The trees' slots. */
+    struct tree *trees;
+    /** Each source's slot in `trees`, or `TREECACHE_NONE`. */
+    unsigned int *slots;
+    /** The most and least recently used slots, or `TREECACHE_NONE`. */
+    unsigned int newest;
+    unsigned int oldest;
+};
+
+/** No slot. */
+#define TREECACHE_NONE (UINT_MAX)
+
+/**
+ * Creates an empty cache of up to capacity trees over a graph
+ * of the specified size.
+ *
+ * @param size  the number of vertices in the graph; positive.
+ *
+ * @param capacity  the most trees to keep; positive.
+ *
+ * @return the new cache, to be released with `treecache_destroy`,
+ * or NULL if memory could not be allocated.
+ */
+struct treecache *treecache_create(unsigned int size, unsigned int capacity);
+
+/**
+ * Releases a cache created by `treecache_create`.
+ */
+void treecache_destroy(struct treecache *cache);
+
+/**
+ * Finds the tree from the specified source, and makes it the
+ * most recently used.
+ *
+ * @return the tree, or NULL if the cache doesn't hold it.
+ */
+struct tree *treecache_find(struct treecache *cache, unsigned int source);
+
+/**
+ * Makes room for the tree from the specified source, which the
+ * cache mustn't already hold, evicting the least recently used
+ * tree if the cache is full, and makes it the most recently used.
+ *
+ * @return the tree, whose paths and distances the caller is to
+ * fill in before using it.
+ */
+struct tree *treecache_insert(struct treecache *cache, unsigned int source);
+
+#endif // treecache_H
@@ -0,0 +1,93 @@
+#include "workspace.h"
+
+#define CACHE_LINE_SIZE (64)
+
+/*
+ * Creates a workspace for graphs of up to the specified size.
+ */
+struct workspace *
+workspace_create(unsigned int capacity)
+{
+    struct workspace *ws = malloc(sizeof(struct workspace));
+    if (ws == NULL) return NULL;
+
+    ws->capacity = capacity;
+    ws->marks = workspace_alloc(capacity * sizeof(unsigned int));
+    ws->distances = workspace_alloc(capacity * sizeof(int));
+    ws->states = workspace_alloc(capacity * sizeof(unsigned int));
+    ws->heap = heap_create(capacity);
+    ws->buckets = NULL;
+    ws->stats = NULL;
+    if (ws->marks == NULL || ws->distances == NULL || ws->states == NULL
+            || ws->heap == NULL) {
+        workspace_destroy(ws);
+        return NULL;
+    }
+
+    memset(ws->marks, 0, capacity * sizeof(unsigned int));
+    ws->seen = 0;
+    ws->visited = 0;
+    return ws;
+}
+
+/*
+ * Releases a workspace created by `workspace_create`.
+ */
+void
+workspace_destroy(struct workspace *ws)
+{
+    if (ws == NULL) return;
+    free(ws->marks);
+    free(ws->distances);
+    free(ws->states);
+    heap_destroy(ws->heap);
+    buckets_destroy(ws->buckets);
+    free(ws);
+}
+
+/*
+ * Starts a new run, so that every vertex is unseen.
+ *
+ * Each run uses the next two stamps; the marks only need
+ * clearing once the stamps run out and wrap back to zero.
+ */
+void
+workspace_begin(struct workspace *ws)
+{
+    if (ws->visited > UINT_MAX - 2) {
+        memset(ws->marks, 0, ws->capacity * sizeof(unsigned int));
+        ws->visited = 0;
+    }
+    ws->seen = ws->visited + 1;
+    ws->visited = ws->visited + 2;
+    heap_clear(ws->heap);
+}
+
+/*
+ * The workspace's bucket queue, made for weights of at most
+ * max_weight.  Only the engines with small integer weights use
+ * one, so it isn't allocated until they first ask for it.
+ */
+struct buckets *
+workspace_buckets(struct workspace *ws, unsigned int max_weight)
+{
+    if (ws->buckets != NULL && ws->buckets->nbuckets > max_weight)
+        return ws->buckets;
+
+    buckets_destroy(ws->buckets);
+    ws->buckets = buckets_create(ws->capacity, max_weight);
+    return ws->buckets;
+}
+
+/*
+ * Allocates a buffer aligned to a cache line.
+ */
+void *
+workspace_alloc(size_t bytes)
+{
+    void *buffer;
+    // Keep empty buffers distinct from allocation failure.
+    if (posix_memalign(&buffer, CACHE_LINE_SIZE, bytes ? bytes : 1) != 0)
+        return NULL;
+    return buffer;
+}
@@ -0,0 +1,100 @@
+#ifndef workspace_H
+#define workspace_H
+
+/**
+ * @file
+ * Reusable buffers for running many single source shortest
+ * path computations without allocating on each run.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buckets.h"
+#include "heap.h"
+#include "stats.h"
+
+/**
+ * The scratch buffers for shortest path runs over graphs
+ * of up to `capacity` vertices.
+ *
+ * Vertex states are stamped with the run they were set in,
+ * so that starting a run only needs to advance the stamps
+ * instead of clearing every buffer.  Any entry of `marks`
+ * which is neither of the current run's stamps means that
+ * vertex hasn't been seen in this run, and its entry of
+ * `distances` is stale.
+ *
+ * The dense engines instead keep each vertex's distance and
+ * visited flag packed into one entry of `states`, as described
+ * in `sweep.h`, which they reset along with the paths.
+ */
+struct workspace {
+    /** The largest graph size the workspace can be used for. */
+    unsigned int capacity;
+    /** The mark for seen but unvisited vertices in this run. */
+    unsigned int seen;
+    /** The mark for visited vertices in this run. */
+    unsigned int visited;
+    /** Each vertex's state in the current run. */
+    unsigned int *marks;
+    /** Each seen vertex's distance from the source. */
+    int *distances;
+    /** Each vertex's packed state, for the dense engines. */
+    unsigned int *states;
+    /** Priority queue for the sparse engines. */
+    struct heap *heap;
+    /**
+     * Bucket queue for `dial`, or NULL until it's first needed;
+     * see `workspace_buckets`.
+     */
+    struct buckets *buckets;
+    /**
+     * Where the engines add their stats, or NULL for none.
+     * Only used when built with `PDIJKSTRA_STATS`; see `stats.h`.
+     */
+    struct engine_stats *stats;
+};
+
+/**
+ * Creates a workspace for graphs of up to the specified size.
+ *
+ * @param capacity  the largest number of vertices; positive.
+ *
+ * @return the new workspace, to be released with
+ * `workspace_destroy`, or NULL if memory could not be allocated.
+ */
+struct workspace *workspace_create(unsigned int capacity);
+
+/**
+ * Releases a workspace created by `workspace_create`.
+ */
+void workspace_destroy(struct workspace *ws);
+
+/**
+ * Starts a new run, so that every vertex is unseen.
+ *
+ * This only touches the marks when the stamps wrap around,
+ * once every two billion or so runs.
+ */
+void workspace_begin(struct workspace *ws);
+
+/**
+ * The workspace's bucket queue, made for weights of at most
+ * max_weight, created on first use and recreated if a later run
+ * needs more buckets.
+ *
+ * @return the queue, or NULL if memory could not be allocated.
+ */
+struct buckets *workspace_buckets(struct workspace *ws,
+                                  unsigned int max_weight);
+
+/**
+ * Allocates a buffer aligned to a cache line.
+ * Release it with `free`; returns NULL on failure.
+ */
+void *workspace_alloc(size_t bytes);
+
+#endif // workspace_H
@@ -0,0 +1,134 @@
+#include "../src/dijkstra.h"
+#include "../src/mpidijkstra.h"
+#include "../src/prnggraph.h"
+
+/*
+ * Checks `mpidijkstra` against `dijkstra`, for however many ranks
+ * it's run with: `make mpicheck` runs it with one and three.
+ *
+ * Ceedling builds its tests without MPI, so this is a program of
+ * its own rather than a Unity test.  Each rank generates its block
+ * of each graph, as `target/mpidijkstra` does, and the blocks and
+ * paths are gathered on rank 0, which checks that they're the same
+ * paths `dijkstra` finds on the whole matrix; they should be, ties
+ * included.  Exits with 1 if any differ.
+ */
+
+static bool check(unsigned int, float, unsigned int, unsigned int,
+        unsigned int);
+
+int
+main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    int rank, nranks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+    // Sizes smaller than the number of ranks leave some with no
+    // columns; zero weights give ties; sparse graphs leave
+    // vertices unreached.
+    static const struct {
+        unsigned int size;
+        float b;
+        unsigned int max_weight;
+    } graphs[] = {
+        { 1, 0.5, 10 },
+        { 2, 1.0, 10 },
+        { 97, 0.1, 4 },
+        { 200, 0.3, 100 },
+        { 200, 0.005, 10 },
+    };
+
+    unsigned int failures = 0;
+    for (size_t g = 0; g < sizeof(graphs) / sizeof(graphs[0]); g += 1)
+    for (unsigned int seed = 0; seed < 3; seed += 1)
+    for (unsigned int source = 0; source < graphs[g].size; source += 31) {
+        if (!check(graphs[g].size, graphs[g].b, graphs[g].max_weight, seed,
+                    source)) {
+            failures += 1;
+            if (rank == 0)
+                fprintf(stderr, "size %u, b %g, max_weight %u, seed %u, "
+                        "source %u: paths differ from dijkstra's\n",
+                        graphs[g].size, graphs[g].b, graphs[g].max_weight,
+                        seed, source);
+        }
+    }
+
+    if (rank == 0)
+        printf("mpidijkstra with %d ranks: %s\n", nranks,
+                (failures == 0) ? "ok" : "FAILED");
+    MPI_Finalize();
+    return (failures == 0) ? 0 : 1;
+}
+
+/*
+ * Run `mpidijkstra` on the graph, gather the blocks and paths on
+ * rank 0 and compare the paths with `dijkstra`'s.
+ * Returns whether they're the same, on every rank.
+ */
+static bool
+check(unsigned int size, float b, unsigned int max_weight, unsigned int seed,
+        unsigned int source)
+{
+    int rank, nranks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+    unsigned int min, max;
+    mpidijkstra_block(size, rank, nranks, &min, &max);
+    int *block = malloc(((size_t) size * (max - min) + 1) * sizeof(int));
+    int *slice = malloc((max - min + 1) * sizeof(int));
+    pset_seed(seed);
+    pgenerate_block(size, min, max, b, max_weight, block);
+    mpidijkstra(block, size, source, slice, MPI_COMM_WORLD);
+
+    // The blocks are gathered one after another, each `size`
+    // rows of its rank's columns.
+    int *counts = NULL, *displs = NULL, *blocks = NULL, *paths = NULL;
+    if (rank == 0) {
+        counts = malloc(2 * nranks * sizeof(int));
+        displs = malloc(2 * nranks * sizeof(int));
+        blocks = malloc(((size_t) size * size + 1) * sizeof(int));
+        paths = malloc(size * sizeof(int));
+        for (int r = 0; r < nranks; r += 1) {
+            unsigned int rmin, rmax;
+            mpidijkstra_block(size, r, nranks, &rmin, &rmax);
+            counts[r] = rmax - rmin;
+            displs[r] = rmin;
+            counts[nranks + r] = size * (rmax - rmin);
+            displs[nranks + r] = size * rmin;
+        }
+    }
+    MPI_Gatherv(slice, max - min, MPI_INT, paths, counts, displs, MPI_INT, 0,
+            MPI_COMM_WORLD);
+    MPI_Gatherv(block, size * (max - min), MPI_INT, blocks,
+            (rank == 0) ? counts + nranks : NULL,
+            (rank == 0) ? displs + nranks : NULL, MPI_INT, 0, MPI_COMM_WORLD);
+
+    int same = 1;
+    if (rank == 0) {
+        int *edges = malloc((size_t) size * size * sizeof(int));
+        int *want = malloc(size * sizeof(int));
+        for (int r = 0; r < nranks; r += 1) {
+            const unsigned int rmin = displs[r], ncols = counts[r];
+            int const*const rblock = blocks + displs[nranks + r];
+            for (unsigned int v = 0; v < size; v += 1)
+                for (unsigned int i = 0; i < ncols; i += 1)
+                    edges[(size_t) v*size + rmin + i] = rblock[v*ncols + i];
+        }
+        dijkstra(edges, size, source, want);
+        same = (memcmp(paths, want, size * sizeof(int)) == 0);
+        free(edges);
+        free(want);
+    }
+    MPI_Bcast(&same, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    free(counts);
+    free(displs);
+    free(blocks);
+    free(paths);
+    free(slice);
+    free(block);
+    return same;
+}
@@ -0,0 +1,140 @@
+#include <omp.h>
+
+#include "../src/dial.h"
+#include "../src/dijkstra.h"
+#include "../src/pdijkstra.h"
+#include "../src/sdijkstra.h"
+
+#if !STATS_ENABLED
+#error "build with PDIJKSTRA_STATS defined, as `make statscheck` does"
+#endif
+
+/*
+ * Checks the stats each engine collects, which the Unity tests
+ * can't: Ceedling builds the sources once, without
+ * `PDIJKSTRA_STATS`, so there the instrumentation compiles away.
+ * `make statscheck` builds this and every source it needs with the
+ * stats.  Each engine runs on the same small graph, with one and
+ * three threads where it's parallel, and should count the same
+ * iterations, scans and improvements as `test_stats` expects of
+ * `dijkstra_with`.  Exits with 1 if any differ.
+ */
+
+#define SIZE (5)
+#define NEDGES (4)
+
+enum engine {
+    ENGINE_DIJKSTRA,
+    ENGINE_PDIJKSTRA,
+    ENGINE_PERSISTENT,
+    ENGINE_SDIJKSTRA,
+    ENGINE_DIAL,
+    NENGINES,
+};
+
+static char const*const engine_names[NENGINES] = {
+    [ENGINE_DIJKSTRA] = "dijkstra",
+    [ENGINE_PDIJKSTRA] = "pdijkstra",
+    [ENGINE_PERSISTENT] = "persistent",
+    [ENGINE_SDIJKSTRA] = "sdijkstra",
+    [ENGINE_DIAL] = "dial",
+};
+
+static bool check(int, int, int const*, struct csr_graph const*);
+static bool expect(int, int, char const*, unsigned long long,
+        unsigned long long);
+
+int
+main(void)
+{
+    // As in `test_stats`: vertex 4 is unreachable, and 2 is
+    // improved twice, from 0 and then from 1.
+    int edges[SIZE * SIZE];
+    for (int i = 0; i < SIZE * SIZE; i += 1) edges[i] = -1;
+    edges[0*SIZE + 1] = 2;
+    edges[0*SIZE + 2] = 4;
+    edges[1*SIZE + 2] = 1;
+    edges[2*SIZE + 3] = 2;
+    struct csr_graph *graph = csr_from_matrix(edges, SIZE);
+    if (graph == NULL) {
+        fprintf(stderr, "couldn't allocate the graph\n");
+        return 1;
+    }
+
+    unsigned int failures = 0;
+    for (int engine = 0; engine < NENGINES; engine += 1)
+        for (int nthreads = 1; nthreads <= 3; nthreads += 2)
+            if (!check(engine, nthreads, edges, graph)) failures += 1;
+
+    csr_free(graph);
+    if (failures == 0) printf("stats check passed\n");
+    return (failures == 0) ? 0 : 1;
+}
+
+/*
+ * Run the engine once with fresh stats, and check what it counted.
+ */
+static bool
+check(int engine, int nthreads, int const*edges,
+        struct csr_graph const*graph)
+{
+    struct workspace *ws = workspace_create(SIZE);
+    int paths[SIZE];
+    if (ws == NULL) {
+        fprintf(stderr, "couldn't allocate the workspace\n");
+        exit(1);
+    }
+    struct engine_stats stats;
+    stats_clear(&stats);
+    ws->stats = &stats;
+
+    omp_set_num_threads(nthreads);
+    bool ran = true;
+    switch (engine) {
+    case ENGINE_DIJKSTRA:
+        dijkstra_with(ws, edges, SIZE, 0, paths);
+        break;
+    case ENGINE_PDIJKSTRA:
+        pdijkstra_with(ws, edges, SIZE, 0, paths);
+        break;
+    case ENGINE_PERSISTENT:
+        pdijkstra_persistent_with(ws, edges, SIZE, 0, paths);
+        break;
+    case ENGINE_SDIJKSTRA:
+        sdijkstra_with(ws, graph, 0, paths);
+        break;
+    case ENGINE_DIAL:
+        ran = dial_with(ws, graph, 0, 4, paths);
+        break;
+    }
+    workspace_destroy(ws);
+    if (!ran) {
+        fprintf(stderr, "couldn't allocate dial's buckets\n");
+        exit(1);
+    }
+
+    // The dense engines scan a whole row per vertex, the sparse
+    // ones only its edges.
+    const unsigned long long scanned =
+        (engine == ENGINE_SDIJKSTRA || engine == ENGINE_DIAL)
+        ? NEDGES : 4 * SIZE;
+    bool ok = expect(engine, nthreads, "runs", 1, stats.runs);
+    ok = expect(engine, nthreads, "iterations", 4, stats.iterations) && ok;
+    ok = expect(engine, nthreads, "exit_iteration", 4, stats.exit_iteration)
+        && ok;
+    ok = expect(engine, nthreads, "edges_scanned", scanned,
+            stats.edges_scanned) && ok;
+    ok = expect(engine, nthreads, "improvements", 4, stats.improvements)
+        && ok;
+    return ok;
+}
+
+static bool
+expect(int engine, int nthreads, char const*name, unsigned long long want,
+        unsigned long long got)
+{
+    if (want == got) return true;
+    fprintf(stderr, "%s with %d threads: expected %s %llu, got %llu\n",
+            engine_names[engine], nthreads, name, want, got);
+    return false;
+}
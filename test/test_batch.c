@@ -0,0 +1,84 @@
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "batch.h"
+#include "buckets.h"
+#include "csrgraph.h"
+#include "dijkstra.h"
+#include "heap.h"
+#include "matrix.h"
+#include "rnggraph.h"
+#include "sdijkstra.h"
+#include "sweep.h"
+#include "workspace.h"
+
+#define TEST_GRAPH_SIZE (40)
+
+int edges[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+int paths[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+int distances[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+int want_paths[TEST_GRAPH_SIZE];
+
+void setUp(void)
+{
+    set_seed(11);
+    generate_graph(TEST_GRAPH_SIZE, 0.08, 9, edges);
+}
+
+void tearDown(void)
+{
+}
+
+void test_selected_sources_match_single_runs(void)
+{
+    const unsigned int sources[] = { 5, 0, 39, 5 };
+    TEST_ASSERT_TRUE(batch_dijkstra(edges, TEST_GRAPH_SIZE, sources, 4, paths,
+                NULL));
+
+    for (int i = 0; i < 4; i += 1) {
+        dijkstra(edges, TEST_GRAPH_SIZE, sources[i], want_paths);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_paths, paths + i*TEST_GRAPH_SIZE,
+                TEST_GRAPH_SIZE);
+    }
+}
+
+void test_all_sources_distances(void)
+{
+    TEST_ASSERT_TRUE(batch_dijkstra(edges, TEST_GRAPH_SIZE, NULL, 0, paths,
+                distances));
+
+    for (int s = 0; s < TEST_GRAPH_SIZE; s += 1) {
+        int const*row_paths = paths + s*TEST_GRAPH_SIZE;
+        int const*row_distances = distances + s*TEST_GRAPH_SIZE;
+        TEST_ASSERT_EQUAL_INT(0, row_distances[s]);
+
+        for (int w = 0; w < TEST_GRAPH_SIZE; w += 1) {
+            if (w == s) continue;
+            if (row_paths[w] == -1) {
+                TEST_ASSERT_EQUAL_INT(-1, row_distances[w]);
+            } else {
+                const int v = row_paths[w];
+                TEST_ASSERT_EQUAL_INT(row_distances[v] + edges[v*TEST_GRAPH_SIZE + w],
+                        row_distances[w]);
+            }
+        }
+    }
+}
+
+void test_sparse_matches_dense(void)
+{
+    static int sparse_paths[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+    static int sparse_distances[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+    struct csr_graph *graph = csr_from_matrix(edges, TEST_GRAPH_SIZE);
+
+    TEST_ASSERT_TRUE(batch_dijkstra(edges, TEST_GRAPH_SIZE, NULL, 0, paths,
+                distances));
+    TEST_ASSERT_TRUE(batch_sdijkstra(graph, NULL, 0, sparse_paths,
+                sparse_distances));
+
+    TEST_ASSERT_EQUAL_INT_ARRAY(paths, sparse_paths,
+            TEST_GRAPH_SIZE * TEST_GRAPH_SIZE);
+    TEST_ASSERT_EQUAL_INT_ARRAY(distances, sparse_distances,
+            TEST_GRAPH_SIZE * TEST_GRAPH_SIZE);
+    csr_free(graph);
+}
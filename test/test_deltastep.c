@@ -0,0 +1,119 @@
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "buckets.h"
+#include "csrgraph.h"
+#include "deltastep.h"
+#include "heap.h"
+#include "rnggraph.h"
+#include "sdijkstra.h"
+#include "workspace.h"
+
+#define TEST_GRAPH_SIZE (120)
+
+int edges[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+int paths[TEST_GRAPH_SIZE];
+int want_paths[TEST_GRAPH_SIZE];
+
+static void expect_same_distances(unsigned int, float, unsigned int, int);
+static int path_distance(int const*, unsigned int, unsigned int,
+        unsigned int);
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_auto_delta_same_distances_as_sdijkstra(void)
+{
+    for (int nthreads = 1; nthreads <= 4; nthreads += 1) {
+        omp_set_num_threads(nthreads);
+        expect_same_distances(TEST_GRAPH_SIZE, 0.1, 20, 0);
+    }
+}
+
+void test_unit_delta_same_distances_as_sdijkstra(void)
+{
+    // Every distance in a bucket of its own, zero weights included.
+    for (int nthreads = 1; nthreads <= 4; nthreads += 1) {
+        omp_set_num_threads(nthreads);
+        expect_same_distances(TEST_GRAPH_SIZE, 0.1, 4, 1);
+    }
+}
+
+void test_other_deltas_same_distances_as_sdijkstra(void)
+{
+    static const int deltas[] = { 2, 3, 7, 50, 1000 };
+    omp_set_num_threads(3);
+    for (size_t d = 0; d < sizeof(deltas) / sizeof(deltas[0]); d += 1)
+        expect_same_distances(TEST_GRAPH_SIZE, 0.05, 100, deltas[d]);
+}
+
+void test_sparse_graph_leaves_vertices_unreached(void)
+{
+    omp_set_num_threads(4);
+    expect_same_distances(TEST_GRAPH_SIZE, 0.005, 10, 0);
+}
+
+void test_fewer_vertices_than_threads(void)
+{
+    omp_set_num_threads(8);
+    for (unsigned int size = 1; size < 8; size += 1)
+        expect_same_distances(size, 0.5, 10, 0);
+}
+
+/*
+ * Run `delta_stepping` from several sources of random graphs with
+ * the specified size, density and weights, and check the length
+ * of every path against the length of `sdijkstra`'s.  Ties may be
+ * broken differently, so the paths themselves aren't compared.
+ */
+static void
+expect_same_distances(unsigned int size, float b, unsigned int max_weight,
+        int delta)
+{
+    for (unsigned int seed = 0; seed < 3; seed += 1) {
+        set_seed(seed);
+        generate_graph(size, b, max_weight, edges);
+        struct csr_graph *graph = csr_from_matrix(edges, size);
+        TEST_ASSERT_NOT_NULL(graph);
+
+        for (unsigned int source = 0; source < size; source += 7) {
+            sdijkstra(graph, source, want_paths);
+            memset(paths, 0, sizeof(paths));
+            TEST_ASSERT_TRUE(delta_stepping(graph, source, delta, paths));
+
+            for (unsigned int v = 0; v < size; v += 1)
+                TEST_ASSERT_EQUAL_INT(
+                        path_distance(want_paths, size, source, v),
+                        path_distance(paths, size, source, v));
+        }
+        csr_free(graph);
+    }
+}
+
+/*
+ * The length of the path from the source to v in the paths,
+ * or -1 if v has no path.
+ */
+static int
+path_distance(int const*paths, unsigned int size, unsigned int source,
+        unsigned int v)
+{
+    if (paths[v] == -1) return -1;
+    int distance = 0;
+    unsigned int hops = 0;
+    for (unsigned int w = v; w != source; w = paths[w]) {
+        const int u = paths[w];
+        TEST_ASSERT_TRUE(u >= 0 && (unsigned int) u < size);
+        TEST_ASSERT_TRUE(hops < size);
+        TEST_ASSERT_NOT_EQUAL(-1, edges[u*size + w]);
+        distance += edges[u*size + w];
+        hops += 1;
+    }
+    return distance;
+}
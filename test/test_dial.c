@@ -0,0 +1,158 @@
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "buckets.h"
+#include "csrgraph.h"
+#include "dial.h"
+#include "dijkstra.h"
+#include "heap.h"
+#include "matrix.h"
+#include "rnggraph.h"
+#include "sdijkstra.h"
+#include "sweep.h"
+#include "workspace.h"
+
+#define TEST_GRAPH_SIZE (90)
+
+int edges[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+int paths[TEST_GRAPH_SIZE];
+int distances[TEST_GRAPH_SIZE];
+int want[TEST_GRAPH_SIZE];
+int want_paths[TEST_GRAPH_SIZE];
+
+static void expect_same_distances(struct matrix const*, unsigned int);
+static void expect_shortest_path_tree(struct matrix const*, unsigned int);
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_buckets_pop_in_key_order(void)
+{
+    struct buckets *buckets = buckets_create(8, 3);
+    buckets_begin(buckets);
+    buckets_push(buckets, 5, 2);
+    buckets_push(buckets, 1, 0);
+    buckets_push(buckets, 4, 3);
+    buckets_push(buckets, 4, 1);
+
+    TEST_ASSERT_EQUAL_INT(1, buckets_pop(buckets));
+    TEST_ASSERT_EQUAL_INT(4, buckets_pop(buckets));
+    // Wrapping around the ring of buckets.
+    buckets_push(buckets, 2, 4);
+    buckets_push(buckets, 7, 2);
+    TEST_ASSERT_EQUAL_INT(7, buckets_pop(buckets));
+    TEST_ASSERT_EQUAL_INT(5, buckets_pop(buckets));
+    TEST_ASSERT_EQUAL_INT(2, buckets_pop(buckets));
+    TEST_ASSERT_TRUE(buckets_empty(buckets));
+
+    buckets_destroy(buckets);
+}
+
+void test_csr_same_distances_as_sdijkstra(void)
+{
+    set_seed(6);
+    // Zero weights too, which requeue vertices at the current key.
+    generate_graph(TEST_GRAPH_SIZE, 0.07, 4, edges);
+    struct csr_graph *graph = csr_from_matrix(edges, TEST_GRAPH_SIZE);
+    struct workspace *ws = workspace_create(TEST_GRAPH_SIZE);
+    struct workspace *check = workspace_create(TEST_GRAPH_SIZE);
+    struct matrix matrix = matrix_of_ints(edges, TEST_GRAPH_SIZE);
+
+    for (unsigned int s = 0; s < TEST_GRAPH_SIZE; s += 1) {
+        sdijkstra_with(check, graph, s, want_paths);
+        sdijkstra_distances(check, TEST_GRAPH_SIZE, want);
+        TEST_ASSERT_TRUE(dial_with(ws, graph, s, 0, paths));
+        dial_distances(ws, TEST_GRAPH_SIZE, distances);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want, distances, TEST_GRAPH_SIZE);
+        expect_shortest_path_tree(&matrix, s);
+    }
+
+    workspace_destroy(check);
+    workspace_destroy(ws);
+    csr_free(graph);
+}
+
+void test_int_matrix_same_distances_as_dijkstra(void)
+{
+    set_seed(7);
+    generate_graph(TEST_GRAPH_SIZE, 0.3, 20, edges);
+    struct matrix matrix = matrix_of_ints(edges, TEST_GRAPH_SIZE);
+    expect_same_distances(&matrix, 20);
+}
+
+void test_u8_bitmap_matrix_same_distances_as_dijkstra(void)
+{
+    struct matrix *matrix = matrix_create_bitmap(TEST_GRAPH_SIZE, MATRIX_U8);
+    set_seed(8);
+    generate_graph(TEST_GRAPH_SIZE, 0.05, 200, edges);
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1)
+            matrix_set_weight(matrix, v, w, edges[v*TEST_GRAPH_SIZE + w]);
+    expect_same_distances(matrix, 200);
+    matrix_destroy(matrix);
+}
+
+void test_partitioned_matrix_same_distances_as_dijkstra(void)
+{
+    struct matrix *matrix = matrix_create_partitioned(TEST_GRAPH_SIZE,
+            MATRIX_U16, 3);
+    set_seed(9);
+    generate_graph(TEST_GRAPH_SIZE, 0.2, 1000, edges);
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1)
+            matrix_set_weight(matrix, v, w, edges[v*TEST_GRAPH_SIZE + w]);
+    expect_same_distances(matrix, 1000);
+    matrix_destroy(matrix);
+}
+
+/*
+ * Run from every source, with one workspace whose bucket queue is
+ * first made too small for the matrix, checking the distances
+ * against `dijkstra` and that the paths are shortest paths.
+ */
+static void
+expect_same_distances(struct matrix const*matrix, unsigned int max_weight)
+{
+    struct workspace *ws = workspace_create(TEST_GRAPH_SIZE);
+    struct workspace *check = workspace_create(TEST_GRAPH_SIZE);
+    TEST_ASSERT_NOT_NULL(workspace_buckets(ws, 1));
+
+    for (unsigned int s = 0; s < TEST_GRAPH_SIZE; s += 1) {
+        dijkstra_matrix(check, matrix, s, want_paths);
+        dijkstra_distances(check, TEST_GRAPH_SIZE, want);
+        TEST_ASSERT_TRUE(dial_matrix(ws, matrix, s, max_weight, paths));
+        dial_distances(ws, TEST_GRAPH_SIZE, distances);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want, distances, TEST_GRAPH_SIZE);
+        expect_shortest_path_tree(matrix, s);
+    }
+
+    workspace_destroy(check);
+    workspace_destroy(ws);
+}
+
+/*
+ * Check that every reachable vertex's predecessor is on a
+ * shortest path to it, and every unreachable one has none.
+ */
+static void
+expect_shortest_path_tree(struct matrix const*matrix, unsigned int source)
+{
+    TEST_ASSERT_EQUAL_INT(source, paths[source]);
+    for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1) {
+        if (w == source) continue;
+        if (distances[w] == -1) {
+            TEST_ASSERT_EQUAL_INT(-1, paths[w]);
+            continue;
+        }
+        const int v = paths[w];
+        TEST_ASSERT_TRUE(v >= 0);
+        TEST_ASSERT_NOT_EQUAL(-1, matrix_weight(matrix, v, w));
+        TEST_ASSERT_EQUAL_INT(distances[w],
+                distances[v] + matrix_weight(matrix, v, w));
+    }
+}
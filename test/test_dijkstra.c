@@ -3,7 +3,12 @@
 #include <stdbool.h>
 
 #include "unity.h"
+#include "buckets.h"
 #include "dijkstra.h"
+#include "heap.h"
+#include "matrix.h"
+#include "sweep.h"
+#include "workspace.h"
 
 #define TEST_MAX_GRAPH_SIZE (10)
 
@@ -255,3 +260,105 @@ void test_upper_path_complex(void)
     dijkstra(edges, size, source, paths);
     TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
 }
+
+void test_workspace_reuse(void)
+{
+    struct workspace *ws = workspace_create(TEST_MAX_GRAPH_SIZE);
+
+    size = 5;
+    edges[0*size + 1] = 2;
+    edges[0*size + 2] = 4;
+    edges[1*size + 3] = 5;
+    edges[2*size + 3] = 2;
+    edges[3*size + 4] = 0;
+
+    // Stale state from the first run mustn't leak into the second.
+    dijkstra_with(ws, edges, size, 0, paths);
+    dijkstra_with(ws, edges, size, 2, paths);
+
+    want[0] = -1;
+    want[1] = -1;
+    want[2] = 2;
+    want[3] = 2;
+    want[4] = 3;
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, size);
+
+    dijkstra_with(ws, edges, size, 0, paths);
+
+    want[0] = 0;
+    want[1] = 0;
+    want[2] = 0;
+    want[3] = 2;
+    want[4] = 3;
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, size);
+
+    workspace_destroy(ws);
+}
+
+void test_narrow_matrices(void)
+{
+    struct workspace *ws = workspace_create(TEST_MAX_GRAPH_SIZE);
+
+    size = 5;
+    edges[0*size + 1] = 2;
+    edges[0*size + 2] = 4;
+    edges[1*size + 3] = 5;
+    edges[2*size + 3] = 2;
+    edges[3*size + 4] = 0;
+    dijkstra(edges, size, 0, want);
+
+    // The same weights, stored as `uint16_t`, `uint8_t`, then
+    // `uint8_t` with a presence bitmap.
+    enum matrix_format formats[3] = { MATRIX_U16, MATRIX_U8, MATRIX_U8 };
+    for (int f = 0; f < 3; f += 1) {
+        struct matrix *matrix = (f == 2)
+            ? matrix_create_bitmap(size, formats[f])
+            : matrix_create(size, formats[f]);
+        for (int i = 0; i < size*size; i += 1) {
+            if (formats[f] == MATRIX_U16)
+                ((uint16_t*) matrix->weights)[i] =
+                    (edges[i] == -1) ? MATRIX_U16_NO_EDGE : edges[i];
+            else
+                ((uint8_t*) matrix->weights)[i] =
+                    (edges[i] == -1) ? MATRIX_U8_NO_EDGE : edges[i];
+        }
+        if (matrix->presence != NULL) matrix_mark_presence(matrix);
+        TEST_ASSERT_EQUAL_INT(edges[0*size + 2], matrix_weight(matrix, 0, 2));
+        TEST_ASSERT_EQUAL_INT(-1, matrix_weight(matrix, 4, 0));
+
+        dijkstra_matrix(ws, matrix, 0, paths);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, size);
+        matrix_destroy(matrix);
+    }
+
+    workspace_destroy(ws);
+}
+
+void test_stats(void)
+{
+    struct workspace *ws = workspace_create(TEST_MAX_GRAPH_SIZE);
+    struct engine_stats stats;
+    stats_clear(&stats);
+    ws->stats = &stats;
+
+    // Vertex 4 is unreachable.
+    size = 5;
+    edges[0*size + 1] = 2;
+    edges[0*size + 2] = 4;
+    edges[1*size + 2] = 1;
+    edges[2*size + 3] = 2;
+    dijkstra_with(ws, edges, size, 0, paths);
+
+    if (!STATS_ENABLED) {
+        TEST_ASSERT_EQUAL_INT(0, stats.runs);
+    } else {
+        TEST_ASSERT_EQUAL_INT(1, stats.runs);
+        TEST_ASSERT_EQUAL_INT(4, stats.iterations);
+        TEST_ASSERT_EQUAL_INT(4, stats.exit_iteration);
+        TEST_ASSERT_EQUAL_INT(4 * size, stats.edges_scanned);
+        // 1 and 2 from 0, 2 again from 1, then 3 from 2.
+        TEST_ASSERT_EQUAL_INT(4, stats.improvements);
+    }
+
+    workspace_destroy(ws);
+}
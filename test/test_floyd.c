@@ -0,0 +1,115 @@
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "batch.h"
+#include "buckets.h"
+#include "csrgraph.h"
+#include "dijkstra.h"
+#include "floyd.h"
+#include "heap.h"
+#include "matrix.h"
+#include "rnggraph.h"
+#include "sdijkstra.h"
+#include "sweep.h"
+#include "workspace.h"
+
+// Not a multiple of the tile size, so the edge tiles are ragged.
+#define TEST_GRAPH_SIZE (150)
+#define TEST_ENTRIES (TEST_GRAPH_SIZE * TEST_GRAPH_SIZE)
+
+int edges[TEST_ENTRIES];
+int distances[TEST_ENTRIES];
+int next[TEST_ENTRIES];
+int want_distances[TEST_ENTRIES];
+int paths[TEST_ENTRIES];
+
+static void expect_next_hops_follow_distances(unsigned int);
+
+void setUp(void)
+{
+    for (int i = 0; i < TEST_ENTRIES; i += 1)
+        edges[i] = -1;
+}
+
+void tearDown(void)
+{
+}
+
+void test_single_node(void)
+{
+    TEST_ASSERT_TRUE(floyd_warshall(edges, 1, distances, next));
+
+    TEST_ASSERT_EQUAL_INT(0, distances[0]);
+    TEST_ASSERT_EQUAL_INT(0, next[0]);
+}
+
+void test_three_nodes_shortcut(void)
+{
+    const unsigned int size = 3;
+    edges[0*size + 1] = 1;
+    edges[1*size + 2] = 1;
+    edges[0*size + 2] = 5;
+
+    TEST_ASSERT_TRUE(floyd_warshall(edges, size, distances, next));
+
+    TEST_ASSERT_EQUAL_INT(2, distances[0*size + 2]);
+    TEST_ASSERT_EQUAL_INT(1, next[0*size + 2]);
+    TEST_ASSERT_EQUAL_INT(-1, distances[2*size + 0]);
+    TEST_ASSERT_EQUAL_INT(-1, next[2*size + 0]);
+    TEST_ASSERT_EQUAL_INT(2, next[1*size + 2]);
+}
+
+void test_random_graph_matches_dijkstra(void)
+{
+    set_seed(3);
+    generate_graph(TEST_GRAPH_SIZE, 0.03, 20, edges);
+
+    TEST_ASSERT_TRUE(floyd_warshall(edges, TEST_GRAPH_SIZE, distances, next));
+    batch_dijkstra(edges, TEST_GRAPH_SIZE, NULL, 0, paths, want_distances);
+
+    TEST_ASSERT_EQUAL_INT_ARRAY(want_distances, distances, TEST_ENTRIES);
+    expect_next_hops_follow_distances(TEST_GRAPH_SIZE);
+}
+
+void test_zero_weight_cycles_have_no_loops(void)
+{
+    // Half the weights are zero, so the tile rows and columns
+    // find paths through zero weight cycles.
+    set_seed(0);
+    generate_graph(TEST_GRAPH_SIZE, 0.04, 1, edges);
+
+    TEST_ASSERT_TRUE(floyd_warshall(edges, TEST_GRAPH_SIZE, distances, next));
+    batch_dijkstra(edges, TEST_GRAPH_SIZE, NULL, 0, paths, want_distances);
+
+    TEST_ASSERT_EQUAL_INT_ARRAY(want_distances, distances, TEST_ENTRIES);
+    expect_next_hops_follow_distances(TEST_GRAPH_SIZE);
+}
+
+/*
+ * Walking the next hops from any vertex to any reachable vertex
+ * should get there along edges adding up to its distance.
+ */
+static void
+expect_next_hops_follow_distances(unsigned int size)
+{
+    for (unsigned int v = 0; v < size; v += 1) {
+        for (unsigned int w = 0; w < size; w += 1) {
+            if (distances[v*size + w] == -1) {
+                TEST_ASSERT_EQUAL_INT(-1, next[v*size + w]);
+                continue;
+            }
+
+            int length = 0;
+            unsigned int u = v;
+            for (unsigned int hops = 0; u != w; hops += 1) {
+                TEST_ASSERT_TRUE_MESSAGE(hops < size, "expected no loops");
+                const int hop = next[u*size + w];
+                TEST_ASSERT_TRUE_MESSAGE(edges[u*size + hop] != -1,
+                        "expected each hop to be an edge");
+                length += edges[u*size + hop];
+                u = hop;
+            }
+            TEST_ASSERT_EQUAL_INT(distances[v*size + w], length);
+        }
+    }
+}
@@ -0,0 +1,196 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "unity.h"
+#include "csrgraph.h"
+#include "graphfile.h"
+#include "matrix.h"
+
+#define TEST_GRAPH_SIZE (70)
+
+char path[] = "/tmp/test_graphfile_XXXXXX";
+
+static struct matrix *example_matrix(enum matrix_format, bool);
+static void expect_rejected(struct csr_graph const*);
+
+void setUp(void)
+{
+    const int fd = mkstemp(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+}
+
+void tearDown(void)
+{
+    unlink(path);
+    strcpy(path, "/tmp/test_graphfile_XXXXXX");
+}
+
+void test_dense_round_trip(void)
+{
+    const enum matrix_format formats[3] = { MATRIX_INT, MATRIX_U16, MATRIX_U8 };
+    for (int f = 0; f < 3; f += 1) {
+        struct matrix *matrix = example_matrix(formats[f], f == 2);
+        TEST_ASSERT_TRUE(graphfile_save_matrix(path, matrix));
+
+        struct graphfile *file = graphfile_open(path);
+        TEST_ASSERT_NOT_NULL(file);
+        TEST_ASSERT_EQUAL_INT(GRAPHFILE_DENSE, file->kind);
+        TEST_ASSERT_EQUAL_INT(formats[f], file->matrix.format);
+        TEST_ASSERT_EQUAL_INT(TEST_GRAPH_SIZE, file->matrix.size);
+        TEST_ASSERT_EQUAL_INT(0,
+                (uintptr_t) file->matrix.weights % GRAPHFILE_ALIGNMENT);
+        TEST_ASSERT_EQUAL_INT(f == 2, file->matrix.presence != NULL);
+
+        for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+            for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1)
+                TEST_ASSERT_EQUAL_INT(matrix_weight(matrix, v, w),
+                        matrix_weight(&file->matrix, v, w));
+
+        graphfile_close(file);
+        matrix_destroy(matrix);
+    }
+}
+
+void test_implicit_round_trip(void)
+{
+    struct matrix *matrix = matrix_create(TEST_GRAPH_SIZE, MATRIX_IMPLICIT);
+    matrix->implicit.key = 12345;
+    matrix->implicit.threshold = (uint64_t) 1 << 30;
+    matrix->implicit.max_weight = 9;
+    TEST_ASSERT_TRUE(graphfile_save_matrix(path, matrix));
+
+    struct graphfile *file = graphfile_open(path);
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_INT(sizeof(struct graphfile_header), file->length);
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1)
+            TEST_ASSERT_EQUAL_INT(matrix_weight(matrix, v, w),
+                    matrix_weight(&file->matrix, v, w));
+
+    graphfile_close(file);
+    matrix_destroy(matrix);
+}
+
+void test_csr_round_trip(void)
+{
+    struct matrix *matrix = example_matrix(MATRIX_INT, false);
+    struct csr_graph *graph = csr_from_matrix(matrix->weights, TEST_GRAPH_SIZE);
+    TEST_ASSERT_TRUE(graphfile_save_csr(path, graph));
+
+    struct graphfile *file = graphfile_open(path);
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_INT(GRAPHFILE_CSR, file->kind);
+    TEST_ASSERT_EQUAL_INT(graph->size, file->csr.size);
+    TEST_ASSERT_EQUAL_INT(graph->nedges, file->csr.nedges);
+    TEST_ASSERT_EQUAL_MEMORY(graph->offsets, file->csr.offsets,
+            (graph->size + 1) * sizeof(size_t));
+    TEST_ASSERT_EQUAL_MEMORY(graph->targets, file->csr.targets,
+            graph->nedges * sizeof(unsigned int));
+    TEST_ASSERT_EQUAL_MEMORY(graph->weights, file->csr.weights,
+            graph->nedges * sizeof(int));
+
+    graphfile_close(file);
+    csr_free(graph);
+    matrix_destroy(matrix);
+}
+
+void test_rejects_bad_files(void)
+{
+    FILE *out = fopen(path, "wb");
+    fputs("not a graph file, but long enough to hold a header... "
+          "................................................................",
+          out);
+    fclose(out);
+    TEST_ASSERT_NULL(graphfile_open(path));
+
+    // A truncated file's sections run past its end.
+    struct matrix *matrix = example_matrix(MATRIX_U8, false);
+    TEST_ASSERT_TRUE(graphfile_save_matrix(path, matrix));
+    TEST_ASSERT_EQUAL_INT(0, truncate(path, sizeof(struct graphfile_header) + 64));
+    TEST_ASSERT_NULL(graphfile_open(path));
+    matrix_destroy(matrix);
+
+    TEST_ASSERT_NULL(graphfile_open("/nonexistent/graph"));
+}
+
+void test_rejects_corrupt_csr(void)
+{
+    struct matrix *matrix = example_matrix(MATRIX_INT, false);
+    struct csr_graph *graph = csr_from_matrix(matrix->weights, TEST_GRAPH_SIZE);
+    const unsigned int target = graph->targets[3];
+    const int weight = graph->weights[graph->nedges - 1];
+    const size_t offset = graph->offsets[1];
+
+    // Each corruption in turn, saved and then undone.
+    graph->targets[3] = TEST_GRAPH_SIZE;
+    expect_rejected(graph);
+    graph->targets[3] = target;
+
+    graph->weights[graph->nedges - 1] = -2;
+    expect_rejected(graph);
+    graph->weights[graph->nedges - 1] = weight;
+
+    graph->offsets[1] = graph->offsets[2] + 1;
+    expect_rejected(graph);
+    graph->offsets[1] = offset;
+
+    graph->offsets[0] = 1;
+    expect_rejected(graph);
+    graph->offsets[0] = 0;
+
+    graph->nedges -= 1;
+    expect_rejected(graph);
+    graph->nedges += 1;
+
+    TEST_ASSERT_TRUE(graphfile_save_csr(path, graph));
+    struct graphfile *file = graphfile_open(path);
+    TEST_ASSERT_NOT_NULL(file);
+    graphfile_close(file);
+
+    csr_free(graph);
+    matrix_destroy(matrix);
+}
+
+/*
+ * Saves the graph and expects opening it to fail as invalid.
+ */
+static void
+expect_rejected(struct csr_graph const*graph)
+{
+    TEST_ASSERT_TRUE(graphfile_save_csr(path, graph));
+    errno = 0;
+    TEST_ASSERT_NULL(graphfile_open(path));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+}
+
+/*
+ * A matrix in the specified format with a mix of edges and
+ * no edges, and a presence bitmap if asked for.
+ */
+static struct matrix *
+example_matrix(enum matrix_format format, bool with_presence)
+{
+    struct matrix *matrix = (with_presence)
+        ? matrix_create_bitmap(TEST_GRAPH_SIZE, format)
+        : matrix_create(TEST_GRAPH_SIZE, format);
+
+    for (size_t i = 0; i < TEST_GRAPH_SIZE * TEST_GRAPH_SIZE; i += 1) {
+        const int weight = (i % 3 == 0) ? -1 : (int) (i % 50);
+        switch (format) {
+        case MATRIX_U16:
+            ((uint16_t*) matrix->weights)[i] =
+                (weight == -1) ? MATRIX_U16_NO_EDGE : weight;
+            break;
+        case MATRIX_U8:
+            ((uint8_t*) matrix->weights)[i] =
+                (weight == -1) ? MATRIX_U8_NO_EDGE : weight;
+            break;
+        default:
+            ((int*) matrix->weights)[i] = weight;
+        }
+    }
+    if (with_presence) matrix_mark_presence(matrix);
+    return matrix;
+}
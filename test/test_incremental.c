@@ -0,0 +1,172 @@
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "buckets.h"
+#include "dijkstra.h"
+#include "heap.h"
+#include "incremental.h"
+#include "matrix.h"
+#include "rnggraph.h"
+#include "sweep.h"
+#include "workspace.h"
+
+#define TEST_GRAPH_SIZE (70)
+
+int edges[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+int paths[TEST_GRAPH_SIZE];
+int distances[TEST_GRAPH_SIZE];
+int want[TEST_GRAPH_SIZE];
+int want_paths[TEST_GRAPH_SIZE];
+
+static void expect_repairs_match_new_runs(struct matrix*, int);
+static void expect_shortest_path_tree(struct matrix const*, unsigned int);
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_decrease_shortcuts_path(void)
+{
+    struct workspace *ws = workspace_create(3);
+    for (int i = 0; i < 3*3; i += 1)
+        edges[i] = -1;
+    edges[0*3 + 1] = 5;
+    edges[1*3 + 2] = 5;
+    struct matrix matrix = matrix_of_ints(edges, 3);
+    dijkstra_matrix(ws, &matrix, 0, paths);
+    dijkstra_distances(ws, 3, distances);
+
+    const struct edge_update update = { 0, 2, 3 };
+    TEST_ASSERT_TRUE(incremental_update(ws, &matrix, 0, &update, 1,
+                paths, distances));
+    TEST_ASSERT_EQUAL_INT(3, edges[0*3 + 2]);
+    TEST_ASSERT_EQUAL_INT(0, paths[2]);
+    TEST_ASSERT_EQUAL_INT(3, distances[2]);
+    TEST_ASSERT_EQUAL_INT(5, distances[1]);
+
+    workspace_destroy(ws);
+}
+
+void test_removal_disconnects_subtree(void)
+{
+    struct workspace *ws = workspace_create(3);
+    for (int i = 0; i < 3*3; i += 1)
+        edges[i] = -1;
+    edges[0*3 + 1] = 5;
+    edges[1*3 + 2] = 5;
+    struct matrix matrix = matrix_of_ints(edges, 3);
+    dijkstra_matrix(ws, &matrix, 0, paths);
+    dijkstra_distances(ws, 3, distances);
+
+    const struct edge_update update = { 0, 1, -1 };
+    TEST_ASSERT_TRUE(incremental_update(ws, &matrix, 0, &update, 1,
+                paths, distances));
+    TEST_ASSERT_EQUAL_INT(-1, distances[1]);
+    TEST_ASSERT_EQUAL_INT(-1, distances[2]);
+    TEST_ASSERT_EQUAL_INT(-1, paths[1]);
+    TEST_ASSERT_EQUAL_INT(-1, paths[2]);
+
+    workspace_destroy(ws);
+}
+
+void test_rejects_unstorable_weights(void)
+{
+    struct workspace *ws = workspace_create(3);
+    struct matrix *matrix = matrix_create(3, MATRIX_U8);
+    memset(matrix->weights, MATRIX_U8_NO_EDGE, 3*3);
+    dijkstra_matrix(ws, matrix, 0, paths);
+    dijkstra_distances(ws, 3, distances);
+
+    const struct edge_update updates[2] = { { 0, 1, 1 }, { 0, 2, 300 } };
+    TEST_ASSERT_FALSE(incremental_update(ws, matrix, 0, updates, 2,
+                paths, distances));
+    TEST_ASSERT_EQUAL_INT(-1, matrix_weight(matrix, 0, 1));
+
+    matrix_destroy(matrix);
+    workspace_destroy(ws);
+}
+
+void test_random_updates_match_new_runs(void)
+{
+    set_seed(4);
+    generate_graph(TEST_GRAPH_SIZE, 0.08, 9, edges);
+    struct matrix matrix = matrix_of_ints(edges, TEST_GRAPH_SIZE);
+    expect_repairs_match_new_runs(&matrix, 9);
+}
+
+void test_random_updates_on_bitmap_matrix(void)
+{
+    struct matrix *matrix = matrix_create_bitmap(TEST_GRAPH_SIZE, MATRIX_U8);
+    set_seed(5);
+    generate_graph(TEST_GRAPH_SIZE, 0.08, 9, edges);
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1)
+            matrix_set_weight(matrix, v, w, edges[v*TEST_GRAPH_SIZE + w]);
+    expect_repairs_match_new_runs(matrix, 9);
+    matrix_destroy(matrix);
+}
+
+/*
+ * Make batches of random changes, raising, lowering, removing
+ * and adding edges, and check each repair against a new run.
+ */
+static void
+expect_repairs_match_new_runs(struct matrix *matrix, int max_weight)
+{
+    const unsigned int source = 3;
+    struct workspace *ws = workspace_create(TEST_GRAPH_SIZE);
+    struct workspace *check = workspace_create(TEST_GRAPH_SIZE);
+    dijkstra_matrix(ws, matrix, source, paths);
+    dijkstra_distances(ws, TEST_GRAPH_SIZE, distances);
+
+    srand(1);
+    for (int batch = 0; batch < 200; batch += 1) {
+        struct edge_update updates[4];
+        const unsigned int nupdates = 1 + rand() % 4;
+        for (unsigned int i = 0; i < nupdates; i += 1) {
+            // Mostly edges on the paths, where changes matter.
+            updates[i].to = rand() % TEST_GRAPH_SIZE;
+            updates[i].from = (rand() % 2 && paths[updates[i].to] != -1)
+                ? (unsigned int) paths[updates[i].to]
+                : (unsigned int) rand() % TEST_GRAPH_SIZE;
+            updates[i].weight = (rand() % 4 == 0) ? -1
+                : rand() % (max_weight + 1);
+        }
+
+        TEST_ASSERT_TRUE(incremental_update(ws, matrix, source, updates,
+                    nupdates, paths, distances));
+        dijkstra_matrix(check, matrix, source, want_paths);
+        dijkstra_distances(check, TEST_GRAPH_SIZE, want);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want, distances, TEST_GRAPH_SIZE);
+        expect_shortest_path_tree(matrix, source);
+    }
+
+    workspace_destroy(check);
+    workspace_destroy(ws);
+}
+
+/*
+ * Check that every reachable vertex's predecessor is on a
+ * shortest path to it, and every unreachable one has none.
+ */
+static void
+expect_shortest_path_tree(struct matrix const*matrix, unsigned int source)
+{
+    TEST_ASSERT_EQUAL_INT(source, paths[source]);
+    for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1) {
+        if (w == source) continue;
+        if (distances[w] == -1) {
+            TEST_ASSERT_EQUAL_INT(-1, paths[w]);
+            continue;
+        }
+        const int v = paths[w];
+        TEST_ASSERT_TRUE(v >= 0);
+        TEST_ASSERT_NOT_EQUAL(-1, matrix_weight(matrix, v, w));
+        TEST_ASSERT_EQUAL_INT(distances[w],
+                distances[v] + matrix_weight(matrix, v, w));
+    }
+}
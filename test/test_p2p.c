@@ -0,0 +1,170 @@
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "batch.h"
+#include "buckets.h"
+#include "csrgraph.h"
+#include "dijkstra.h"
+#include "heap.h"
+#include "matrix.h"
+#include "p2p.h"
+#include "rnggraph.h"
+#include "sdijkstra.h"
+#include "sweep.h"
+#include "workspace.h"
+
+#define TEST_GRAPH_SIZE (80)
+
+int edges[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+int paths[TEST_GRAPH_SIZE];
+int want_paths[TEST_GRAPH_SIZE];
+int want[TEST_GRAPH_SIZE];
+
+static void expect_same_as_sdijkstra(enum p2p_mode, unsigned int);
+static int path_length(struct csr_graph const*, unsigned int, unsigned int);
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_transpose_reverses_edges(void)
+{
+    set_seed(3);
+    generate_graph(TEST_GRAPH_SIZE, 0.1, 8, edges);
+    struct csr_graph *graph = csr_from_matrix(edges, TEST_GRAPH_SIZE);
+    struct csr_graph *reverse = csr_transpose(graph);
+
+    int transposed[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+    for (int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        for (int w = 0; w < TEST_GRAPH_SIZE; w += 1)
+            transposed[w*TEST_GRAPH_SIZE + v] = edges[v*TEST_GRAPH_SIZE + w];
+    struct csr_graph *want_reverse = csr_from_matrix(transposed,
+            TEST_GRAPH_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(want_reverse->nedges, reverse->nedges);
+    for (int v = 0; v <= TEST_GRAPH_SIZE; v += 1)
+        TEST_ASSERT_TRUE(want_reverse->offsets[v] == reverse->offsets[v]);
+    TEST_ASSERT_EQUAL_INT_ARRAY(want_reverse->targets, reverse->targets,
+            reverse->nedges);
+    TEST_ASSERT_EQUAL_INT_ARRAY(want_reverse->weights, reverse->weights,
+            reverse->nedges);
+
+    csr_free(want_reverse);
+    csr_free(reverse);
+    csr_free(graph);
+}
+
+void test_dijkstra_same_path_as_sdijkstra(void)
+{
+    expect_same_as_sdijkstra(P2P_DIJKSTRA, 0);
+}
+
+void test_bidirectional_same_distance_as_sdijkstra(void)
+{
+    expect_same_as_sdijkstra(P2P_BIDIRECTIONAL, 0);
+}
+
+void test_alt_same_distance_as_sdijkstra(void)
+{
+    expect_same_as_sdijkstra(P2P_ALT, 4);
+}
+
+void test_unreachable_target(void)
+{
+    for (int i = 0; i < 3*3; i += 1)
+        edges[i] = -1;
+    edges[0*3 + 1] = 2;
+    struct csr_graph *graph = csr_from_matrix(edges, 3);
+    struct p2p *p2p = p2p_create(graph, 2);
+
+    TEST_ASSERT_EQUAL_INT(2, p2p_query(p2p, 0, 1, P2P_ALT, paths));
+    TEST_ASSERT_EQUAL_INT(-1, p2p_query(p2p, 0, 2, P2P_DIJKSTRA, paths));
+    TEST_ASSERT_EQUAL_INT(-1, p2p_query(p2p, 0, 2, P2P_BIDIRECTIONAL, paths));
+    TEST_ASSERT_EQUAL_INT(-1, p2p_query(p2p, 0, 2, P2P_ALT, paths));
+    TEST_ASSERT_EQUAL_INT(-1, p2p_query(p2p, 1, 0, P2P_ALT, paths));
+    TEST_ASSERT_EQUAL_INT(0, p2p_query(p2p, 2, 2, P2P_BIDIRECTIONAL, paths));
+
+    p2p_destroy(p2p);
+    csr_free(graph);
+}
+
+void test_stops_early(void)
+{
+    // A path 0 -> 1 -> ... -> size-1; finding vertex 1 shouldn't
+    // need any more than the first two.
+    for (int i = 0; i < TEST_GRAPH_SIZE * TEST_GRAPH_SIZE; i += 1)
+        edges[i] = -1;
+    for (int v = 0; v + 1 < TEST_GRAPH_SIZE; v += 1)
+        edges[v*TEST_GRAPH_SIZE + v+1] = 1;
+    struct csr_graph *graph = csr_from_matrix(edges, TEST_GRAPH_SIZE);
+    struct p2p *p2p = p2p_create(graph, 0);
+
+    TEST_ASSERT_EQUAL_INT(1, p2p_query(p2p, 0, 1, P2P_DIJKSTRA, paths));
+    TEST_ASSERT_EQUAL_INT(2, p2p->settled);
+    TEST_ASSERT_EQUAL_INT(0, paths[1]);
+
+    p2p_destroy(p2p);
+    csr_free(graph);
+}
+
+/*
+ * Query every pair of a random graph, with zero weight edges,
+ * against the distances from `sdijkstra`, checking that each path
+ * leads back from the target to the source with that length.
+ * Plain Dijkstra should also find exactly the same path.
+ */
+static void
+expect_same_as_sdijkstra(enum p2p_mode mode, unsigned int nlandmarks)
+{
+    set_seed(11);
+    generate_graph(TEST_GRAPH_SIZE, 0.06, 3, edges);
+    struct csr_graph *graph = csr_from_matrix(edges, TEST_GRAPH_SIZE);
+    struct workspace *ws = workspace_create(TEST_GRAPH_SIZE);
+    struct p2p *p2p = p2p_create(graph, nlandmarks);
+    TEST_ASSERT_NOT_NULL(p2p);
+
+    for (unsigned int s = 0; s < TEST_GRAPH_SIZE; s += 1) {
+        sdijkstra_with(ws, graph, s, want_paths);
+        sdijkstra_distances(ws, TEST_GRAPH_SIZE, want);
+
+        for (unsigned int t = 0; t < TEST_GRAPH_SIZE; t += 1) {
+            const int distance = p2p_query(p2p, s, t, mode, paths);
+            TEST_ASSERT_EQUAL_INT(want[t], distance);
+            if (distance == -1) continue;
+
+            TEST_ASSERT_EQUAL_INT(distance, path_length(graph, s, t));
+            if (mode == P2P_DIJKSTRA)
+                for (unsigned int v = t; v != s; v = paths[v])
+                    TEST_ASSERT_EQUAL_INT(want_paths[v], paths[v]);
+        }
+    }
+
+    p2p_destroy(p2p);
+    workspace_destroy(ws);
+    csr_free(graph);
+}
+
+/*
+ * The length of the path from the source to the target in the
+ * paths, following the predecessors back from the target.
+ */
+static int
+path_length(struct csr_graph const*graph, unsigned int source,
+        unsigned int target)
+{
+    int length = 0;
+    unsigned int hops = 0;
+    for (unsigned int w = target; w != source; w = paths[w]) {
+        const unsigned int v = paths[w];
+        TEST_ASSERT_TRUE(v < TEST_GRAPH_SIZE);
+        TEST_ASSERT_TRUE(hops < TEST_GRAPH_SIZE);
+        TEST_ASSERT_NOT_EQUAL(-1, edges[v*TEST_GRAPH_SIZE + w]);
+        length += edges[v*TEST_GRAPH_SIZE + w];
+        hops += 1;
+    }
+    return length;
+}
@@ -0,0 +1,125 @@
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "buckets.h"
+#include "dijkstra.h"
+#include "heap.h"
+#include "matrix.h"
+#include "pdijkstra.h"
+#include "rnggraph.h"
+#include "sweep.h"
+#include "workspace.h"
+
+#define TEST_GRAPH_SIZE (150)
+
+int edges[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+int paths[TEST_GRAPH_SIZE];
+int want_paths[TEST_GRAPH_SIZE];
+
+static void expect_same_distances(unsigned int, bool);
+static int path_distance(int const*, unsigned int, unsigned int,
+        unsigned int);
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_pdijkstra_same_distances_as_dijkstra(void)
+{
+    for (int nthreads = 1; nthreads <= 4; nthreads += 1) {
+        omp_set_num_threads(nthreads);
+        expect_same_distances(TEST_GRAPH_SIZE, false);
+    }
+}
+
+void test_persistent_same_distances_as_dijkstra(void)
+{
+    for (int nthreads = 1; nthreads <= 4; nthreads += 1) {
+        omp_set_num_threads(nthreads);
+        expect_same_distances(TEST_GRAPH_SIZE, true);
+    }
+}
+
+void test_persistent_fewer_vertices_than_threads(void)
+{
+    // Some threads own no vertices at all.
+    omp_set_num_threads(8);
+    for (unsigned int size = 1; size < 8; size += 1)
+        expect_same_distances(size, true);
+}
+
+void test_persistent_matrix_narrow_formats(void)
+{
+    set_seed(12);
+    generate_graph(TEST_GRAPH_SIZE, 0.05, 200, edges);
+    struct matrix *narrow = matrix_create_bitmap(TEST_GRAPH_SIZE, MATRIX_U8);
+    uint8_t *const weights = narrow->weights;
+    for (size_t i = 0; i < TEST_GRAPH_SIZE * TEST_GRAPH_SIZE; i += 1)
+        weights[i] = (edges[i] == -1) ? MATRIX_U8_NO_EDGE : edges[i];
+    matrix_mark_presence(narrow);
+    struct workspace *ws = workspace_create(TEST_GRAPH_SIZE);
+
+    omp_set_num_threads(3);
+    dijkstra(edges, TEST_GRAPH_SIZE, 5, want_paths);
+    pdijkstra_persistent_matrix(ws, narrow, 5, paths);
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        TEST_ASSERT_EQUAL_INT(path_distance(want_paths, TEST_GRAPH_SIZE, 5, v),
+                path_distance(paths, TEST_GRAPH_SIZE, 5, v));
+
+    workspace_destroy(ws);
+    matrix_destroy(narrow);
+}
+
+/*
+ * Run `pdijkstra`, or its persistent variant, from several sources
+ * of random graphs of the specified size, with zero weight edges,
+ * and check the length of every path against the length of
+ * `dijkstra`'s.  Ties may be broken differently, so the paths
+ * themselves aren't compared.
+ */
+static void
+expect_same_distances(unsigned int size, bool persistent)
+{
+    for (unsigned int seed = 0; seed < 3; seed += 1) {
+        set_seed(seed);
+        generate_graph(size, 0.1, 4, edges);
+        for (unsigned int source = 0; source < size; source += 7) {
+            TEST_ASSERT_TRUE(dijkstra(edges, size, source, want_paths));
+            TEST_ASSERT_TRUE((persistent)
+                    ? pdijkstra_persistent(edges, size, source, paths)
+                    : pdijkstra(edges, size, source, paths));
+
+            for (unsigned int v = 0; v < size; v += 1)
+                TEST_ASSERT_EQUAL_INT(
+                        path_distance(want_paths, size, source, v),
+                        path_distance(paths, size, source, v));
+        }
+    }
+}
+
+/*
+ * The length of the path from the source to v in the paths,
+ * or -1 if v has no path.
+ */
+static int
+path_distance(int const*paths, unsigned int size, unsigned int source,
+        unsigned int v)
+{
+    if (paths[v] == -1) return -1;
+    int distance = 0;
+    unsigned int hops = 0;
+    for (unsigned int w = v; w != source; w = paths[w]) {
+        const int u = paths[w];
+        TEST_ASSERT_TRUE(u >= 0 && (unsigned int) u < size);
+        TEST_ASSERT_TRUE(hops < size);
+        TEST_ASSERT_NOT_EQUAL(-1, edges[u*size + w]);
+        distance += edges[u*size + w];
+        hops += 1;
+    }
+    return distance;
+}
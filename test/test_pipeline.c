@@ -0,0 +1,98 @@
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "buckets.h"
+#include "dijkstra.h"
+#include "heap.h"
+#include "matrix.h"
+#include "pdijkstra.h"
+#include "pipeline.h"
+#include "prnggraph.h"
+#include "sweep.h"
+#include "workspace.h"
+
+#define TEST_GRAPH_SIZE (60)
+#define TEST_NGRAPHS (7)
+
+int want[TEST_NGRAPHS][TEST_GRAPH_SIZE];
+int got[TEST_NGRAPHS][TEST_GRAPH_SIZE];
+int times_solved[TEST_NGRAPHS];
+unsigned int seeds[TEST_NGRAPHS] = { 4, 8, 15, 16, 23, 42, 4 };
+
+static void record(unsigned int, int const*, void*);
+static void expect_same_paths(unsigned int, int, bool);
+
+void setUp(void)
+{
+    struct matrix *matrix = matrix_create(TEST_GRAPH_SIZE, MATRIX_U8);
+    struct workspace *ws = workspace_create(TEST_GRAPH_SIZE);
+    for (int i = 0; i < TEST_NGRAPHS; i += 1) {
+        pset_seed(seeds[i]);
+        pgenerate_matrix(matrix, 0.2, 50);
+        dijkstra_matrix(ws, matrix, 2, want[i]);
+    }
+    workspace_destroy(ws);
+    matrix_destroy(matrix);
+
+    memset(got, 0, sizeof(got));
+    memset(times_solved, 0, sizeof(times_solved));
+}
+
+void tearDown(void)
+{
+}
+
+void test_one_thread_generates_and_solves_in_turn(void)
+{
+    expect_same_paths(1, 1, false);
+}
+
+void test_one_instance_overlaps(void)
+{
+    expect_same_paths(1, 3, true);
+}
+
+void test_instances_split_threads(void)
+{
+    expect_same_paths(3, 7, false);
+}
+
+void test_more_instances_than_graphs(void)
+{
+    expect_same_paths(TEST_NGRAPHS + 2, TEST_NGRAPHS + 2, true);
+}
+
+/*
+ * Run the pipeline over the seeds, and check that every graph
+ * was solved exactly once, with the same paths as on its own.
+ */
+static void
+expect_same_paths(unsigned int ninstances, int nthreads, bool bitmap)
+{
+    const struct pipeline pipeline = {
+        .size = TEST_GRAPH_SIZE, .b = 0.2, .max_weight = 50,
+        .bitmap = bitmap, .source = 2,
+        .ninstances = ninstances, .nthreads = nthreads,
+        .solved = record, .context = NULL,
+    };
+    struct pipeline_report report;
+    TEST_ASSERT_TRUE(pipeline_run(&pipeline, seeds, TEST_NGRAPHS, &report));
+    TEST_ASSERT_EQUAL_INT(TEST_NGRAPHS, report.graphs);
+
+    for (int i = 0; i < TEST_NGRAPHS; i += 1) {
+        TEST_ASSERT_EQUAL_INT(1, times_solved[i]);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want[i], got[i], TEST_GRAPH_SIZE);
+    }
+}
+
+/*
+ * Keep the paths of the ith graph.
+ */
+static void
+record(unsigned int i, int const*paths, void *context)
+{
+    (void) context;
+    memcpy(got[i], paths, sizeof(got[i]));
+#pragma omp atomic
+    times_solved[i] += 1;
+}
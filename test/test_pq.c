@@ -0,0 +1,182 @@
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "buckets.h"
+#include "csrgraph.h"
+#include "heap.h"
+#include "pq.h"
+#include "rnggraph.h"
+#include "sdijkstra.h"
+#include "workspace.h"
+
+#define TEST_GRAPH_SIZE (120)
+
+int edges[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+int paths[TEST_GRAPH_SIZE];
+int want[TEST_GRAPH_SIZE];
+int distances[TEST_GRAPH_SIZE];
+
+static void expect_same_as_model(enum pq_kind);
+static void expect_same_as_sdijkstra(enum pq_kind);
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_binary_same_as_model(void)
+{
+    expect_same_as_model(PQ_BINARY);
+}
+
+void test_quaternary_same_as_model(void)
+{
+    expect_same_as_model(PQ_QUATERNARY);
+}
+
+void test_pairing_same_as_model(void)
+{
+    expect_same_as_model(PQ_PAIRING);
+}
+
+void test_radix_same_as_model(void)
+{
+    expect_same_as_model(PQ_RADIX);
+}
+
+void test_dijkstra_same_as_sdijkstra(void)
+{
+    expect_same_as_sdijkstra(PQ_BINARY);
+    expect_same_as_sdijkstra(PQ_QUATERNARY);
+    expect_same_as_sdijkstra(PQ_PAIRING);
+    expect_same_as_sdijkstra(PQ_RADIX);
+}
+
+void test_clear_empties_queue(void)
+{
+    for (enum pq_kind kind = PQ_BINARY; kind <= PQ_RADIX; kind += 1) {
+        struct pq *pq = pq_create(kind, 10);
+        for (unsigned int v = 0; v < 10; v += 1)
+            pq_push(pq, v, 100 + 7*v % 10);
+        pq_pop(pq);
+        pq_clear(pq);
+        TEST_ASSERT_TRUE(pq_empty(pq));
+
+        // Every vertex can be queued again, with smaller keys.
+        for (unsigned int v = 0; v < 10; v += 1)
+            pq_push(pq, v, 10 - v);
+        TEST_ASSERT_EQUAL_INT(10, pq->count);
+        TEST_ASSERT_EQUAL_INT(1, pq_min_key(pq));
+        TEST_ASSERT_EQUAL_INT(9, pq_pop(pq));
+        pq_destroy(pq);
+    }
+}
+
+void test_kind_names(void)
+{
+    enum pq_kind kind;
+    for (enum pq_kind want_kind = PQ_BINARY; want_kind <= PQ_RADIX;
+            want_kind += 1) {
+        TEST_ASSERT_TRUE(pq_kind_named(pq_kind_name(want_kind), &kind));
+        TEST_ASSERT_EQUAL_INT(want_kind, kind);
+    }
+    TEST_ASSERT_FALSE(pq_kind_named("fibonacci", &kind));
+}
+
+/*
+ * Push, lower and pop at random, never below the last key popped,
+ * checking every pop against a plain array of the keys.  The
+ * implicit heaps should pop the lowest id of the smallest keys.
+ */
+static void
+expect_same_as_model(enum pq_kind kind)
+{
+    int keys[TEST_GRAPH_SIZE];
+    struct pq *pq = pq_create(kind, TEST_GRAPH_SIZE);
+    TEST_ASSERT_NOT_NULL(pq);
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        keys[v] = -1;
+
+    srand(kind + 1);
+    int last = 0;
+    unsigned int count = 0;
+    for (int step = 0; step < 20000; step += 1) {
+        if (count > 0 && rand() % 3 == 0) {
+            unsigned int smallest = 0;
+            for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+                if (keys[v] != -1 && (keys[smallest] == -1
+                            || keys[v] < keys[smallest]))
+                    smallest = v;
+
+            TEST_ASSERT_EQUAL_INT(keys[smallest], pq_min_key(pq));
+            const unsigned int v = pq_pop(pq);
+            TEST_ASSERT_EQUAL_INT(keys[smallest], keys[v]);
+            if (kind == PQ_BINARY || kind == PQ_QUATERNARY)
+                TEST_ASSERT_EQUAL_INT(smallest, v);
+            last = keys[v];
+            keys[v] = -1;
+            count -= 1;
+        } else {
+            const unsigned int v = rand() % TEST_GRAPH_SIZE;
+            // Keys far apart, to spread them over the radix buckets.
+            const int key = last + rand() % ((keys[v] == -1)
+                    ? 1 << (rand() % 24) : keys[v] - last + 1);
+            if (keys[v] == -1) count += 1;
+            keys[v] = key;
+            pq_push(pq, v, key);
+        }
+        TEST_ASSERT_EQUAL_INT(count, pq->count);
+    }
+
+    pq_destroy(pq);
+}
+
+/*
+ * Run Dijkstra's algorithm with the queue from every vertex of a
+ * random graph, with zero weight edges, against `sdijkstra`.
+ */
+static void
+expect_same_as_sdijkstra(enum pq_kind kind)
+{
+    set_seed(5);
+    generate_graph(TEST_GRAPH_SIZE, 0.05, 6, edges);
+    struct csr_graph *graph = csr_from_matrix(edges, TEST_GRAPH_SIZE);
+    struct workspace *ws = workspace_create(TEST_GRAPH_SIZE);
+    struct pq *pq = pq_create(kind, TEST_GRAPH_SIZE);
+    bool visited[TEST_GRAPH_SIZE];
+
+    for (unsigned int s = 0; s < TEST_GRAPH_SIZE; s += 1) {
+        sdijkstra_with(ws, graph, s, paths);
+        sdijkstra_distances(ws, TEST_GRAPH_SIZE, want);
+
+        for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1) {
+            distances[v] = -1;
+            visited[v] = false;
+        }
+        pq_clear(pq);
+        distances[s] = 0;
+        pq_push(pq, s, 0);
+        while (!pq_empty(pq)) {
+            const unsigned int v = pq_pop(pq);
+            visited[v] = true;
+            for (size_t e = graph->offsets[v]; e < graph->offsets[v+1];
+                    e += 1) {
+                const unsigned int w = graph->targets[e];
+                const int distance = distances[v] + graph->weights[e];
+                if (visited[w]) continue;
+                if (distances[w] == -1 || distance < distances[w]) {
+                    distances[w] = distance;
+                    pq_push(pq, w, distance);
+                }
+            }
+        }
+        TEST_ASSERT_EQUAL_INT_ARRAY(want, distances, TEST_GRAPH_SIZE);
+    }
+
+    pq_destroy(pq);
+    workspace_destroy(ws);
+    csr_free(graph);
+}
@@ -0,0 +1,168 @@
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "matrix.h"
+#include "prnggraph.h"
+
+#define TEST_GRAPH_SIZE (131)
+#define TEST_EDGES_SIZE (TEST_GRAPH_SIZE * TEST_GRAPH_SIZE)
+
+int edges[TEST_EDGES_SIZE];
+int want[TEST_EDGES_SIZE];
+int block[TEST_EDGES_SIZE];
+
+static void generate_with_threads(int, int*);
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    omp_set_num_threads(omp_get_num_procs());
+}
+
+void test_same_graph_for_any_thread_count(void)
+{
+    generate_with_threads(1, want);
+
+    const int nthreads[] = { 2, 3, 4, 7, 16 };
+    for (int i = 0; i < 5; i += 1) {
+        generate_with_threads(nthreads[i], edges);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want, edges, TEST_EDGES_SIZE);
+    }
+}
+
+void test_different_seeds_differ(void)
+{
+    pset_seed(1);
+    pgenerate_graph(TEST_GRAPH_SIZE, 0.5, 16, want);
+    pset_seed(2);
+    pgenerate_graph(TEST_GRAPH_SIZE, 0.5, 16, edges);
+
+    TEST_ASSERT_TRUE(memcmp(want, edges, sizeof(edges)) != 0);
+}
+
+void test_valid_edges(void)
+{
+    pset_seed(3);
+    pgenerate_graph(TEST_GRAPH_SIZE, 0.25, 16, edges);
+
+    int nedges = 0;
+    for (int i = 0; i < TEST_EDGES_SIZE; i += 1) {
+        TEST_ASSERT_TRUE(-1 <= edges[i] && edges[i] <= 16);
+        if (edges[i] != -1) nedges += 1;
+    }
+    // Expect about a quarter of the cells to have edges.
+    TEST_ASSERT_INT_WITHIN(TEST_EDGES_SIZE / 20, TEST_EDGES_SIZE / 4, nedges);
+}
+
+void test_blocks_piece_together(void)
+{
+    generate_with_threads(3, want);
+
+    const unsigned int cuts[] = { 0, 1, 50, 64, 130, TEST_GRAPH_SIZE };
+    for (int c = 0; c + 1 < 6; c += 1) {
+        const unsigned int min = cuts[c], max = cuts[c+1];
+        pset_seed(5);
+        pgenerate_block(TEST_GRAPH_SIZE, min, max, 0.3, 100, block);
+
+        for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+            TEST_ASSERT_EQUAL_INT_ARRAY(want + v*TEST_GRAPH_SIZE + min,
+                    block + v*(max - min), max - min);
+    }
+}
+
+void test_narrow_matrix_same_graph(void)
+{
+    generate_with_threads(4, want);
+
+    struct matrix *matrix = matrix_create(TEST_GRAPH_SIZE, MATRIX_U8);
+    pset_seed(5);
+    pgenerate_matrix(matrix, 0.3, 100);
+
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1)
+            TEST_ASSERT_EQUAL_INT(want[v*TEST_GRAPH_SIZE + w],
+                    matrix_weight(matrix, v, w));
+
+    matrix_destroy(matrix);
+}
+
+void test_implicit_matrix_same_graph(void)
+{
+    generate_with_threads(2, want);
+
+    struct matrix *matrix = matrix_create(TEST_GRAPH_SIZE, MATRIX_IMPLICIT);
+    TEST_ASSERT_NULL(matrix->weights);
+    pset_seed(5);
+    pgenerate_matrix(matrix, 0.3, 100);
+
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1)
+            TEST_ASSERT_EQUAL_INT(want[v*TEST_GRAPH_SIZE + w],
+                    matrix_weight(matrix, v, w));
+
+    matrix_destroy(matrix);
+}
+
+void test_partitioned_matrix_same_graph(void)
+{
+    generate_with_threads(1, want);
+
+    const int nthreads[] = { 1, 3, 4 };
+    for (int i = 0; i < 3; i += 1) {
+        for (unsigned int nparts = 1; nparts <= 5; nparts += 1) {
+            struct matrix *matrix = matrix_create_partitioned(TEST_GRAPH_SIZE,
+                    MATRIX_U16, nparts);
+            omp_set_num_threads(nthreads[i]);
+            pset_seed(5);
+            pgenerate_matrix(matrix, 0.3, 100);
+
+            for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+                for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1)
+                    TEST_ASSERT_EQUAL_INT(want[v*TEST_GRAPH_SIZE + w],
+                            matrix_weight(matrix, v, w));
+
+            matrix_destroy(matrix);
+        }
+    }
+}
+
+void test_huge_page_matrices_same_graph(void)
+{
+    generate_with_threads(1, want);
+    matrix_use_pages(MATRIX_PAGES_TRANSPARENT);
+
+    struct matrix *matrices[3] = {
+        matrix_create(TEST_GRAPH_SIZE, MATRIX_U8),
+        matrix_create_bitmap(TEST_GRAPH_SIZE, MATRIX_INT),
+        matrix_create_partitioned(TEST_GRAPH_SIZE, MATRIX_U16, 3),
+    };
+    for (int i = 0; i < 3; i += 1) {
+        TEST_ASSERT_NOT_NULL(matrices[i]);
+        TEST_ASSERT_EQUAL_INT(MATRIX_PAGES_TRANSPARENT, matrices[i]->pages);
+        omp_set_num_threads(2);
+        pset_seed(5);
+        pgenerate_matrix(matrices[i], 0.3, 100);
+
+        for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+            for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1)
+                TEST_ASSERT_EQUAL_INT(want[v*TEST_GRAPH_SIZE + w],
+                        matrix_weight(matrices[i], v, w));
+        matrix_destroy(matrices[i]);
+    }
+
+    matrix_use_pages(MATRIX_PAGES_DEFAULT);
+}
+
+/*
+ * Generate the graph for seed 5 with the specified number of threads.
+ */
+static void
+generate_with_threads(int nthreads, int *out)
+{
+    omp_set_num_threads(nthreads);
+    pset_seed(5);
+    pgenerate_graph(TEST_GRAPH_SIZE, 0.3, 100, out);
+}
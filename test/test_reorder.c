@@ -0,0 +1,217 @@
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "buckets.h"
+#include "csrgraph.h"
+#include "dijkstra.h"
+#include "heap.h"
+#include "matrix.h"
+#include "reorder.h"
+#include "rnggraph.h"
+#include "sdijkstra.h"
+#include "sweep.h"
+#include "workspace.h"
+
+#define TEST_GRAPH_SIZE (100)
+
+int edges[TEST_GRAPH_SIZE * TEST_GRAPH_SIZE];
+int paths[TEST_GRAPH_SIZE];
+int renumbered[TEST_GRAPH_SIZE];
+int distances[TEST_GRAPH_SIZE];
+int want[TEST_GRAPH_SIZE];
+
+static void expect_permutation(struct reorder const*);
+static void expect_tree_of(unsigned int, int const*, int const*);
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_orders_are_permutations(void)
+{
+    set_seed(4);
+    generate_graph(TEST_GRAPH_SIZE, 0.02, 5, edges);
+    struct csr_graph *graph = csr_from_matrix(edges, TEST_GRAPH_SIZE);
+    for (enum reorder_kind kind = REORDER_BFS; kind <= REORDER_DEGREE;
+            kind += 1) {
+        struct reorder *reorder = reorder_create(graph, kind);
+        TEST_ASSERT_NOT_NULL(reorder);
+        expect_permutation(reorder);
+        reorder_destroy(reorder);
+    }
+    csr_free(graph);
+}
+
+void test_rcm_numbers_scrambled_path_in_order(void)
+{
+    // A path through the vertices in a scrambled order; reverse
+    // Cuthill-McKee should put every edge next to the diagonal.
+    unsigned int scrambled[TEST_GRAPH_SIZE];
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        scrambled[v] = (37*v + 11) % TEST_GRAPH_SIZE;
+    for (int i = 0; i < TEST_GRAPH_SIZE * TEST_GRAPH_SIZE; i += 1)
+        edges[i] = -1;
+    for (unsigned int i = 0; i + 1 < TEST_GRAPH_SIZE; i += 1)
+        edges[scrambled[i]*TEST_GRAPH_SIZE + scrambled[i+1]] = 1;
+    struct csr_graph *graph = csr_from_matrix(edges, TEST_GRAPH_SIZE);
+
+    struct reorder *reorder = reorder_create(graph, REORDER_RCM);
+    expect_permutation(reorder);
+    struct csr_graph *permuted = reorder_csr(reorder, graph);
+    TEST_ASSERT_EQUAL_INT(graph->nedges, permuted->nedges);
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        for (size_t e = permuted->offsets[v]; e < permuted->offsets[v+1];
+                e += 1)
+            TEST_ASSERT_EQUAL_INT(1, abs((int) permuted->targets[e] - (int) v));
+
+    csr_free(permuted);
+    reorder_destroy(reorder);
+    csr_free(graph);
+}
+
+void test_degree_order_puts_hubs_first(void)
+{
+    set_seed(6);
+    generate_graph(TEST_GRAPH_SIZE, 0.05, 5, edges);
+    // One vertex with an edge to and from every other.
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1) {
+        edges[57*TEST_GRAPH_SIZE + v] = 1;
+        edges[v*TEST_GRAPH_SIZE + 57] = 1;
+    }
+    struct csr_graph *graph = csr_from_matrix(edges, TEST_GRAPH_SIZE);
+    struct csr_graph *reverse = csr_transpose(graph);
+    struct reorder *reorder = reorder_create(graph, REORDER_DEGREE);
+
+    TEST_ASSERT_EQUAL_INT(57, reorder->order[0]);
+    size_t last = SIZE_MAX;
+    for (unsigned int i = 0; i < TEST_GRAPH_SIZE; i += 1) {
+        const unsigned int v = reorder->order[i];
+        const size_t degree = graph->offsets[v+1] - graph->offsets[v]
+            + reverse->offsets[v+1] - reverse->offsets[v];
+        TEST_ASSERT_TRUE(degree <= last);
+        last = degree;
+    }
+
+    reorder_destroy(reorder);
+    csr_free(reverse);
+    csr_free(graph);
+}
+
+void test_csr_paths_map_back(void)
+{
+    set_seed(8);
+    generate_graph(TEST_GRAPH_SIZE, 0.04, 6, edges);
+    struct csr_graph *graph = csr_from_matrix(edges, TEST_GRAPH_SIZE);
+    struct workspace *ws = workspace_create(TEST_GRAPH_SIZE);
+
+    for (enum reorder_kind kind = REORDER_BFS; kind <= REORDER_DEGREE;
+            kind += 1) {
+        struct reorder *reorder = reorder_create(graph, kind);
+        struct csr_graph *permuted = reorder_csr(reorder, graph);
+        for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+            for (size_t e = permuted->offsets[v] + 1;
+                    e < permuted->offsets[v+1]; e += 1)
+                TEST_ASSERT_TRUE(permuted->targets[e-1] < permuted->targets[e]);
+
+        for (unsigned int s = 0; s < TEST_GRAPH_SIZE; s += 7) {
+            sdijkstra_with(ws, graph, s, paths);
+            sdijkstra_distances(ws, TEST_GRAPH_SIZE, want);
+
+            sdijkstra_with(ws, permuted, reorder->rank[s], renumbered);
+            sdijkstra_distances(ws, TEST_GRAPH_SIZE, distances);
+            reorder_values(reorder, distances, paths);
+            TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_GRAPH_SIZE);
+
+            reorder_paths(reorder, renumbered, paths);
+            expect_tree_of(s, paths, want);
+        }
+        csr_free(permuted);
+        reorder_destroy(reorder);
+    }
+
+    workspace_destroy(ws);
+    csr_free(graph);
+}
+
+void test_matrix_paths_map_back(void)
+{
+    set_seed(9);
+    generate_graph(TEST_GRAPH_SIZE, 0.01, 100, edges);
+    const struct matrix ints = matrix_of_ints(edges, TEST_GRAPH_SIZE);
+    struct matrix *matrix = matrix_create_bitmap(TEST_GRAPH_SIZE, MATRIX_U8);
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1)
+            matrix_set_weight(matrix, v, w, matrix_weight(&ints, v, w));
+    matrix_mark_presence(matrix);
+    struct csr_graph *graph = csr_from_matrix(edges, TEST_GRAPH_SIZE);
+    struct reorder *reorder = reorder_create(graph, REORDER_RCM);
+    struct matrix *permuted = reorder_matrix(reorder, matrix);
+    struct workspace *ws = workspace_create(TEST_GRAPH_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(MATRIX_U8, permuted->format);
+    TEST_ASSERT_NOT_NULL(permuted->presence);
+    for (unsigned int v = 0; v < TEST_GRAPH_SIZE; v += 1)
+        for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1)
+            TEST_ASSERT_EQUAL_INT(edges[v*TEST_GRAPH_SIZE + w],
+                    matrix_weight(permuted, reorder->rank[v],
+                        reorder->rank[w]));
+
+    const unsigned int source = 3;
+    dijkstra_matrix(ws, matrix, source, paths);
+    dijkstra_distances(ws, TEST_GRAPH_SIZE, want);
+    dijkstra_matrix(ws, permuted, reorder->rank[source], renumbered);
+    reorder_paths(reorder, renumbered, paths);
+    expect_tree_of(source, paths, want);
+
+    workspace_destroy(ws);
+    matrix_destroy(permuted);
+    reorder_destroy(reorder);
+    csr_free(graph);
+    matrix_destroy(matrix);
+}
+
+void test_kind_names(void)
+{
+    enum reorder_kind kind;
+    TEST_ASSERT_TRUE(reorder_kind_named("rcm", &kind));
+    TEST_ASSERT_EQUAL_INT(REORDER_RCM, kind);
+    TEST_ASSERT_FALSE(reorder_kind_named("random", &kind));
+}
+
+/*
+ * Checks that the order and rank are inverse permutations.
+ */
+static void
+expect_permutation(struct reorder const*reorder)
+{
+    bool numbered[TEST_GRAPH_SIZE] = { false };
+    for (unsigned int i = 0; i < TEST_GRAPH_SIZE; i += 1) {
+        const unsigned int v = reorder->order[i];
+        TEST_ASSERT_TRUE(v < TEST_GRAPH_SIZE);
+        TEST_ASSERT_FALSE(numbered[v]);
+        numbered[v] = true;
+        TEST_ASSERT_EQUAL_INT(i, reorder->rank[v]);
+    }
+}
+
+/*
+ * Checks that the paths, in the original ids, are a shortest path
+ * tree from the source: every predecessor's edge in `edges` is
+ * tight with the distances.
+ */
+static void
+expect_tree_of(unsigned int source, int const*tree, int const*distances)
+{
+    TEST_ASSERT_EQUAL_INT(source, tree[source]);
+    for (unsigned int w = 0; w < TEST_GRAPH_SIZE; w += 1) {
+        TEST_ASSERT_EQUAL_INT(distances[w] == -1, tree[w] == -1);
+        if (w == source || tree[w] == -1) continue;
+        const int weight = edges[tree[w]*TEST_GRAPH_SIZE + w];
+        TEST_ASSERT_NOT_EQUAL(-1, weight);
+        TEST_ASSERT_EQUAL_INT(distances[w], distances[tree[w]] + weight);
+    }
+}
@@ -0,0 +1,299 @@
+#include<stdlib.h>
+#include<stdio.h>
+#include <stdbool.h>
+
+#include "unity.h"
+#include "csrgraph.h"
+#include "heap.h"
+#include "sdijkstra.h"
+#include "sweep.h"
+#include "workspace.h"
+#include "dijkstra.h"
+#include "rnggraph.h"
+#include "matrix.h"
+#include "buckets.h"
+
+#define TEST_MAX_GRAPH_SIZE (10)
+
+int edges[TEST_MAX_GRAPH_SIZE * TEST_MAX_GRAPH_SIZE] = {0};
+int paths[TEST_MAX_GRAPH_SIZE * TEST_MAX_GRAPH_SIZE] = {0};
+int size;
+int source;
+int want[TEST_MAX_GRAPH_SIZE * TEST_MAX_GRAPH_SIZE] = {0};
+
+void setUp(void)
+{
+    memcpy(want, paths, sizeof(edges));
+
+    for (int i = 0; i < TEST_MAX_GRAPH_SIZE * TEST_MAX_GRAPH_SIZE; i += 1)
+        edges[i] = -1;
+
+    for (int i = 2; i < TEST_MAX_GRAPH_SIZE; i += 1)
+        want[i] = paths[i];
+}
+
+void tearDown(void)
+{
+}
+
+/*
+ * Run the sparse algorithm over the dense test matrix.
+ */
+static void
+run_sdijkstra(void)
+{
+    struct csr_graph *graph = csr_from_matrix(edges, size);
+    TEST_ASSERT_NOT_NULL(graph);
+    sdijkstra(graph, source, paths);
+    csr_free(graph);
+}
+
+void test_single_node(void)
+{
+    size = 1;
+    source = 0;
+
+    want[0] = 0;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_two_nodes_no_edge_source_zero(void)
+{
+    size = 2;
+    source = 0;
+
+    want[0] = 0;
+    want[1] = -1;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_two_nodes_forward_edge_source_zero(void)
+{
+    size = 2;
+    edges[0*size + 1] = 4;
+    source = 0;
+
+    want[0] = 0;
+    want[1] = 0;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_two_nodes_forward_edge_source_one(void)
+{
+    size = 2;
+    edges[0*size + 1] = 4;
+    source = 1;
+
+    want[0] = -1;
+    want[1] = 1;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_two_nodes_backward_edge_source_one(void)
+{
+    size = 2;
+    edges[1*size + 0] = 4;
+    source = 1;
+
+    want[0] = 1;
+    want[1] = 1;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_two_nodes_loop_source_zero(void)
+{
+    size = 2;
+    edges[1*size + 0] = 4;
+    edges[0*size + 1] = 4;
+    source = 0;
+
+    want[0] = 0;
+    want[1] = 0;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_five_nodes_no_edge_source_zero(void)
+{
+    size = 5;
+    source = 0;
+
+    want[0] = 0;
+    want[1] = -1;
+    want[2] = -1;
+    want[3] = -1;
+    want[4] = -1;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_five_nodes_forward_edges_source_zero(void)
+{
+    size = 5;
+    edges[0*size + 1] = 0;
+    edges[1*size + 2] = 0;
+    edges[2*size + 3] = 0;
+    edges[3*size + 4] = 0;
+    source = 0;
+
+    want[0] = 0;
+    want[1] = 0;
+    want[2] = 1;
+    want[3] = 2;
+    want[4] = 3;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_five_nodes_forward_edge_source_two(void)
+{
+    size = 5;
+    edges[0*size + 1] = 0;
+    edges[1*size + 2] = 0;
+    edges[2*size + 3] = 0;
+    edges[3*size + 4] = 0;
+    source = 2;
+
+    want[0] = -1;
+    want[1] = -1;
+    want[2] = 2;
+    want[3] = 2;
+    want[4] = 3;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_five_nodes_backward_edges_source_two(void)
+{
+    size = 5;
+    edges[1*size + 0] = 0;
+    edges[2*size + 1] = 0;
+    edges[3*size + 2] = 0;
+    edges[4*size + 3] = 0;
+    source = 2;
+
+    want[0] = 1;
+    want[1] = 2;
+    want[2] = 2;
+    want[3] = -1;
+    want[4] = -1;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_five_nodes_loop_source_two(void)
+{
+    size = 5;
+    edges[0*size + 1] = 0;
+    edges[1*size + 2] = 0;
+    edges[2*size + 3] = 0;
+    edges[3*size + 4] = 0;
+    edges[4*size + 0] = 0;
+    source = 2;
+
+    want[0] = 4;
+    want[1] = 0;
+    want[2] = 2;
+    want[3] = 2;
+    want[4] = 3;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_lower_path(void)
+{
+    size = 5;
+    edges[0*size + 1] = 3;
+    edges[0*size + 2] = 4;
+    edges[1*size + 3] = 0;
+    edges[2*size + 3] = 0;
+    edges[3*size + 4] = 0;
+    source = 0;
+
+    want[0] = 0;
+    want[1] = 0;
+    want[2] = 0;
+    want[3] = 1;
+    want[4] = 3;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_upper_path(void)
+{
+    size = 5;
+    edges[0*size + 1] = 4;
+    edges[0*size + 2] = 3;
+    edges[1*size + 3] = 0;
+    edges[2*size + 3] = 0;
+    edges[3*size + 4] = 0;
+    source = 0;
+
+    want[0] = 0;
+    want[1] = 0;
+    want[2] = 0;
+    want[3] = 2;
+    want[4] = 3;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_upper_path_complex(void)
+{
+    size = 5;
+    edges[0*size + 1] = 2;
+    edges[0*size + 2] = 4;
+    edges[1*size + 3] = 5;
+    edges[2*size + 3] = 2;
+    edges[3*size + 4] = 0;
+    source = 0;
+
+    want[0] = 0;
+    want[1] = 0;
+    want[2] = 0;
+    want[3] = 2;
+    want[4] = 3;
+
+    run_sdijkstra();
+    TEST_ASSERT_EQUAL_INT_ARRAY(want, paths, TEST_MAX_GRAPH_SIZE);
+}
+
+void test_matches_dense_on_random_graph(void)
+{
+    const int random_size = 60;
+    int random_edges[random_size * random_size];
+    int dense_paths[random_size];
+    int sparse_paths[random_size];
+
+    set_seed(7);
+    generate_graph(random_size, 0.05, 8, random_edges);
+    struct csr_graph *graph = csr_from_matrix(random_edges, random_size);
+
+    struct workspace *ws = workspace_create(random_size);
+
+    for (int s = 0; s < random_size; s += 1) {
+        dijkstra(random_edges, random_size, s, dense_paths);
+        sdijkstra_with(ws, graph, s, sparse_paths);
+        TEST_ASSERT_EQUAL_INT_ARRAY(dense_paths, sparse_paths, random_size);
+    }
+    workspace_destroy(ws);
+    csr_free(graph);
+}
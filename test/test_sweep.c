@@ -0,0 +1,309 @@
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "matrix.h"
+#include "sweep.h"
+
+#define TEST_ROW_SIZE (203)
+
+int row[TEST_ROW_SIZE];
+uint16_t row_u16[TEST_ROW_SIZE];
+uint8_t row_u8[TEST_ROW_SIZE];
+unsigned int states[TEST_ROW_SIZE];
+int paths[TEST_ROW_SIZE];
+unsigned int want_states[TEST_ROW_SIZE];
+int want_paths[TEST_ROW_SIZE];
+
+static void randomise(unsigned int);
+static void expect_same_as_scalar(enum sweep_isa);
+static void expect_narrow_same_as_int(enum sweep_isa);
+static void expect_bitmap_same_as_int(enum sweep_isa);
+static void expect_implicit_same_as_int(enum sweep_isa);
+static void expect_partitioned_same_as_int(enum sweep_isa);
+
+void setUp(void)
+{
+    sweep_select(SWEEP_SCALAR);
+}
+
+void tearDown(void)
+{
+    sweep_select(sweep_best_isa());
+}
+
+void test_scalar_always_supported(void)
+{
+    TEST_ASSERT_TRUE(sweep_supports(SWEEP_SCALAR));
+    TEST_ASSERT_TRUE(sweep_select(SWEEP_SCALAR));
+    TEST_ASSERT_EQUAL_INT(SWEEP_SCALAR, sweep_selected_isa());
+}
+
+void test_relaxes_and_selects(void)
+{
+    for (int w = 0; w < 4; w += 1) {
+        states[w] = STATE_UNSEEN;
+        paths[w] = -1;
+    }
+    states[0] = state_at(2) | STATE_VISITED;
+    states[3] = state_at(9);
+    row[0] = 1;
+    row[1] = 5;
+    row[2] = -1;
+    row[3] = 3;
+
+    const uint64_t nearest = sweep_row(row, 0, state_at(2), states, paths, 0, 4);
+
+    TEST_ASSERT_EQUAL_INT(3, candidate_vertex(nearest));
+    TEST_ASSERT_EQUAL_INT(5, state_distance(candidate_state(nearest)));
+    TEST_ASSERT_EQUAL_INT(state_at(7), states[1]);
+    TEST_ASSERT_EQUAL_INT(state_at(2) | STATE_VISITED, states[0]);
+    TEST_ASSERT_EQUAL_INT(STATE_UNSEEN, states[2]);
+    TEST_ASSERT_EQUAL_INT(state_at(5), states[3]);
+    TEST_ASSERT_EQUAL_INT(0, paths[1]);
+    TEST_ASSERT_EQUAL_INT(-1, paths[2]);
+    TEST_ASSERT_EQUAL_INT(0, paths[3]);
+}
+
+void test_nothing_to_select(void)
+{
+    for (int w = 0; w < 4; w += 1) {
+        states[w] = STATE_UNSEEN;
+        row[w] = -1;
+    }
+
+    TEST_ASSERT_TRUE(CANDIDATE_NONE == sweep_row(row, 0, 0, states, paths, 0, 4));
+}
+
+void test_avx2_matches_scalar(void)
+{
+    if (!sweep_supports(SWEEP_AVX2)) return;
+    expect_same_as_scalar(SWEEP_AVX2);
+}
+
+void test_avx512_matches_scalar(void)
+{
+    if (!sweep_supports(SWEEP_AVX512)) return;
+    expect_same_as_scalar(SWEEP_AVX512);
+}
+
+void test_narrow_rows_match_int(void)
+{
+    expect_narrow_same_as_int(SWEEP_SCALAR);
+    if (sweep_supports(SWEEP_AVX2)) expect_narrow_same_as_int(SWEEP_AVX2);
+    if (sweep_supports(SWEEP_AVX512)) expect_narrow_same_as_int(SWEEP_AVX512);
+}
+
+void test_bitmap_rows_match_int(void)
+{
+    expect_bitmap_same_as_int(SWEEP_SCALAR);
+    if (sweep_supports(SWEEP_AVX2)) expect_bitmap_same_as_int(SWEEP_AVX2);
+    if (sweep_supports(SWEEP_AVX512)) expect_bitmap_same_as_int(SWEEP_AVX512);
+}
+
+void test_implicit_rows_match_int(void)
+{
+    expect_implicit_same_as_int(SWEEP_SCALAR);
+    if (sweep_supports(SWEEP_AVX2)) expect_implicit_same_as_int(SWEEP_AVX2);
+    if (sweep_supports(SWEEP_AVX512)) expect_implicit_same_as_int(SWEEP_AVX512);
+}
+
+void test_partitioned_rows_match_int(void)
+{
+    expect_partitioned_same_as_int(SWEEP_SCALAR);
+    if (sweep_supports(SWEEP_AVX2)) expect_partitioned_same_as_int(SWEEP_AVX2);
+    if (sweep_supports(SWEEP_AVX512))
+        expect_partitioned_same_as_int(SWEEP_AVX512);
+}
+
+/*
+ * Fill the row and states with a mix of edges, non-edges,
+ * and unseen, seen and visited vertices with plenty of ties.
+ */
+static void
+randomise(unsigned int seed)
+{
+    srand(seed);
+    for (int w = 0; w < TEST_ROW_SIZE; w += 1) {
+        row[w] = (rand() % 3 == 0) ? -1 : rand() % 8;
+        row_u16[w] = (row[w] == -1) ? MATRIX_U16_NO_EDGE : row[w];
+        row_u8[w] = (row[w] == -1) ? MATRIX_U8_NO_EDGE : row[w];
+        switch (rand() % 3) {
+        case 0: states[w] = STATE_UNSEEN; break;
+        case 1: states[w] = state_at(rand() % 16); break;
+        default: states[w] = state_at(rand() % 16) | STATE_VISITED; break;
+        }
+        paths[w] = rand() % TEST_ROW_SIZE;
+    }
+}
+
+/*
+ * Run the specified kernel and the scalar one over the same
+ * inputs, for ranges which don't line up with vector widths.
+ */
+static void
+expect_same_as_scalar(enum sweep_isa isa)
+{
+    for (unsigned int seed = 0; seed < 50; seed += 1) {
+        const unsigned int min = seed % 19;
+        const unsigned int max = TEST_ROW_SIZE - (seed % 23);
+
+        randomise(seed);
+        sweep_select(SWEEP_SCALAR);
+        const uint64_t want = sweep_row(row, 7, state_at(3), states, paths, min, max);
+        memcpy(want_states, states, sizeof(states));
+        memcpy(want_paths, paths, sizeof(paths));
+
+        randomise(seed);
+        TEST_ASSERT_TRUE(sweep_select(isa));
+        const uint64_t got = sweep_row(row, 7, state_at(3), states, paths, min, max);
+
+        TEST_ASSERT_TRUE_MESSAGE(want == got, "expected the same nearest vertex");
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_states, states, TEST_ROW_SIZE);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_paths, paths, TEST_ROW_SIZE);
+    }
+}
+
+/*
+ * Run the specified kernel over the same weights stored as
+ * `int`, `uint16_t` and `uint8_t`.
+ */
+static void
+expect_narrow_same_as_int(enum sweep_isa isa)
+{
+    TEST_ASSERT_TRUE(sweep_select(isa));
+    for (unsigned int seed = 0; seed < 50; seed += 1) {
+        const unsigned int min = seed % 19;
+        const unsigned int max = TEST_ROW_SIZE - (seed % 23);
+
+        randomise(seed);
+        const uint64_t want = sweep_row(row, 7, state_at(3), states, paths, min, max);
+        memcpy(want_states, states, sizeof(states));
+        memcpy(want_paths, paths, sizeof(paths));
+
+        randomise(seed);
+        uint64_t got = sweep_row_u16(row_u16, 7, state_at(3), states, paths,
+                min, max);
+        TEST_ASSERT_TRUE_MESSAGE(want == got, "expected the same nearest vertex");
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_states, states, TEST_ROW_SIZE);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_paths, paths, TEST_ROW_SIZE);
+
+        randomise(seed);
+        got = sweep_row_u8(row_u8, 7, state_at(3), states, paths, min, max);
+        TEST_ASSERT_TRUE_MESSAGE(want == got, "expected the same nearest vertex");
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_states, states, TEST_ROW_SIZE);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_paths, paths, TEST_ROW_SIZE);
+    }
+}
+
+/*
+ * Run the specified kernel over the row as a one row matrix with
+ * a presence bitmap, against the plain `int` row.
+ */
+static void
+expect_bitmap_same_as_int(enum sweep_isa isa)
+{
+    struct matrix *matrix = matrix_create_bitmap(TEST_ROW_SIZE, MATRIX_U8);
+
+    TEST_ASSERT_TRUE(sweep_select(isa));
+    for (unsigned int seed = 0; seed < 50; seed += 1) {
+        const unsigned int min = seed % 19;
+        const unsigned int max = TEST_ROW_SIZE - (seed % 23);
+
+        randomise(seed);
+        const uint64_t want = sweep_row(row, 0, state_at(3), states, paths, min, max);
+        memcpy(want_states, states, sizeof(states));
+        memcpy(want_paths, paths, sizeof(paths));
+
+        // Vertex 0's row is the only one the sweep reads.
+        randomise(seed);
+        memcpy(matrix->weights, row_u8, sizeof(row_u8));
+        memset(matrix->presence, 0,
+                matrix_presence_words(TEST_ROW_SIZE) * sizeof(uint64_t));
+        for (int w = 0; w < TEST_ROW_SIZE; w += 1)
+            if (row[w] != -1)
+                matrix->presence[w/64] |= (uint64_t) 1 << (w % 64);
+
+        const uint64_t got = sweep_matrix_row(matrix, 0, state_at(3),
+                states, paths, min, max);
+        TEST_ASSERT_TRUE_MESSAGE(want == got, "expected the same nearest vertex");
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_states, states, TEST_ROW_SIZE);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_paths, paths, TEST_ROW_SIZE);
+    }
+
+    matrix_destroy(matrix);
+}
+
+/*
+ * Run the specified kernel over rows of an implicit matrix,
+ * against the same rows computed up front as `int` rows.
+ */
+static void
+expect_implicit_same_as_int(enum sweep_isa isa)
+{
+    struct matrix *matrix = matrix_create(TEST_ROW_SIZE, MATRIX_IMPLICIT);
+    matrix->implicit.threshold = (uint64_t) 1 << 31;
+    matrix->implicit.max_weight = 7;
+
+    TEST_ASSERT_TRUE(sweep_select(isa));
+    for (unsigned int seed = 0; seed < 50; seed += 1) {
+        const unsigned int min = seed % 19;
+        const unsigned int max = TEST_ROW_SIZE - (seed % 23);
+        const unsigned int v = seed % TEST_ROW_SIZE;
+        matrix->implicit.key = seed;
+
+        randomise(seed);
+        for (int w = 0; w < TEST_ROW_SIZE; w += 1)
+            row[w] = matrix_weight(matrix, v, w);
+        const uint64_t want = sweep_row(row, v, state_at(3), states, paths,
+                min, max);
+        memcpy(want_states, states, sizeof(states));
+        memcpy(want_paths, paths, sizeof(paths));
+
+        randomise(seed);
+        const uint64_t got = sweep_matrix_row(matrix, v, state_at(3),
+                states, paths, min, max);
+        TEST_ASSERT_TRUE_MESSAGE(want == got, "expected the same nearest vertex");
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_states, states, TEST_ROW_SIZE);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_paths, paths, TEST_ROW_SIZE);
+    }
+
+    matrix_destroy(matrix);
+}
+
+/*
+ * Run the specified kernel over the row as a one row matrix split
+ * into a varying number of blocks, against the plain `int` row.
+ */
+static void
+expect_partitioned_same_as_int(enum sweep_isa isa)
+{
+    TEST_ASSERT_TRUE(sweep_select(isa));
+    for (unsigned int seed = 0; seed < 50; seed += 1) {
+        const unsigned int min = seed % 19;
+        const unsigned int max = TEST_ROW_SIZE - (seed % 23);
+        const unsigned int nparts = 1 + seed % 7;
+        struct matrix *matrix = matrix_create_partitioned(TEST_ROW_SIZE,
+                MATRIX_U8, nparts);
+
+        randomise(seed);
+        const uint64_t want = sweep_row(row, 0, state_at(3), states, paths,
+                min, max);
+        memcpy(want_states, states, sizeof(states));
+        memcpy(want_paths, paths, sizeof(paths));
+
+        // Vertex 0's row is the first of each block.
+        randomise(seed);
+        for (unsigned int part = 0; part < nparts; part += 1) {
+            unsigned int part_min, part_max;
+            matrix_partition(TEST_ROW_SIZE, nparts, part, &part_min, &part_max);
+            memcpy(matrix->parts[part], row_u8 + part_min, part_max - part_min);
+        }
+
+        const uint64_t got = sweep_matrix_row(matrix, 0, state_at(3),
+                states, paths, min, max);
+        TEST_ASSERT_TRUE_MESSAGE(want == got, "expected the same nearest vertex");
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_states, states, TEST_ROW_SIZE);
+        TEST_ASSERT_EQUAL_INT_ARRAY(want_paths, paths, TEST_ROW_SIZE);
+        matrix_destroy(matrix);
+    }
+}
@@ -0,0 +1,91 @@
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "treecache.h"
+
+#define TEST_GRAPH_SIZE (10)
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_finds_inserted_trees(void)
+{
+    struct treecache *cache = treecache_create(TEST_GRAPH_SIZE, 3);
+    TEST_ASSERT_NULL(treecache_find(cache, 4));
+
+    struct tree *tree = treecache_insert(cache, 4);
+    TEST_ASSERT_EQUAL_INT(4, tree->source);
+    tree->distances[7] = 12;
+    TEST_ASSERT_TRUE(treecache_find(cache, 4) == tree);
+    TEST_ASSERT_EQUAL_INT(12, treecache_find(cache, 4)->distances[7]);
+
+    treecache_destroy(cache);
+}
+
+void test_evicts_least_recently_used(void)
+{
+    struct treecache *cache = treecache_create(TEST_GRAPH_SIZE, 3);
+    treecache_insert(cache, 1);
+    treecache_insert(cache, 2);
+    treecache_insert(cache, 3);
+    // 1 is now more recently used than 2.
+    treecache_find(cache, 1);
+
+    treecache_insert(cache, 4);
+    TEST_ASSERT_NULL(treecache_find(cache, 2));
+    TEST_ASSERT_NOT_NULL(treecache_find(cache, 1));
+    TEST_ASSERT_NOT_NULL(treecache_find(cache, 3));
+    TEST_ASSERT_NOT_NULL(treecache_find(cache, 4));
+
+    // Now 1 is the least recently used.
+    treecache_insert(cache, 5);
+    TEST_ASSERT_NULL(treecache_find(cache, 1));
+    TEST_ASSERT_EQUAL_INT(3, cache->count);
+
+    treecache_destroy(cache);
+}
+
+void test_single_tree_cache(void)
+{
+    struct treecache *cache = treecache_create(TEST_GRAPH_SIZE, 1);
+    for (unsigned int source = 0; source < TEST_GRAPH_SIZE; source += 1) {
+        struct tree *tree = treecache_insert(cache, source);
+        TEST_ASSERT_TRUE(treecache_find(cache, source) == tree);
+        if (source > 0) TEST_ASSERT_NULL(treecache_find(cache, source - 1));
+    }
+    treecache_destroy(cache);
+}
+
+void test_matches_reference_model(void)
+{
+    // A list of the sources, most recently used first.
+    unsigned int model[4];
+    unsigned int count = 0;
+    struct treecache *cache = treecache_create(TEST_GRAPH_SIZE, 4);
+
+    srand(2);
+    for (int step = 0; step < 2000; step += 1) {
+        const unsigned int source = rand() % TEST_GRAPH_SIZE;
+        unsigned int position = 0;
+        while (position < count && model[position] != source)
+            position += 1;
+
+        struct tree *tree = treecache_find(cache, source);
+        TEST_ASSERT_EQUAL_INT(position < count, tree != NULL);
+        if (tree == NULL) {
+            tree = treecache_insert(cache, source);
+            if (count < 4) count += 1;
+            position = count - 1;
+        }
+        TEST_ASSERT_EQUAL_INT(source, tree->source);
+        memmove(model + 1, model, position * sizeof(unsigned int));
+        model[0] = source;
+    }
+
+    treecache_destroy(cache);
+}